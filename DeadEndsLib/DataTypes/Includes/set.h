@@ -3,7 +3,7 @@
 // set.h is the header file for the Set type.
 //
 // Created by Thomas Wetmore on 22 November 2022.
-// Last changed on 15 June 2024.
+// Last changed on 19 October 2026.
 
 #ifndef set_h
 #define set_h
@@ -22,6 +22,7 @@ void deleteSet(Set*);
 int lengthSet(Set*);
 bool isInSet(Set*, String);
 void addToSet(Set*, void*);
+void appendToSet(Set*, void*); // Fast when elements arrive in key order.
 void removeFromSet(Set*, String);
 void iterateSet(Set*, void(*iter)(void*));
 void showSet(Set*, String(*show)(void*));
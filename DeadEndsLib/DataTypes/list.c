@@ -4,7 +4,7 @@
 // needed. Lists can be sorted or unsorted. Sorted lists require a compare function.
 //
 // Created by Thomas Wetmore on 22 November 2022.
-// Last changed on 20 May 2025.
+// Last changed on 19 October 2026.
 
 #include <stdlib.h>
 #include "list.h"
@@ -26,6 +26,7 @@ void initList(List *list, String(*getKey)(void*), int(*compare)(String, String),
 	list->delete = delete;
 	list->getKey = getKey;
 	list->sorted = sorted;
+	list->isSorted = true; // An empty List is sorted.
 }
 
 // deleteList frees a List and its elements.
@@ -6,7 +6,7 @@
 // each Set element.
 //
 // Created by Thomas Wetmore on 22 November 2022.
-// Last changed 20 May 2025.
+// Last changed on 19 October 2026.
 //
 
 #include "set.h"
@@ -35,6 +35,19 @@ void addToSet(Set* set, void* element) {
 	insertInList(list, element, index);
 }
 
+// appendToSet adds an element to a Set. An element whose key follows the key of the last element
+// is appended without a search, so a Set built in key order is built in linear time.
+void appendToSet(Set* set, void* element) {
+	List* list = &(set->list);
+	int length = lengthList(list);
+	if (length && list->compare(list->getKey(getListElement(list, length - 1)),
+								list->getKey(element)) >= 0) {
+		addToSet(set, element);
+		return;
+	}
+	appendToBlock(&(list->block), element); // The List stays sorted.
+}
+
 // isInSet checks whether an element with given key is in a Set.
 bool isInSet(Set* set, String key) {
 	return isInList(&(set->list), key, null);
@@ -4,7 +4,7 @@
 //  database.h is the header file for the Database type.
 //
 //  Created by Thomas Wetmore on 10 November 2022.
-//  Last changed on 3 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef database_h
@@ -16,9 +16,16 @@ typedef struct Database Database; // Only needed because of where DatabaseAction
 typedef struct GNode GNode;
 typedef struct HashTable HashTable;
 typedef struct List List;
+typedef struct GenerationIndex GenerationIndex;
+typedef struct KinshipTable KinshipTable;
+typedef struct NameIndex NameIndex;
+typedef struct NameOrder NameOrder;
+typedef struct NameSearchIndex NameSearchIndex;
+typedef struct PlaceIndex PlaceIndex;
+typedef struct TextIndex TextIndex;
+typedef struct VitalIndex VitalIndex;
 
 typedef HashTable IntegerTable;
-typedef HashTable NameIndex;
 typedef HashTable RecordIndex;
 typedef HashTable RefnIndex;
 typedef List RootList;
@@ -42,6 +49,13 @@ typedef struct Database {
     RootList *sourceRoots; // List of all source roots in the database.
     RootList *eventRoots;  // List of all the event roots in the database.
     RootList *otherRoots;  // List of all the other roots in the database.
+    GenerationIndex *generationIndex; // Layering of the persons into generations.
+    NameSearchIndex *nameSearchIndex; // Prefix, substring and typo tolerant name search; built on first use.
+    KinshipTable *kinshipTable; // Kinship coefficient table; built on first use.
+    VitalIndex *vitalIndex; // Parsed dates of the vital events of the persons and families.
+    PlaceIndex *placeIndex; // Trie of the places of the events in the database.
+    NameOrder *nameOrder; // The persons sorted by name.
+    TextIndex *textIndex; // Inverted index of the words in notes, texts, sources and places; built on first use.
 } Database;
 
 Database *createDatabase(String fileName, RootList*, IntegerTable*, ErrorLog*); // Create a database.
@@ -57,12 +71,14 @@ int numberOthers(Database*);     // Return the number of other records in the da
 bool isEmptyDatabase(Database*);  // Return true if the database has not persons or families.
 GNode *keyToPerson(String key, RecordIndex*); // Get a person from record index.
 GNode *keyToFamily(String key, RecordIndex*); // Get a family GNode from a RecordIndex.
+int resolveReferences(Database*); // Point key valued GNodes at the records they refer to.
 GNode *keyToSource(String key, RecordIndex*); // Get a source record from the database.
 GNode *keyToEvent(String key, RecordIndex*); // Get an event record from the database.
 GNode *keyToOther(String key, RecordIndex*); // Get an other record from the database.
 GNode *getRecord(String key, RecordIndex*);  // Get an arbitraray record from the database.
 bool storeRecord(Database*, GNode*, int lineno, ErrorLog*); // Add a record to the database.
 void summarizeDatabase(Database*);
+void noteDatabaseEdit(Database*); // Drop the tables an edit of persons or families makes stale.
 
 String generateFamilyKey(Database*);
 String generatePersonKey(Database*);
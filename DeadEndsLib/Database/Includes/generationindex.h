@@ -0,0 +1,73 @@
+//
+//  DeadEnds Library
+//
+//  generationindex.h is the header file for the GenerationIndex, a layering of the persons in a
+//  Database into generations, ancestors before descendants.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef generationindex_h
+#define generationindex_h
+
+#include "standard.h"
+
+typedef struct Database Database;
+typedef struct GNode GNode;
+typedef struct HashTable HashTable;
+typedef struct List List;
+typedef HashTable IntegerTable;
+typedef HashTable RecordIndex;
+typedef List ErrorLog;
+typedef List RootList;
+
+// GenerationIndex holds the persons of a Database in topological order. A person with no parents
+// is in generation 0; every other person is in the generation after that of the person's latest
+// parent, so each generation holds only descendants of earlier generations. A parent link that
+// closes an ancestor cycle is skipped, so every person is layered.
+typedef struct GenerationIndex {
+	int numPersons;        // Number of persons layered.
+	GNode** persons;       // Persons in ancestor first order, grouped by generation.
+	int* minGenerations;   // Fewest generations from each person back to a person with no parents.
+	int* maxGenerations;   // Most generations from each person back to a person with no parents.
+	int numGenerations;    // Number of generations.
+	int* generationStarts; // Index in persons where each generation starts, plus one at the end.
+	IntegerTable* indexes; // Maps person keys to indexes in persons.
+} GenerationIndex;
+
+// Interface to GenerationIndexes.
+GenerationIndex* createGenerationIndex(RootList* persons, RecordIndex*, String name,
+									   IntegerTable* keymap, ErrorLog*); // Logs ancestor cycles.
+GenerationIndex* getGenerationIndex(Database*); // Creates the Database's index if it has none.
+void deleteGenerationIndex(GenerationIndex*);
+int personToGeneration(GenerationIndex*, GNode*);    // Returns -1 if the person is not layered.
+int personToMinGeneration(GenerationIndex*, GNode*); // Returns -1 if the person is not layered.
+GNode** generationToPersons(GenerationIndex*, int generation, int* count);
+
+// FORANCESTORFIRST iterates the persons in a GenerationIndex, ancestors before descendants.
+#define FORANCESTORFIRST(index, person)\
+{\
+	GenerationIndex* _index = index;\
+	for (int _i = 0; _i < _index->numPersons; _i++) {\
+		GNode* person = _index->persons[_i];\
+		{
+#define ENDANCESTORFIRST\
+		}\
+	}\
+}
+
+// FORGENERATION iterates the persons in one generation of a GenerationIndex.
+#define FORGENERATION(index, generation, person)\
+{\
+	int _count;\
+	GNode** _persons = generationToPersons(index, generation, &_count);\
+	for (int _i = 0; _i < _count; _i++) {\
+		GNode* person = _persons[_i];\
+		{
+#define ENDGENERATION\
+		}\
+	}\
+}
+
+#endif // generationindex_h
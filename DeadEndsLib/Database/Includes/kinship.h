@@ -0,0 +1,53 @@
+//
+//  DeadEnds Library
+//
+//  kinship.h is the header file for the kinship coefficient engine. The kinship coefficient of two
+//  persons is the probability that alleles taken at random from each are identical by descent. The
+//  inbreeding coefficient of a person is the kinship coefficient of the person's parents.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef kinship_h
+#define kinship_h
+
+#include <pthread.h>
+#include <stdint.h>
+#include "standard.h"
+
+typedef struct Database Database;
+typedef struct GNode GNode;
+typedef struct HashTable HashTable;
+typedef HashTable IntegerTable;
+typedef HashTable RecordIndex;
+
+// KinshipMemo is a hash table of kinship coefficients keyed by pairs of person indexes.
+typedef struct KinshipMemo {
+	uint64_t* keys;  // Pair keys; 0 marks an empty slot.
+	double* values;  // Kinship coefficients.
+	int capacity;    // Number of slots; a power of two.
+	int count;       // Number of slots in use.
+} KinshipMemo;
+
+// KinshipTable holds the persons of a Database in topological order, parents before children,
+// with the indexes of their parents, and the memo used by kinship and inbreeding.
+typedef struct KinshipTable {
+	int numPersons;
+	GNode** persons;       // Persons in topological order.
+	int* fathers;          // Index of each person's father; -1 if none.
+	int* mothers;          // Index of each person's mother; -1 if none.
+	IntegerTable* indexes; // Maps person keys to indexes.
+	KinshipMemo* memo;     // Memo of computed coefficients.
+	pthread_mutex_t memoMutex; // Locks the memo; threads may share the table.
+} KinshipTable;
+
+KinshipTable* createKinshipTable(Database*);
+void deleteKinshipTable(KinshipTable*);
+KinshipTable* getKinshipTable(Database*); // Creates the Database's table on first use.
+double kinshipCoefficient(KinshipTable*, GNode*, GNode*);
+double inbreedingCoefficient(KinshipTable*, GNode*);
+double* inbreedingCoefficients(KinshipTable*, int numThreads); // MNOTE: caller frees the array.
+void writeInbreedingReport(Database*, FILE*, int numThreads);
+
+#endif // kinship_h
@@ -2,10 +2,10 @@
 //  DeadEnds Library
 //
 //  nameindex.h is the header file for the NameIndex data type used by the DeadEnds database
-//  index the Gedcom names in person records. A NameIndex is a specialization of HashTable.
+//  index the Gedcom names in person records.
 //
 //  Created by Thomas Wetmore on 26 November 2022.
-//  Last changed on 3 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef nameindex_h
@@ -13,6 +13,7 @@
 
 #include "standard.h"
 
+typedef struct GNode GNode;
 typedef struct HashTable HashTable;
 typedef struct List List;
 typedef struct Set Set;
@@ -25,13 +26,26 @@ typedef struct NameIndexEl {
     Set* recordKeys;
 } NameIndexEl;
 
-// NameIndex is a synonym for HashTable.
-typedef HashTable NameIndex;
+// PersonNameKeys holds the name keys of a person's names, so the person can be removed from a
+// NameIndex without recomputing them, even after the names have been edited.
+typedef struct PersonNameKeys {
+	String personKey;    // Record key from the database; not freed.
+	int numKeys;
+	char (*nameKeys)[6];
+} PersonNameKeys;
+
+// NameIndex maps name keys to the Sets of the keys of the persons who have the names.
+typedef struct NameIndex {
+	HashTable* names;   // NameIndexEls keyed by name key.
+	HashTable* persons; // PersonNameKeys keyed by person key.
+} NameIndex;
 
 // Interface to NameIndex.
 NameIndex *createNameIndex(void);
 void deleteNameIndex(NameIndex*);
 void insertInNameIndex(NameIndex*, String nameKey, String personKey);
+void removeFromNameIndex(NameIndex*, String nameKey, String personKey);
+void removeNamesOfPersonFromIndex(NameIndex*, GNode*);
 NameIndex* getNameIndex(RootList*);
 void showNameIndex(NameIndex*);
 void showNameIndexStats(NameIndex*);
@@ -0,0 +1,43 @@
+//
+//  DeadEnds Library
+//
+//  nameorder.h is the header file for the NameOrder, the persons of a Database sorted by name.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef nameorder_h
+#define nameorder_h
+
+#include "standard.h"
+
+typedef struct GNode GNode;
+typedef struct HashTable HashTable;
+typedef struct List List;
+typedef HashTable IntegerTable;
+typedef List RootList;
+
+// NameOrder holds the persons of a Database sorted by name, then by key, with the collation key
+// of each person. Collation keys compare with strcmp as compareNames compares names.
+typedef struct NameOrder {
+	int numPersons;
+	GNode** persons;        // Persons in name order.
+	String* collationKeys;  // Collation keys of the persons, in name order.
+	IntegerTable* ranks;    // Maps person keys to their positions in persons.
+} NameOrder;
+
+// Interface to NameOrders.
+NameOrder* createNameOrder(RootList* persons);
+void deleteNameOrder(NameOrder*);
+int personToNameRank(NameOrder*, GNode* person); // Position of a person; -1 if not there.
+GNode* nameRankToPerson(NameOrder*, int rank); // Person at a position; null if out of range.
+String personToCollationKey(NameOrder*, GNode* person); // Null if the person is not there.
+
+// FORNAMEORDER iterates the persons of a NameOrder in name order.
+#define FORNAMEORDER(order, person) {\
+	for (int __i = 0; __i < (order)->numPersons; __i++) {\
+		GNode* person = (order)->persons[__i];
+#define ENDNAMEORDER }}
+
+#endif // nameorder_h
@@ -0,0 +1,59 @@
+//
+//  DeadEnds Library
+//
+//  namesearch.h is the header file for the NameSearchIndex, a secondary name index used for
+//  interactive person search. Where the NameIndex maps Soundex name keys to persons, the
+//  NameSearchIndex finds persons whose surnames or given names start with, contain, or are one
+//  typing error away from, the words of a query.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef namesearch_h
+#define namesearch_h
+
+#include "standard.h"
+
+typedef struct Database Database;
+typedef struct GNode GNode;
+typedef struct List List;
+typedef List RootList;
+
+// NameSearchType selects the kinds of matches searchNames looks for; they can be or-ed.
+typedef enum NameSearchType {
+	nameSearchPrefix = 1,    // A name starts with the query word.
+	nameSearchSubstring = 2, // A name contains the query word.
+	nameSearchFuzzy = 4,     // A name is within one edit of the query word.
+	nameSearchAll = 7
+} NameSearchType;
+
+// NameTerm is a normalized name word with the indexes of the persons who have it as a surname
+// and as a given name.
+typedef struct NameTerm {
+	String text;    // Lower case letters only.
+	int length;
+	int* surnames;  // Indexes of persons with this surname, ascending.
+	int numSurnames;
+	int* givens;    // Indexes of persons with this given name, ascending.
+	int numGivens;
+} NameTerm;
+
+// NameSearchIndex holds the NameTerms in text order, which gives prefix queries as ranges, and
+// trigram postings that map each trigram to the NameTerms that contain it.
+typedef struct NameSearchIndex {
+	int numPersons;
+	GNode** persons;
+	int numTerms;
+	NameTerm** terms;    // Sorted by text.
+	int* trigramStarts;  // Postings of trigram g are trigramTerms[trigramStarts[g]] up to g+1.
+	int* trigramTerms;
+} NameSearchIndex;
+
+// Interface to NameSearchIndexes.
+NameSearchIndex* createNameSearchIndex(RootList* persons);
+void deleteNameSearchIndex(NameSearchIndex*);
+NameSearchIndex* getNameSearchIndex(Database*); // Creates the Database's index on first use.
+List* searchNames(NameSearchIndex*, String query, int types); // MNOTE: caller deletes the List.
+
+#endif // namesearch_h
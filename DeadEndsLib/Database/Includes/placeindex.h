@@ -0,0 +1,50 @@
+//
+//  DeadEnds Library
+//
+//  placeindex.h is the header file for the PlaceIndex, a trie of the comma separated segments of
+//  the PLAC values in a Database, with the events that refer to each place.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef placeindex_h
+#define placeindex_h
+
+#include "standard.h"
+
+typedef struct GNode GNode;
+typedef struct HashTable HashTable;
+typedef struct List List;
+
+// PlaceNode is a node in the PlaceIndex trie. It is one segment of a place; its parent is the
+// segment that follows it, so a town's parent is its county, whose parent is its state, whose
+// parent is its country.
+typedef struct PlaceNode {
+	String name;              // The segment.
+	String place;             // The segment and those after it, joined by ", ".
+	struct PlaceNode* parent;
+	int level;                // 1 for the last segment of a place, 2 for the one before it, ...
+	List* children;           // Child PlaceNodes, in order of creation.
+	int numEvents;            // Number of events whose places end at this node.
+	int maxEvents;
+	GNode** events;           // The events, in the order added.
+	int totalEvents;          // Number of events at this node or below it.
+} PlaceNode;
+
+// PlaceIndex holds the place trie. Each distinct PLAC value is split into segments only once.
+typedef struct PlaceIndex {
+	PlaceNode* root;    // Level 0 node; its children are the last segments of places.
+	HashTable* places;  // PlaceNodes keyed by place.
+	HashTable* values;  // PLAC values seen, mapped to their PlaceNodes.
+} PlaceIndex;
+
+// Interface to PlaceIndexes.
+PlaceIndex* createPlaceIndex(void);
+void deletePlaceIndex(PlaceIndex*);
+void addRecordToPlaceIndex(PlaceIndex*, GNode* root); // Adds the events with places in a record.
+PlaceNode* searchPlaceIndex(PlaceIndex*, String place);
+List* placeNodeToEvents(PlaceNode*); // Events at and below a node. MNOTE: caller deletes the List.
+List* topPlaces(PlaceIndex*, int count, int level); // MNOTE: caller deletes the List.
+
+#endif // placeindex_h
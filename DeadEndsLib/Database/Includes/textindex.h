@@ -0,0 +1,47 @@
+//
+//  DeadEnds Library
+//
+//  textindex.h is the header file for the TextIndex, an inverted index of the words in the
+//  NOTE, TEXT, SOUR and PLAC values of the records in a Database.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef textindex_h
+#define textindex_h
+
+#include "standard.h"
+
+typedef struct Database Database;
+typedef struct GNode GNode;
+typedef struct HashTable HashTable;
+typedef struct List List;
+
+#define MAXPHRASEWORDS 32 // Most words in a phrase of a query.
+
+// TextTerm is a word and the records that hold it. The record indexes are ascending and stored
+// as variable length gaps, seven bits a byte, the high bit set on all bytes but the last.
+typedef struct TextTerm {
+	String word;            // Lower case.
+	int numRecords;
+	int lastRecord;         // Last record added; the next gap is from it.
+	int length;             // Bytes used in postings.
+	int maxLength;
+	unsigned char* postings;
+} TextTerm;
+
+// TextIndex holds the TextTerms of a Database and the records they refer to.
+typedef struct TextIndex {
+	int numRecords;
+	GNode** records;
+	HashTable* terms; // TextTerms keyed by word.
+} TextIndex;
+
+// Interface to TextIndexes.
+TextIndex* createTextIndex(Database*);
+void deleteTextIndex(TextIndex*);
+TextIndex* getTextIndex(Database*); // Creates the Database's index on first use.
+List* searchText(TextIndex*, String query); // MNOTE: caller deletes the List; keys are not copied.
+
+#endif // textindex_h
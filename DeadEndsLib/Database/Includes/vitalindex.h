@@ -0,0 +1,87 @@
+//
+//  DeadEnds Library
+//
+//  vitalindex.h is the header file for the VitalIndex, a columnar index of the parsed dates of
+//  the vital events of the persons and families in a Database.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef vitalindex_h
+#define vitalindex_h
+
+#include "standard.h"
+
+typedef struct GNode GNode;
+typedef struct HashTable HashTable;
+typedef struct List List;
+typedef HashTable IntegerTable;
+typedef List RootList;
+
+// VitalEvent is the type of a vital event. Marriages are family events; the others are person
+// events.
+typedef enum VitalEvent {
+	vitalBirth = 0,
+	vitalChristening,
+	vitalDeath,
+	vitalBurial,
+	vitalMarriage,
+	numVitalEvents
+} VitalEvent;
+
+// VitalDate is a date parsed by extractDate; a zero field is unknown.
+typedef struct VitalDate {
+	int year;
+	int month;
+	int day;
+	int modifier;
+} VitalDate;
+
+// VitalColumn holds the parsed dates of the first event of one type of each record, in packed
+// arrays, and the records with known years sorted by year.
+typedef struct VitalColumn {
+	int numRecords;
+	GNode** records;          // Persons, or families for marriages; shared by the columns.
+	int* years;
+	unsigned char* months;
+	unsigned char* days;
+	unsigned char* modifiers;
+	int numDated;             // Number of records with known years.
+	int* byYear;              // Indexes of the records with known years, by year then index.
+} VitalColumn;
+
+// VitalIndex holds a VitalColumn for each VitalEvent.
+typedef struct VitalIndex {
+	int numPersons;
+	GNode** persons;
+	int numFamilies;
+	GNode** families;
+	IntegerTable* indexes; // Maps person and family keys to indexes in persons or families.
+	VitalColumn columns[numVitalEvents];
+} VitalIndex;
+
+// Interface to VitalIndexes.
+VitalIndex* createVitalIndex(RootList* persons, RootList* families);
+void deleteVitalIndex(VitalIndex*);
+VitalEvent tagToVitalEvent(String tag); // Returns numVitalEvents if the tag is not a vital event.
+bool getVitalDate(VitalIndex*, GNode* record, VitalEvent, VitalDate*); // False if no year.
+int vitalYear(VitalIndex*, GNode* record, VitalEvent); // Returns 0 if the year is unknown.
+int vitalYearRange(VitalIndex*, VitalEvent, int firstYear, int lastYear, int** indexes);
+
+// FORVITALYEARS iterates the records whose events of a type are in a range of years, by year.
+#define FORVITALYEARS(index, event, firstYear, lastYear, record, year)\
+{\
+	int* _indexes;\
+	VitalColumn* _column = &((index)->columns[event]);\
+	int _count = vitalYearRange(index, event, firstYear, lastYear, &_indexes);\
+	for (int _i = 0; _i < _count; _i++) {\
+		GNode* record = _column->records[_indexes[_i]];\
+		int year = _column->years[_indexes[_i]];\
+		{
+#define ENDVITALYEARS\
+		}\
+	}\
+}
+
+#endif // vitalindex_h
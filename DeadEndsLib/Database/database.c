@@ -6,23 +6,30 @@
 //  and used to build an internal database.
 //
 //  Created by Thomas Wetmore on 10 November 2022.
-//  Last changed on 22 August 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "database.h"
 #include "errors.h"
 #include "gedcom.h"
+#include "generationindex.h"
 #include "gnode.h"
 #include "hashtable.h"
 #include "import.h"
+#include "kinship.h"
 #include "name.h"
 #include "nameindex.h"
+#include "nameorder.h"
+#include "namesearch.h"
 #include "path.h"
+#include "placeindex.h"
 #include "recordindex.h"
 #include "refnindex.h"
 #include "rootlist.h"
 #include "stringtable.h"
+#include "textindex.h"
 #include "validate.h"
+#include "vitalindex.h"
 #include "writenode.h"
 
 extern bool importDebugging;
@@ -40,20 +47,32 @@ Database *createDatabase(String path, RootList* records, IntegerTable* keymap, E
     database->sourceRoots = createRootList();
     database->eventRoots = createRootList();
     database->otherRoots = createRootList();
+    database->generationIndex = null;
+    database->nameSearchIndex = null;
+    database->kinshipTable = null;
+    database->vitalIndex = null;
+    database->placeIndex = null;
+    database->nameOrder = null;
+    database->textIndex = null;
 
     FORLIST(records, element)
         GNode* root = (GNode*) element;
         if (root->key) addToRecordIndex(database->recordIndex, root);
         RecordType rtype = recordType(root);
         if (rtype == GRHeader) database->header = root;
-        if (rtype == GRPerson) insertInRootList(database->personRoots, root);
-        if (rtype == GRFamily) insertInRootList(database->familyRoots, root);
-        if (rtype == GRSource) insertInRootList(database->sourceRoots, root);
-        if (rtype == GREvent) insertInRootList(database->eventRoots, root);
-        if (rtype == GROther) insertInRootList(database->otherRoots, root);
+        if (rtype == GRPerson) appendToList(database->personRoots, root);
+        if (rtype == GRFamily) appendToList(database->familyRoots, root);
+        if (rtype == GRSource) appendToList(database->sourceRoots, root);
+        if (rtype == GREvent) appendToList(database->eventRoots, root);
+        if (rtype == GROther) appendToList(database->otherRoots, root);
         if (rtype == GRTrailer) stdfree(root);
     ENDLIST
     deleteRootList(records);
+    sortRootList(database->personRoots); // Sort once instead of inserting in order.
+    sortRootList(database->familyRoots);
+    sortRootList(database->sourceRoots);
+    sortRootList(database->eventRoots);
+    sortRootList(database->otherRoots);
 	database->nameIndex = getNameIndex(database->personRoots);
     database->refnIndex = getReferenceIndex(database->recordIndex, path, keymap, errlog);
 	return database;
@@ -70,6 +89,28 @@ void deleteDatabase(Database* database) {
     if (database->eventRoots) deleteList(database->eventRoots);
     if (database->otherRoots) deleteList(database->otherRoots);
     if (database->header) freeGNodes(database->header);
+    if (database->generationIndex) deleteGenerationIndex(database->generationIndex);
+    if (database->nameSearchIndex) deleteNameSearchIndex(database->nameSearchIndex);
+    if (database->kinshipTable) deleteKinshipTable(database->kinshipTable);
+    if (database->vitalIndex) deleteVitalIndex(database->vitalIndex);
+    if (database->placeIndex) deletePlaceIndex(database->placeIndex);
+    if (database->nameOrder) deleteNameOrder(database->nameOrder);
+    if (database->textIndex) deleteTextIndex(database->textIndex);
+}
+
+// noteDatabaseEdit is called by the functions that change the persons or families of a Database.
+// It marks the Database dirty and deletes the tables built from the old records; they are built
+// again on their next use.
+void noteDatabaseEdit(Database* database) {
+	database->dirty = true;
+	if (database->kinshipTable) deleteKinshipTable(database->kinshipTable);
+	database->kinshipTable = null;
+	if (database->generationIndex) deleteGenerationIndex(database->generationIndex);
+	database->generationIndex = null;
+	if (database->textIndex) deleteTextIndex(database->textIndex);
+	database->textIndex = null;
+	if (database->nameSearchIndex) deleteNameSearchIndex(database->nameSearchIndex);
+	database->nameSearchIndex = null;
 }
 
 // writeDatabase writes the contents of a Database to a Gedcom file.
@@ -164,6 +205,33 @@ GNode* getRecord(String key, RecordIndex* index) {
 	return searchRecordIndex(index, key);
 }
 
+// resolveReferences points each GNode with a key value at the root of the record it refers to,
+// so following links does not search the RecordIndex. FAMC and FAMS nodes are resolved only to
+// families, and HUSB, WIFE and CHIL nodes only to persons. Returns the number resolved.
+int resolveReferences(Database* database) {
+	RootList* lists[] = { database->personRoots, database->familyRoots, database->sourceRoots,
+		database->eventRoots, database->otherRoots };
+	int numResolved = 0;
+	for (int i = 0; i < 5; i++) {
+		FORLIST(lists[i], element)
+			FORTRAVERSE((GNode*) element, node)
+				node->referent = null;
+				if (!isKey(node->value)) continue;
+				switch (node->tagId) {
+				case tagFAMC: case tagFAMS:
+					node->referent = keyToFamily(node->value, database->recordIndex); break;
+				case tagHUSB: case tagWIFE: case tagCHIL:
+					node->referent = keyToPerson(node->value, database->recordIndex); break;
+				default:
+					node->referent = searchRecordIndex(database->recordIndex, node->value);
+				}
+				if (node->referent) numResolved++;
+			ENDTRAVERSE
+		ENDLIST
+	}
+	return numResolved;
+}
+
 // summarizeDatabase writes a short summary of a Database to standard output.
 void summarizeDatabase(Database* database) {
 	if (!database) {
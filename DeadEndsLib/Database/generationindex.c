@@ -0,0 +1,287 @@
+//
+//  DeadEnds Library
+//
+//  generationindex.c has the functions that build and use GenerationIndexes. The persons are
+//  layered by a breadth first topological sort of the parent to child graph. A person is placed
+//  after all the person's parents are placed, so when no more persons can be placed the rest are
+//  in, or descend from, ancestor cycles. The descendants are then peeled away, and a person on a
+//  cycle is placed without its unplaced parents, which breaks the cycle. Each break is added to
+//  the ErrorLog as a warning.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "database.h"
+#include "errors.h"
+#include "gedcom.h"
+#include "generationindex.h"
+#include "gnode.h"
+#include <pthread.h>
+#include "hashtable.h"
+#include "integertable.h"
+#include "list.h"
+#include "recordindex.h"
+
+static bool debugging = false;
+
+// Graph is the parent to child graph of the persons in a Database, in compressed row form. The
+// children of person i are children[starts[i]] up to children[starts[i+1]].
+typedef struct Graph {
+	int numPersons;
+	GNode** persons;
+	int* starts;
+	int* children;
+	IntegerTable* indexes; // Maps person keys to indexes in persons.
+} Graph;
+
+// buildGraph builds the parent to child Graph of a list of persons.
+static Graph buildGraph(RootList* roots, RecordIndex* index) {
+	Graph graph;
+	int numPersons = lengthList(roots);
+	graph.numPersons = numPersons;
+	graph.persons = (GNode**) stdalloc(max(numPersons, 1)*sizeof(GNode*));
+	graph.starts = (int*) stdalloc((numPersons + 1)*sizeof(int));
+	graph.indexes = createIntegerTable(4097);
+	int i = 0, numEdges = 0;
+	FORLIST(roots, element)
+		GNode* person = (GNode*) element;
+		graph.persons[i] = person;
+		insertInIntegerTable(graph.indexes, person->key, i++);
+		FORFAMSS(person, family, fkey, index)
+			if (family) {
+				FORCHILDREN(family, child, ckey, num, index)
+					numEdges++;
+				ENDCHILDREN
+			}
+		ENDFAMSS
+	ENDLIST
+	graph.children = (int*) stdalloc(max(numEdges, 1)*sizeof(int));
+	int edge = 0;
+	for (i = 0; i < numPersons; i++) {
+		graph.starts[i] = edge;
+		FORFAMSS(graph.persons[i], family, fkey, index)
+			if (family) {
+				FORCHILDREN(family, child, ckey, num, index)
+					graph.children[edge++] = searchIntegerTable(graph.indexes, child->key);
+				ENDCHILDREN
+			}
+		ENDFAMSS
+	}
+	graph.starts[numPersons] = edge;
+	return graph;
+}
+
+// breakCycle picks a person on an ancestor cycle, logs a warning about it, and returns its index
+// so the links to its unplaced parents can be skipped. On entry the persons not placed are in
+// cycles or descend from them. Persons with no unplaced children are removed until none are left,
+// leaving the persons on cycles and those between cycles. Each of these has a parent left, so a
+// walk up the parent links comes back to a person it has seen, and that person is on a cycle.
+static int breakCycle(Graph* graph, bool* placed, String name, IntegerTable* keymap,
+					  ErrorLog* errorLog) {
+	int numPersons = graph->numPersons;
+	int numEdges = graph->starts[numPersons];
+	bool* left = (bool*) stdalloc(max(numPersons, 1)*sizeof(bool));
+	int* outDegrees = (int*) stdalloc(max(numPersons, 1)*sizeof(int));
+	int* parentStarts = (int*) stdalloc((numPersons + 1)*sizeof(int));
+	int* parents = (int*) stdalloc(max(numEdges, 1)*sizeof(int));
+	int* queue = (int*) stdalloc(max(numPersons, 1)*sizeof(int));
+	for (int i = 0; i <= numPersons; i++) parentStarts[i] = 0;
+	for (int i = 0; i < numPersons; i++) { // Build the child to parent graph of unplaced persons.
+		left[i] = !placed[i];
+		outDegrees[i] = 0;
+		if (placed[i]) continue;
+		for (int e = graph->starts[i]; e < graph->starts[i+1]; e++) {
+			int child = graph->children[e];
+			if (!placed[child]) {
+				outDegrees[i]++;
+				parentStarts[child + 1]++;
+			}
+		}
+	}
+	for (int i = 0; i < numPersons; i++) parentStarts[i+1] += parentStarts[i];
+	int* next = (int*) stdalloc((numPersons + 1)*sizeof(int));
+	memcpy(next, parentStarts, (numPersons + 1)*sizeof(int));
+	int head = 0, tail = 0;
+	for (int i = 0; i < numPersons; i++) {
+		if (placed[i]) continue;
+		for (int e = graph->starts[i]; e < graph->starts[i+1]; e++) {
+			int child = graph->children[e];
+			if (!placed[child]) parents[next[child]++] = i;
+		}
+		if (!outDegrees[i]) queue[tail++] = i;
+	}
+	while (head < tail) { // Peel away the unplaced persons with no unplaced children.
+		int i = queue[head++];
+		left[i] = false;
+		for (int e = parentStarts[i]; e < parentStarts[i+1]; e++) {
+			if (--outDegrees[parents[e]] == 0) queue[tail++] = parents[e];
+		}
+	}
+	int cycle = 0;
+	while (cycle < numPersons && !left[cycle]) cycle++;
+	ASSERT(cycle < numPersons);
+	while (left[cycle]) { // Walk up until a person is seen twice; left is cleared on the way.
+		ASSERT(parentStarts[cycle] < parentStarts[cycle+1]);
+		left[cycle] = false;
+		cycle = parents[parentStarts[cycle]];
+	}
+	if (errorLog) {
+		GNode* person = graph->persons[cycle];
+		int line = keymap ? searchIntegerTable(keymap, person->key) : NAN;
+		char message[MAXLINELEN];
+		snprintf(message, sizeof(message),
+				 "INDI %s is in an ancestor cycle; its parent links in the cycle are skipped",
+				 person->key);
+		Error* error = createError(gedcomError, name, line == NAN ? 0 : line, message);
+		setSeverityError(error, warningError);
+		addErrorToLog(errorLog, error);
+	}
+	stdfree(left);
+	stdfree(outDegrees);
+	stdfree(parentStarts);
+	stdfree(parents);
+	stdfree(next);
+	stdfree(queue);
+	return cycle;
+}
+
+// createGenerationIndex creates the GenerationIndex of a list of persons. An ancestor cycle is
+// added to the ErrorLog, if there is one, as a warning and broken by skipping the parent links
+// that close it, so every person is layered.
+GenerationIndex* createGenerationIndex(RootList* roots, RecordIndex* index, String name,
+									   IntegerTable* keymap, ErrorLog* errorLog) {
+	Graph graph = buildGraph(roots, index);
+	int numPersons = graph.numPersons;
+	int* inDegrees = (int*) stdalloc(max(numPersons, 1)*sizeof(int));
+	int* minGens = (int*) stdalloc(max(numPersons, 1)*sizeof(int));
+	int* maxGens = (int*) stdalloc(max(numPersons, 1)*sizeof(int));
+	int* order = (int*) stdalloc(max(numPersons, 1)*sizeof(int));
+	bool* placed = (bool*) stdalloc(max(numPersons, 1)*sizeof(bool));
+	for (int i = 0; i < numPersons; i++) {
+		inDegrees[i] = 0;
+		minGens[i] = 0;
+		maxGens[i] = 0;
+		placed[i] = false;
+	}
+	for (int e = 0; e < graph.starts[numPersons]; e++) inDegrees[graph.children[e]]++;
+	// Place persons when their last parent is placed. When none can be placed the rest are in or
+	// below cycles; a person in a cycle is then placed without its unplaced parents.
+	int head = 0, tail = 0, numGenerations = 0;
+	for (int i = 0; i < numPersons; i++) {
+		if (inDegrees[i]) continue;
+		placed[i] = true;
+		order[tail++] = i;
+	}
+	while (true) {
+		while (head < tail) {
+			int i = order[head++];
+			numGenerations = max(numGenerations, maxGens[i] + 1);
+			for (int e = graph.starts[i]; e < graph.starts[i+1]; e++) {
+				int child = graph.children[e];
+				if (placed[child]) continue; // A link skipped to break a cycle.
+				if (maxGens[child] < maxGens[i] + 1) maxGens[child] = maxGens[i] + 1;
+				if (minGens[child] == 0 || minGens[child] > minGens[i] + 1) minGens[child] = minGens[i] + 1;
+				if (--inDegrees[child] == 0) {
+					placed[child] = true;
+					order[tail++] = child;
+				}
+			}
+		}
+		if (tail == numPersons) break;
+		int i = breakCycle(&graph, placed, name, keymap, errorLog);
+		placed[i] = true;
+		order[tail++] = i;
+	}
+	// Put the placed persons in the index grouped by generation.
+	GenerationIndex* gindex = (GenerationIndex*) stdalloc(sizeof(GenerationIndex));
+	gindex->numPersons = tail;
+	gindex->numGenerations = numGenerations;
+	gindex->persons = (GNode**) stdalloc(max(tail, 1)*sizeof(GNode*));
+	gindex->minGenerations = (int*) stdalloc(max(tail, 1)*sizeof(int));
+	gindex->maxGenerations = (int*) stdalloc(max(tail, 1)*sizeof(int));
+	gindex->generationStarts = (int*) stdalloc((numGenerations + 1)*sizeof(int));
+	gindex->indexes = createIntegerTable(4097);
+	int* starts = gindex->generationStarts;
+	for (int g = 0; g <= numGenerations; g++) starts[g] = 0;
+	for (int k = 0; k < tail; k++) starts[maxGens[order[k]] + 1]++;
+	for (int g = 0; g < numGenerations; g++) starts[g+1] += starts[g];
+	int* next = (int*) stdalloc((numGenerations + 1)*sizeof(int));
+	memcpy(next, starts, (numGenerations + 1)*sizeof(int));
+	for (int k = 0; k < tail; k++) { // Stable, so each generation keeps the placement order.
+		int i = order[k];
+		int j = next[maxGens[i]]++;
+		gindex->persons[j] = graph.persons[i];
+		gindex->minGenerations[j] = minGens[i];
+		gindex->maxGenerations[j] = maxGens[i];
+		insertInIntegerTable(gindex->indexes, graph.persons[i]->key, j);
+	}
+	if (debugging) printf("createGenerationIndex: %d persons in %d generations.\n",
+						  tail, numGenerations);
+	stdfree(next);
+	stdfree(inDegrees);
+	stdfree(minGens);
+	stdfree(maxGens);
+	stdfree(order);
+	stdfree(placed);
+	stdfree(graph.persons);
+	stdfree(graph.starts);
+	stdfree(graph.children);
+	deleteHashTable(graph.indexes);
+	return gindex;
+}
+
+// getGenerationIndex returns the GenerationIndex of a Database, creating it if the Database has
+// none, as after an edit.
+static pthread_mutex_t generationIndexMutex = PTHREAD_MUTEX_INITIALIZER;
+GenerationIndex* getGenerationIndex(Database* database) {
+	pthread_mutex_lock(&generationIndexMutex);
+	if (!database->generationIndex)
+		database->generationIndex = createGenerationIndex(database->personRoots,
+									database->recordIndex, database->name, null, null);
+	pthread_mutex_unlock(&generationIndexMutex);
+	return database->generationIndex;
+}
+
+// deleteGenerationIndex frees a GenerationIndex; the persons are not freed.
+void deleteGenerationIndex(GenerationIndex* gindex) {
+	if (!gindex) return;
+	stdfree(gindex->persons);
+	stdfree(gindex->minGenerations);
+	stdfree(gindex->maxGenerations);
+	stdfree(gindex->generationStarts);
+	deleteHashTable(gindex->indexes);
+	stdfree(gindex);
+}
+
+// personIndex returns the index of a person in a GenerationIndex; -1 if not there.
+static int personIndex(GenerationIndex* gindex, GNode* person) {
+	if (!gindex || !person) return -1;
+	int i = searchIntegerTable(gindex->indexes, person->key);
+	return i == NAN ? -1 : i;
+}
+
+// personToGeneration returns the generation of a person, the greatest number of generations from
+// the person back to a person with no parents.
+int personToGeneration(GenerationIndex* gindex, GNode* person) {
+	int i = personIndex(gindex, person);
+	return i < 0 ? -1 : gindex->maxGenerations[i];
+}
+
+// personToMinGeneration returns the fewest number of generations from a person back to a person
+// with no parents.
+int personToMinGeneration(GenerationIndex* gindex, GNode* person) {
+	int i = personIndex(gindex, person);
+	return i < 0 ? -1 : gindex->minGenerations[i];
+}
+
+// generationToPersons returns the array of persons in a generation and sets their count.
+GNode** generationToPersons(GenerationIndex* gindex, int generation, int* count) {
+	if (!gindex || generation < 0 || generation >= gindex->numGenerations) {
+		*count = 0;
+		return null;
+	}
+	int start = gindex->generationStarts[generation];
+	*count = gindex->generationStarts[generation + 1] - start;
+	return gindex->persons + start;
+}
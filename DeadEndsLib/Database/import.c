@@ -4,22 +4,26 @@
 //  import.c has functions that import Gedcom files into internal structures.
 //
 //  Created by Thomas Wetmore on 13 November 2022.
-//  Last changed on 16 August 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "database.h"
 #include "errors.h"
 #include "file.h"
 #include "gedcom.h"
+#include "generationindex.h"
 #include "gnode.h"
 #include "gnodelist.h"
 #include "hashtable.h"
 #include "import.h"
 #include "integertable.h"
+#include "nameorder.h"
+#include "placeindex.h"
 #include "rootlist.h"
 #include "set.h"
 #include "stringset.h"
 #include "validate.h"
+#include "vitalindex.h"
 #include "utils.h"
 
 #define gms getMsecondsStr()
@@ -40,6 +44,19 @@ List* getDatabasesFromFiles(List* filePaths, ErrorLog* errorLog) {
 	return databases;
 }
 
+// buildPlaceIndex builds the PlaceIndex of the events in the persons, families and events of a
+// Database.
+static PlaceIndex* buildPlaceIndex(Database* database) {
+    PlaceIndex* index = createPlaceIndex();
+    RootList* lists[] = { database->personRoots, database->familyRoots, database->eventRoots };
+    for (int i = 0; i < 3; i++) {
+        FORLIST(lists[i], root)
+            addRecordToPlaceIndex(index, (GNode*) root);
+        ENDLIST
+    }
+    return index;
+}
+
 // getDatabaseFromFile returns the Database of a single Gedcom file. Returns null if no Database
 // is created, and errorLog holds the Errors found.
 Database* getDatabaseFromFile(String path, ErrorLog* errlog) {
@@ -71,6 +88,12 @@ Database* getDatabaseFromFile(String path, ErrorLog* errlog) {
         deleteHashTable(keymap);
         return null;
     }
+    resolveReferences(database);
+    database->generationIndex = createGenerationIndex(database->personRoots, database->recordIndex,
+                                                      database->name, keymap, errlog); // Warns of cycles.
+    database->vitalIndex = createVitalIndex(database->personRoots, database->familyRoots);
+    database->placeIndex = buildPlaceIndex(database);
+    database->nameOrder = createNameOrder(database->personRoots);
     if (timing) printf("%s: getDatabaseFromFile: database created.\n", gms);
     deleteHashTable(keymap);
 	return database;
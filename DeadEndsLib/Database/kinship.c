@@ -0,0 +1,277 @@
+//
+//  DeadEnds Library
+//
+//  kinship.c holds the kinship coefficient engine. The persons of a Database are put in an array
+//  in topological order, parents before children, so a person's index is greater than the indexes
+//  of all the person's ancestors. The kinship coefficient of persons i and j, i > j, is then half
+//  the sum of the coefficients of j with the parents of i; the coefficient of a person with itself
+//  is half of one plus the coefficient of the person's parents. Coefficients are memoized on pairs
+//  of indexes, which turns the exponential recursion over the pedigree into a linear one.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include <pthread.h>
+#include "database.h"
+#include "gedcom.h"
+#include "gnode.h"
+#include "hashtable.h"
+#include "integertable.h"
+#include "kinship.h"
+#include "lineage.h"
+#include "list.h"
+#include "name.h"
+
+static bool debugging = false;
+static int initialMemoCapacity = 1024;
+
+// createKinshipMemo creates an empty KinshipMemo.
+static KinshipMemo* createKinshipMemo(void) {
+	KinshipMemo* memo = (KinshipMemo*) stdalloc(sizeof(KinshipMemo));
+	memo->capacity = initialMemoCapacity;
+	memo->count = 0;
+	memo->keys = (uint64_t*) stdalloc(memo->capacity*sizeof(uint64_t));
+	memo->values = (double*) stdalloc(memo->capacity*sizeof(double));
+	memset(memo->keys, 0, memo->capacity*sizeof(uint64_t));
+	return memo;
+}
+
+// deleteKinshipMemo frees a KinshipMemo.
+static void deleteKinshipMemo(KinshipMemo* memo) {
+	if (!memo) return;
+	stdfree(memo->keys);
+	stdfree(memo->values);
+	stdfree(memo);
+}
+
+// pairKey returns the memo key of a pair of indexes; i must not be less than j. One is added so
+// no key is zero.
+static uint64_t pairKey(int i, int j) {
+	return (((uint64_t) i << 32) | (uint32_t) j) + 1;
+}
+
+// slotOf returns the slot of a key in a memo, either the slot holding it or the empty slot where
+// it belongs.
+static int slotOf(KinshipMemo* memo, uint64_t key) {
+	uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+	int mask = memo->capacity - 1;
+	int slot = (int) (hash >> 32) & mask;
+	while (memo->keys[slot] && memo->keys[slot] != key) slot = (slot + 1) & mask;
+	return slot;
+}
+
+// growKinshipMemo doubles the capacity of a memo and rehashes its entries.
+static void growKinshipMemo(KinshipMemo* memo) {
+	uint64_t* keys = memo->keys;
+	double* values = memo->values;
+	int capacity = memo->capacity;
+	memo->capacity *= 2;
+	memo->keys = (uint64_t*) stdalloc(memo->capacity*sizeof(uint64_t));
+	memo->values = (double*) stdalloc(memo->capacity*sizeof(double));
+	memset(memo->keys, 0, memo->capacity*sizeof(uint64_t));
+	for (int i = 0; i < capacity; i++) {
+		if (!keys[i]) continue;
+		int slot = slotOf(memo, keys[i]);
+		memo->keys[slot] = keys[i];
+		memo->values[slot] = values[i];
+	}
+	stdfree(keys);
+	stdfree(values);
+}
+
+// insertInKinshipMemo adds a coefficient to a memo; it keeps the load at most one half.
+static void insertInKinshipMemo(KinshipMemo* memo, uint64_t key, double value) {
+	if (2*(memo->count + 1) > memo->capacity) growKinshipMemo(memo);
+	int slot = slotOf(memo, key);
+	if (!memo->keys[slot]) memo->count++;
+	memo->keys[slot] = key;
+	memo->values[slot] = value;
+}
+
+// kinship returns the kinship coefficient of the persons with indexes i and j, using and
+// updating a memo. An index of -1 is an unknown person, whose coefficient with anyone is zero.
+static double kinship(KinshipTable* table, KinshipMemo* memo, int i, int j) {
+	if (i < 0 || j < 0) return 0.0;
+	if (i < j) {
+		int temp = i; i = j; j = temp;
+	}
+	uint64_t key = pairKey(i, j);
+	int slot = slotOf(memo, key);
+	if (memo->keys[slot]) return memo->values[slot];
+	double value;
+	if (i == j) {
+		value = 0.5*(1.0 + kinship(table, memo, table->fathers[i], table->mothers[i]));
+	} else { // i is not an ancestor of j, so j's kinship comes through i's parents.
+		value = 0.5*(kinship(table, memo, table->fathers[i], j) +
+					 kinship(table, memo, table->mothers[i], j));
+	}
+	insertInKinshipMemo(memo, key, value);
+	return value;
+}
+
+// Builder holds the state used to put persons in topological order.
+typedef struct Builder {
+	KinshipTable* table;
+	RecordIndex* index;
+	IntegerTable* states; // 1 while a person's ancestors are being placed; 2 when placed.
+	int numPlaced;
+	int numCycles;
+} Builder;
+
+// placePerson places the ancestors of a person and then the person in the table, and returns
+// the person's index. A parent that is also a descendant breaks a cycle and is dropped.
+static int placePerson(Builder* builder, GNode* person) {
+	if (!person) return -1;
+	int state = searchIntegerTable(builder->states, person->key);
+	if (state == 2) return searchIntegerTable(builder->table->indexes, person->key);
+	if (state == 1) {
+		builder->numCycles++;
+		return -1;
+	}
+	insertInIntegerTable(builder->states, person->key, 1);
+	int father = placePerson(builder, personToFather(person, builder->index));
+	int mother = placePerson(builder, personToMother(person, builder->index));
+	KinshipTable* table = builder->table;
+	int index = builder->numPlaced++;
+	table->persons[index] = person;
+	table->fathers[index] = father;
+	table->mothers[index] = mother;
+	insertInIntegerTable(table->indexes, person->key, index);
+	insertInIntegerTable(builder->states, person->key, 2);
+	return index;
+}
+
+// createKinshipTable creates a KinshipTable for the persons in a Database.
+KinshipTable* createKinshipTable(Database* database) {
+	KinshipTable* table = (KinshipTable*) stdalloc(sizeof(KinshipTable));
+	int numPersons = numberPersons(database);
+	table->numPersons = numPersons;
+	table->persons = (GNode**) stdalloc(numPersons*sizeof(GNode*));
+	table->fathers = (int*) stdalloc(numPersons*sizeof(int));
+	table->mothers = (int*) stdalloc(numPersons*sizeof(int));
+	table->indexes = createIntegerTable(4097);
+	table->memo = createKinshipMemo();
+	pthread_mutex_init(&table->memoMutex, null);
+	Builder builder = { table, database->recordIndex, createIntegerTable(4097), 0, 0 };
+	FORLIST(database->personRoots, element)
+		placePerson(&builder, (GNode*) element);
+	ENDLIST
+	table->numPersons = builder.numPlaced;
+	if (debugging) printf("createKinshipTable: %d persons; %d cycles broken.\n",
+						  builder.numPlaced, builder.numCycles);
+	deleteHashTable(builder.states);
+	return table;
+}
+
+// deleteKinshipTable frees a KinshipTable; the persons are not freed.
+void deleteKinshipTable(KinshipTable* table) {
+	if (!table) return;
+	stdfree(table->persons);
+	stdfree(table->fathers);
+	stdfree(table->mothers);
+	deleteHashTable(table->indexes);
+	deleteKinshipMemo(table->memo);
+	pthread_mutex_destroy(&table->memoMutex);
+	stdfree(table);
+}
+
+// getKinshipTable returns the KinshipTable of a Database, creating it the first time.
+static pthread_mutex_t kinshipTableMutex = PTHREAD_MUTEX_INITIALIZER;
+KinshipTable* getKinshipTable(Database* database) {
+	pthread_mutex_lock(&kinshipTableMutex);
+	if (!database->kinshipTable) database->kinshipTable = createKinshipTable(database);
+	pthread_mutex_unlock(&kinshipTableMutex);
+	return database->kinshipTable;
+}
+
+// personIndex returns the index of a person in a KinshipTable; -1 if the person is not there.
+static int personIndex(KinshipTable* table, GNode* person) {
+	if (!person) return -1;
+	int index = searchIntegerTable(table->indexes, person->key);
+	return index == NAN ? -1 : index;
+}
+
+// kinshipCoefficient returns the kinship coefficient of two persons. The table's memo is locked
+// while it is used.
+double kinshipCoefficient(KinshipTable* table, GNode* one, GNode* two) {
+	int i = personIndex(table, one), j = personIndex(table, two);
+	pthread_mutex_lock(&table->memoMutex);
+	double value = kinship(table, table->memo, i, j);
+	pthread_mutex_unlock(&table->memoMutex);
+	return value;
+}
+
+// inbreedingCoefficient returns the inbreeding coefficient of a person.
+double inbreedingCoefficient(KinshipTable* table, GNode* person) {
+	int i = personIndex(table, person);
+	if (i < 0) return 0.0;
+	pthread_mutex_lock(&table->memoMutex);
+	double value = kinship(table, table->memo, table->fathers[i], table->mothers[i]);
+	pthread_mutex_unlock(&table->memoMutex);
+	return value;
+}
+
+// Worker holds the work of one thread of inbreedingCoefficients.
+typedef struct Worker {
+	KinshipTable* table;
+	double* results;
+	int first;  // First index handled by the thread.
+	int stride; // Distance between indexes handled by the thread.
+} Worker;
+
+// runWorker computes the inbreeding coefficients of a worker's persons with its own memo. The
+// threads share the read only table and write disjoint parts of the results.
+static void* runWorker(void* arg) {
+	Worker* worker = (Worker*) arg;
+	KinshipTable* table = worker->table;
+	KinshipMemo* memo = createKinshipMemo();
+	for (int i = worker->first; i < table->numPersons; i += worker->stride)
+		worker->results[i] = kinship(table, memo, table->fathers[i], table->mothers[i]);
+	deleteKinshipMemo(memo);
+	return null;
+}
+
+// inbreedingCoefficients returns an array of the inbreeding coefficients of all persons in a
+// KinshipTable, in the table's order, computed by numThreads threads.
+double* inbreedingCoefficients(KinshipTable* table, int numThreads) {
+	double* results = (double*) stdalloc(max(table->numPersons, 1)*sizeof(double));
+	if (numThreads <= 1) {
+		pthread_mutex_lock(&table->memoMutex);
+		for (int i = 0; i < table->numPersons; i++)
+			results[i] = kinship(table, table->memo, table->fathers[i], table->mothers[i]);
+		pthread_mutex_unlock(&table->memoMutex);
+		return results;
+	}
+	pthread_t threads[numThreads];
+	Worker workers[numThreads];
+	for (int t = 0; t < numThreads; t++) {
+		workers[t] = (Worker) { table, results, t, numThreads };
+		pthread_create(&threads[t], null, runWorker, &workers[t]);
+	}
+	for (int t = 0; t < numThreads; t++) pthread_join(threads[t], null);
+	return results;
+}
+
+// writeInbreedingReport writes the persons in a Database with non-zero inbreeding coefficients
+// to a file, followed by a summary.
+void writeInbreedingReport(Database* database, FILE* file, int numThreads) {
+	KinshipTable* table = getKinshipTable(database);
+	double* results = inbreedingCoefficients(table, numThreads);
+	int numInbred = 0;
+	double sum = 0.0, highest = 0.0;
+	for (int i = 0; i < table->numPersons; i++) {
+		if (results[i] <= 0.0) continue;
+		GNode* person = table->persons[i];
+		GNode* name = NAME(person);
+		fprintf(file, "%s\t%.6f\t%s\n", person->key, results[i],
+				name ? manipulateName(name->value, false, true, 68) : "(no name)");
+		numInbred++;
+		sum += results[i];
+		if (results[i] > highest) highest = results[i];
+	}
+	fprintf(file, "%d persons; %d inbred; highest coefficient %.6f; mean coefficient %.6f.\n",
+			table->numPersons, numInbred, highest,
+			table->numPersons ? sum/table->numPersons : 0.0);
+	stdfree(results);
+}
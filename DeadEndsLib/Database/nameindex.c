@@ -5,9 +5,11 @@
 //  record keys that have the names.
 //
 //  Created by Thomas Wetmore on 26 November 2022.
-//  Last changed on 4 June 2025.
+//  Last changed on 19 October 2026.
 //
 
+#include <pthread.h>
+#include <unistd.h>
 #include "gedcom.h"
 #include "gnode.h"
 #include "hashtable.h"
@@ -17,8 +19,12 @@
 #include "sort.h"
 
 static NameIndexEl* createNameIndexEl(String nameKey);
+static PersonNameKeys* createPersonNameKeys(String personKey, int numKeys);
 static bool nameIndexDebugging = false;
 static int numNameIndexBuckets = 2048;
+static int numPersonBuckets = 4097;
+static int maxNameIndexThreads = 8;
+static int minPersonsPerThread = 2048;
 
 // getKey gets the name key of a NameIndex element.
 static String getKey(void* element) {
@@ -41,32 +47,130 @@ static void delete(void* element) {
 	stdfree(el);
 }
 
+// getPersonKey gets the person key of a PersonNameKeys.
+static String getPersonKey(void* element) {
+	return ((PersonNameKeys*) element)->personKey;
+}
+
+// deletePersonNameKeys frees a PersonNameKeys; the person key is not freed.
+static void deletePersonNameKeys(void* element) {
+	PersonNameKeys* pkeys = (PersonNameKeys*) element;
+	stdfree(pkeys->nameKeys);
+	stdfree(pkeys);
+}
+
 // createNameIndex creates a NameIndex.
 NameIndex *createNameIndex(void) {
-	return createHashTable(getKey, compare, delete, numNameIndexBuckets);
+	NameIndex* index = (NameIndex*) stdalloc(sizeof(NameIndex));
+	index->names = createHashTable(getKey, compare, delete, numNameIndexBuckets);
+	index->persons = createHashTable(getPersonKey, compareRecordKeys, deletePersonNameKeys,
+									 numPersonBuckets);
+	return index;
 }
 
 // deleteNameIndex deletes a name index.
 void deleteNameIndex(NameIndex *nameIndex) {
-	deleteHashTable(nameIndex);
+	deleteHashTable(nameIndex->names);
+	deleteHashTable(nameIndex->persons);
+	stdfree(nameIndex);
 }
 
-// getNameIndex returns the NameIndex of all persons in a RootList.
-NameIndex* getNameIndex(RootList* persons) {
-	int numNamesFound = 0; // Debugging.
+// FORNAMES iterates the NAME nodes with values at the start of a person record.
+#define FORNAMES(person, name)\
+	for (GNode* name = NAME(person); name && name->tagId == tagNAME; name = name->sibling)\
+		if (name->value)
+
+// NameKeyWorker holds the work of one thread of getNameIndex.
+typedef struct NameKeyWorker {
+	GNode** persons;
+	int* nameStarts;     // Name keys of person i are nameKeys[nameStarts[i]] up to i+1.
+	char (*nameKeys)[6];
+	int first;           // First person handled by the thread.
+	int last;            // Person after the last handled by the thread.
+} NameKeyWorker;
+
+// runNameKeyWorker computes the name keys of a worker's persons. The threads write disjoint
+// parts of the nameKeys array.
+static void* runNameKeyWorker(void* arg) {
+	NameKeyWorker* worker = (NameKeyWorker*) arg;
+	for (int i = worker->first; i < worker->last; i++) {
+		int k = worker->nameStarts[i];
+		FORNAMES(worker->persons[i], name) nameToNameKeyInto(name->value, worker->nameKeys[k++]);
+	}
+	return null;
+}
+
+// computeNameKeys computes the name keys of an array of persons, splitting the persons among
+// threads when there are enough of them.
+static void computeNameKeys(GNode** persons, int numPersons, int* nameStarts, char (*nameKeys)[6]) {
+	int numThreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	numThreads = min(numThreads, min(maxNameIndexThreads, numPersons/minPersonsPerThread));
+	if (numThreads <= 1) {
+		NameKeyWorker worker = { persons, nameStarts, nameKeys, 0, numPersons };
+		runNameKeyWorker(&worker);
+		return;
+	}
+	pthread_t threads[numThreads];
+	NameKeyWorker workers[numThreads];
+	for (int t = 0; t < numThreads; t++) {
+		workers[t] = (NameKeyWorker) { persons, nameStarts, nameKeys,
+			t*numPersons/numThreads, (t + 1)*numPersons/numThreads };
+		pthread_create(&threads[t], null, runNameKeyWorker, &workers[t]);
+	}
+	for (int t = 0; t < numThreads; t++) pthread_join(threads[t], null);
+}
+
+// getRootKey gets the key of a root GNode.
+static String getRootKey(void* element) {
+	return ((GNode*) element)->key;
+}
+
+// appendToNameIndex adds a (name key, person key) relationship to a NameIndex when the person
+// keys arrive in key order, so the Sets are built by appending.
+static void appendToNameIndex(NameIndex* index, String nameKey, String recordKey) {
+	NameIndexEl* element = (NameIndexEl*) searchHashTable(index->names, nameKey);
+	if (!element) {
+		element = createNameIndexEl(nameKey);
+		addToHashTable(index->names, element, true);
+	}
+	appendToSet(element->recordKeys, recordKey);
+}
+
+// getNameIndex returns the NameIndex of all persons in a RootList. The name keys are computed
+// in parallel into one array; the persons are then visited in key order so each Set is built
+// by appending, and each person's name keys are kept for later removal.
+NameIndex* getNameIndex(RootList* roots) {
+	int numPersons = lengthList(roots);
+	GNode** persons = (GNode**) stdalloc(max(numPersons, 1)*sizeof(GNode*));
+	int* nameStarts = (int*) stdalloc((numPersons + 1)*sizeof(int));
+	bool sorted = true;
+	int numNames = 0;
+	for (int i = 0; i < numPersons; i++) {
+		persons[i] = (GNode*) getListElement(roots, i);
+		if (i && compareRecordKeys(persons[i-1]->key, persons[i]->key) > 0) sorted = false;
+	}
+	if (!sorted) sortElements((void**) persons, numPersons, getRootKey, compareRecordKeys);
+	for (int i = 0; i < numPersons; i++) {
+		nameStarts[i] = numNames;
+		FORNAMES(persons[i], name) numNames++;
+	}
+	nameStarts[numPersons] = numNames;
+	char (*nameKeys)[6] = stdalloc(max(numNames, 1)*sizeof(*nameKeys));
+	computeNameKeys(persons, numPersons, nameStarts, nameKeys);
 	NameIndex* nameIndex = createNameIndex();
-	FORLIST(persons, element) // Loop over persons.
-		GNode* root = (GNode*) element;
-		String recordKey = root->key; // Key of record, used as is in name index.
-		for (GNode* name = NAME(root); name && eqstr(name->tag, "NAME"); name = name->sibling) {
-			if (name->value) {
-				numNamesFound++; // For debugging.
-				String nameKey = nameToNameKey(name->value); // MNOTE: points to static memory.
-				insertInNameIndex(nameIndex, nameKey, recordKey);
-			}
-		}
-	ENDLIST
-	if (nameIndexDebugging) printf("the number of names encountered is %d.\n", numNamesFound);
+	for (int i = 0; i < numPersons; i++) {
+		String recordKey = persons[i]->key; // Key of record, used as is in name index.
+		int first = nameStarts[i], count = nameStarts[i+1] - first;
+		if (!count) continue;
+		PersonNameKeys* pkeys = createPersonNameKeys(recordKey, count);
+		memcpy(pkeys->nameKeys, nameKeys + first, count*sizeof(*nameKeys));
+		addToHashTable(nameIndex->persons, pkeys, true);
+		for (int k = first; k < first + count; k++) appendToNameIndex(nameIndex, nameKeys[k], recordKey);
+	}
+	if (nameIndexDebugging) printf("the number of names encountered is %d.\n", numNames);
+	stdfree(persons);
+	stdfree(nameStarts);
+	stdfree(nameKeys);
 	return nameIndex;
 }
 
@@ -76,10 +180,10 @@ NameIndex* getNameIndex(RootList* persons) {
 void insertInNameIndex(NameIndex* index, String nameKey, String recordKey) {
 	if (nameIndexDebugging)
 		printf("insertInNameIndex: nameKey, personKey: %s, %s\n", nameKey, recordKey);
-	NameIndexEl* element = (NameIndexEl*) searchHashTable(index, nameKey); // Name key seen before?
+	NameIndexEl* element = (NameIndexEl*) searchHashTable(index->names, nameKey); // Name key seen before?
 	if (!element) { // No.
 		element = createNameIndexEl(nameKey); // MNOTE: createNameIndexEl saves nameKey.
-		addToHashTable(index, element, true);
+		addToHashTable(index->names, element, true);
 	}
 	Set* recordKeys = element->recordKeys;
 	if (!isInSet(recordKeys, recordKey)) {
@@ -87,9 +191,9 @@ void insertInNameIndex(NameIndex* index, String nameKey, String recordKey) {
 	}
 }
 
-// removeFromNameIndex
+// removeFromNameIndex removes a (name key, person key) relationship from a NameIndex.
 void removeFromNameIndex(NameIndex* index, String nameKey, String recordKey) {
-	NameIndexEl* el = (NameIndexEl*) searchHashTable(index, nameKey);
+	NameIndexEl* el = (NameIndexEl*) searchHashTable(index->names, nameKey);
 	if (!el) {
 		// Log something happened.
 		return;
@@ -102,23 +206,26 @@ void removeFromNameIndex(NameIndex* index, String nameKey, String recordKey) {
 	removeFromSet(recordKeys, recordKey);
 }
 
-// Remove all names of a person from a NameIndex.
+// removeNamesOfPersonFromIndex removes all names of a person from a NameIndex. The name keys kept
+// when the person was indexed are used, so the names need not be the ones indexed.
 void removeNamesOfPersonFromIndex(NameIndex* index, GNode* person) {
 	String recordKey = person->key;
-	GNode* name = NAME(person);
-	while (name) {
-		String nameKey = nameToNameKey(name->value);
-		removeFromNameIndex(index, nameKey, recordKey);
-		name = name->sibling;
-		if (name && nestr(name->tag, "NAME")) name = null;
+	PersonNameKeys* pkeys = (PersonNameKeys*) searchHashTable(index->persons, recordKey);
+	if (pkeys) {
+		for (int k = 0; k < pkeys->numKeys; k++) removeFromNameIndex(index, pkeys->nameKeys[k], recordKey);
+		removeFromHashTable(index->persons, recordKey);
+		return;
 	}
+	char nameKey[6];
+	FORNAMES(person, name) removeFromNameIndex(index, nameToNameKeyInto(name->value, nameKey), recordKey);
 }
 
 // searchNameIndex searches NameIndex for a name and returns the record keys that have the name.
 // MNOTE: The set that is returned is in the NameIndex. It cannot be changed.
 Set* searchNameIndex(NameIndex* index, String name) {
-	String nameKey = nameToNameKey(name);
-	NameIndexEl* element = searchHashTable(index, nameKey);
+	char nameKey[6];
+	nameToNameKeyInto(name, nameKey);
+	NameIndexEl* element = searchHashTable(index->names, nameKey);
 	return element == null ? null : element->recordKeys;
 }
 
@@ -131,7 +238,7 @@ static void showElement(void* element) {
 	iterateSet(recordKeys, showSetElement);
 }
 void showNameIndex(NameIndex* index) {
-	showHashTable(index, showElement);
+	showHashTable(index->names, showElement);
 }
 
 // getSetKey gets the key of a Set element.
@@ -155,6 +262,15 @@ static NameIndexEl* createNameIndexEl(String nameKey) {
 	return el;
 }
 
+// createPersonNameKeys creates a PersonNameKeys with room for a number of name keys.
+static PersonNameKeys* createPersonNameKeys(String personKey, int numKeys) {
+	PersonNameKeys* pkeys = (PersonNameKeys*) stdalloc(sizeof(PersonNameKeys));
+	pkeys->personKey = personKey;
+	pkeys->numKeys = numKeys;
+	pkeys->nameKeys = stdalloc(numKeys*sizeof(*pkeys->nameKeys));
+	return pkeys;
+}
+
 // showNameIndexStats show the statistic of a NameIndex; for testing and debugging.
 void showNameIndexStats(NameIndex* index) {
 	int numNameKeys, numRecordKeys;
@@ -166,7 +282,7 @@ void showNameIndexStats(NameIndex* index) {
 void getNameIndexStats(NameIndex* index, int* pnumNameKeys, int* pnumRecordKeys) {
 	int numNameKeys = 0;
 	int numRecordKeys = 0;
-	FORHASHTABLE(index, element)
+	FORHASHTABLE(index->names, element)
 		numNameKeys++;
 		NameIndexEl* el = (NameIndexEl*) element;
 		numRecordKeys += lengthSet(el->recordKeys);
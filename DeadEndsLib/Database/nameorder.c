@@ -0,0 +1,99 @@
+//
+//  DeadEnds Library
+//
+//  nameorder.c has the functions that build and use NameOrders. Each person's collation key is
+//  made once, when the Database is built, so walking the persons by name, or sorting them by
+//  name, does not parse their names again for each comparison.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "gedcom.h"
+#include "gnode.h"
+#include "hashtable.h"
+#include "integertable.h"
+#include "list.h"
+#include "name.h"
+#include "nameorder.h"
+#include "sort.h"
+
+static bool debugging = false;
+
+// Collated is a person and its collation key while the NameOrder is sorted.
+typedef struct Collated {
+	String key;
+	GNode* person;
+} Collated;
+
+// getCollationKey gets the collation key of a Collated.
+static String getCollationKey(void* element) {
+	return ((Collated*) element)->key;
+}
+
+// compare compares two collation keys.
+static int compare(String a, String b) {
+	return strcmp(a, b);
+}
+
+// createNameOrder creates the NameOrder of a list of persons.
+NameOrder* createNameOrder(RootList* persons) {
+	NameOrder* order = (NameOrder*) stdalloc(sizeof(NameOrder));
+	int count = lengthList(persons);
+	Collated* collated = (Collated*) stdalloc(max(count, 1)*sizeof(Collated));
+	void** elements = (void**) stdalloc(max(count, 1)*sizeof(void*));
+	int i = 0;
+	FORLIST(persons, element)
+		GNode* person = (GNode*) element;
+		GNode* name = NAME(person);
+		collated[i].key = nameToCollationKey(name ? name->value : null, person->key);
+		collated[i].person = person;
+		elements[i] = &collated[i];
+		i++;
+	ENDLIST
+	sortElements(elements, count, getCollationKey, compare);
+	order->numPersons = count;
+	order->persons = (GNode**) stdalloc(max(count, 1)*sizeof(GNode*));
+	order->collationKeys = (String*) stdalloc(max(count, 1)*sizeof(String));
+	order->ranks = createIntegerTable(4097);
+	for (i = 0; i < count; i++) {
+		Collated* entry = (Collated*) elements[i];
+		order->persons[i] = entry->person;
+		order->collationKeys[i] = entry->key;
+		insertInIntegerTable(order->ranks, entry->person->key, i);
+	}
+	stdfree(elements);
+	stdfree(collated);
+	if (debugging) printf("createNameOrder: %d persons.\n", count);
+	return order;
+}
+
+// deleteNameOrder frees a NameOrder; the persons are not freed.
+void deleteNameOrder(NameOrder* order) {
+	if (!order) return;
+	for (int i = 0; i < order->numPersons; i++) stdfree(order->collationKeys[i]);
+	stdfree(order->collationKeys);
+	stdfree(order->persons);
+	deleteHashTable(order->ranks);
+	stdfree(order);
+}
+
+// personToNameRank returns the position of a person in a NameOrder; -1 if the person is not there.
+int personToNameRank(NameOrder* order, GNode* person) {
+	if (!order || !person || !person->key) return -1;
+	IntegerElement* element = (IntegerElement*) searchHashTable(order->ranks, person->key);
+	if (!element || order->persons[element->value] != person) return -1;
+	return element->value;
+}
+
+// nameRankToPerson returns the person at a position in a NameOrder; null if out of range.
+GNode* nameRankToPerson(NameOrder* order, int rank) {
+	if (!order || rank < 0 || rank >= order->numPersons) return null;
+	return order->persons[rank];
+}
+
+// personToCollationKey returns the collation key of a person; null if the person is not there.
+String personToCollationKey(NameOrder* order, GNode* person) {
+	int rank = personToNameRank(order, person);
+	return rank < 0 ? null : order->collationKeys[rank];
+}
@@ -0,0 +1,407 @@
+//
+//  DeadEnds Library
+//
+//  namesearch.c implements the NameSearchIndex. Surnames and given names are normalized to
+//  lower case letters and collected as NameTerms, each with the persons who have it. The terms
+//  are sorted, so the terms that start with a prefix are a range found by binary search. Each
+//  term is padded with two blanks in front and one behind and split into trigrams; the trigram
+//  postings find the terms that contain a query word, and the terms that share enough trigrams
+//  with a query word to be within one edit of it.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include <pthread.h>
+#include "database.h"
+#include "gedcom.h"
+#include "gnode.h"
+#include "hashtable.h"
+#include "list.h"
+#include "name.h"
+#include "namesearch.h"
+#include "sort.h"
+
+#define NUMTRIGRAMS (27*27*27)
+#define MAXQUERYWORDS 16
+
+static bool debugging = false;
+
+// Match scores; a surname match scores one more than a given name match of the same kind.
+enum { substringScore = 1, fuzzyScore = 2, prefixScore = 3, exactScore = 4 };
+
+// IntArray is a growable array of ints.
+typedef struct IntArray {
+	int* values;
+	int count;
+	int capacity;
+} IntArray;
+
+// appendToIntArray appends an int to an IntArray unless it equals the last int there.
+static void appendToIntArray(IntArray* array, int value) {
+	if (array->count && array->values[array->count - 1] == value) return;
+	if (array->count == array->capacity) {
+		array->capacity = array->capacity ? 2*array->capacity : 4;
+		int* values = (int*) stdalloc(array->capacity*sizeof(int));
+		if (array->count) memcpy(values, array->values, array->count*sizeof(int));
+		if (array->values) stdfree(array->values);
+		array->values = values;
+	}
+	array->values[array->count++] = value;
+}
+
+// TermEl is the element of the HashTable used to collect NameTerms.
+typedef struct TermEl {
+	String text;
+	IntArray surnames;
+	IntArray givens;
+} TermEl;
+
+static String getKey(void* element) { return ((TermEl*) element)->text; }
+static int compare(String a, String b) { return strcmp(a, b); }
+
+// normalizeName copies the letters of a name word to a buffer in lower case; returns the length.
+static int normalizeName(String in, String out, int size) {
+	int length = 0;
+	for (; *in && length < size - 1; in++) {
+		if (*in >= 'a' && *in <= 'z') out[length++] = *in;
+		else if (*in >= 'A' && *in <= 'Z') out[length++] = *in - 'A' + 'a';
+	}
+	out[length] = 0;
+	return length;
+}
+
+// addTerm adds a person to the TermEl of a normalized name word.
+static void addTerm(HashTable* table, String text, int person, bool surname) {
+	TermEl* el = (TermEl*) searchHashTable(table, text);
+	if (!el) {
+		el = (TermEl*) stdalloc(sizeof(TermEl));
+		memset(el, 0, sizeof(TermEl));
+		el->text = strsave(text);
+		addToHashTable(table, el, false);
+	}
+	appendToIntArray(surname ? &el->surnames : &el->givens, person);
+}
+
+// addNameTerms adds the surname and given names of a Gedcom name to the table of TermEls. The
+// surname is the part between slashes; the given names are the words outside them.
+static void addNameTerms(HashTable* table, String name, int person) {
+	char word[MAXLINELEN+1], piece[MAXLINELEN+1], surname[MAXLINELEN+1];
+	if (normalizeName(getSurnameInto(name, surname), word, sizeof(word)))
+		addTerm(table, word, person, true);
+	bool inSurname = false;
+	while (*name) {
+		if (*name == '/') {
+			inSurname = !inSurname;
+			name++;
+		} else if (iswhite(*name) || inSurname) {
+			name++;
+		} else {
+			int length = 0;
+			while (*name && *name != '/' && !iswhite(*name) && length < MAXLINELEN)
+				piece[length++] = *name++;
+			piece[length] = 0;
+			if (normalizeName(piece, word, sizeof(word))) addTerm(table, word, person, false);
+		}
+	}
+}
+
+// trigramsOf puts the codes of the padded trigrams of a normalized word in an array; returns
+// their number, the word's length plus one. Blank is 0 and the letters are 1 to 26.
+static int trigramsOf(String text, int length, int* trigrams) {
+	int a = 0, b = 0;
+	for (int k = 0; k <= length; k++) {
+		int c = k < length ? text[k] - 'a' + 1 : 0;
+		trigrams[k] = (a*27 + b)*27 + c;
+		a = b;
+		b = c;
+	}
+	return length + 1;
+}
+
+// createNameSearchIndex creates the NameSearchIndex of a list of persons.
+NameSearchIndex* createNameSearchIndex(RootList* roots) {
+	NameSearchIndex* index = (NameSearchIndex*) stdalloc(sizeof(NameSearchIndex));
+	index->numPersons = lengthList(roots);
+	index->persons = (GNode**) stdalloc(max(index->numPersons, 1)*sizeof(GNode*));
+	HashTable* table = createHashTable(getKey, compare, null, 4097);
+	int person = 0;
+	FORLIST(roots, element) // Collect the terms.
+		GNode* root = (GNode*) element;
+		index->persons[person] = root;
+		for (GNode* name = NAME(root); name && name->tagId == tagNAME; name = name->sibling) {
+			if (name->value) addNameTerms(table, name->value, person);
+		}
+		person++;
+	ENDLIST
+	int numTerms = 0; // Move the terms to a sorted array.
+	FORHASHTABLE(table, element)
+		numTerms++;
+	ENDHASHTABLE
+	TermEl** els = (TermEl**) stdalloc(max(numTerms, 1)*sizeof(TermEl*));
+	int t = 0;
+	FORHASHTABLE(table, element)
+		els[t++] = (TermEl*) element;
+	ENDHASHTABLE
+	sortElements((void**) els, numTerms, getKey, compare);
+	index->numTerms = numTerms;
+	index->terms = (NameTerm**) stdalloc(max(numTerms, 1)*sizeof(NameTerm*));
+	for (t = 0; t < numTerms; t++) {
+		NameTerm* term = (NameTerm*) stdalloc(sizeof(NameTerm));
+		term->text = els[t]->text;
+		term->length = (int) strlen(term->text);
+		term->surnames = els[t]->surnames.values;
+		term->numSurnames = els[t]->surnames.count;
+		term->givens = els[t]->givens.values;
+		term->numGivens = els[t]->givens.count;
+		index->terms[t] = term;
+		stdfree(els[t]);
+	}
+	stdfree(els);
+	deleteHashTable(table);
+	// Build the trigram postings in two passes, counting and then filling.
+	index->trigramStarts = (int*) stdalloc((NUMTRIGRAMS + 1)*sizeof(int));
+	memset(index->trigramStarts, 0, (NUMTRIGRAMS + 1)*sizeof(int));
+	int* last = (int*) stdalloc(NUMTRIGRAMS*sizeof(int)); // Last term added to each trigram.
+	for (int g = 0; g < NUMTRIGRAMS; g++) last[g] = -1;
+	int trigrams[MAXLINELEN+2];
+	for (t = 0; t < numTerms; t++) {
+		int n = trigramsOf(index->terms[t]->text, index->terms[t]->length, trigrams);
+		for (int k = 0; k < n; k++) {
+			if (last[trigrams[k]] == t) continue;
+			last[trigrams[k]] = t;
+			index->trigramStarts[trigrams[k] + 1]++;
+		}
+	}
+	for (int g = 0; g < NUMTRIGRAMS; g++) index->trigramStarts[g+1] += index->trigramStarts[g];
+	index->trigramTerms = (int*) stdalloc(max(index->trigramStarts[NUMTRIGRAMS], 1)*sizeof(int));
+	int* next = (int*) stdalloc(NUMTRIGRAMS*sizeof(int));
+	memcpy(next, index->trigramStarts, NUMTRIGRAMS*sizeof(int));
+	for (int g = 0; g < NUMTRIGRAMS; g++) last[g] = -1;
+	for (t = 0; t < numTerms; t++) {
+		int n = trigramsOf(index->terms[t]->text, index->terms[t]->length, trigrams);
+		for (int k = 0; k < n; k++) {
+			if (last[trigrams[k]] == t) continue;
+			last[trigrams[k]] = t;
+			index->trigramTerms[next[trigrams[k]]++] = t;
+		}
+	}
+	stdfree(next);
+	stdfree(last);
+	if (debugging) printf("createNameSearchIndex: %d persons, %d terms, %d postings.\n",
+						  index->numPersons, numTerms, index->trigramStarts[NUMTRIGRAMS]);
+	return index;
+}
+
+// deleteNameSearchIndex frees a NameSearchIndex; the persons are not freed.
+void deleteNameSearchIndex(NameSearchIndex* index) {
+	if (!index) return;
+	for (int t = 0; t < index->numTerms; t++) {
+		NameTerm* term = index->terms[t];
+		stdfree(term->text);
+		if (term->surnames) stdfree(term->surnames);
+		if (term->givens) stdfree(term->givens);
+		stdfree(term);
+	}
+	stdfree(index->terms);
+	stdfree(index->persons);
+	stdfree(index->trigramStarts);
+	stdfree(index->trigramTerms);
+	stdfree(index);
+}
+
+// getNameSearchIndex returns the NameSearchIndex of a Database, creating it the first time.
+static pthread_mutex_t nameSearchIndexMutex = PTHREAD_MUTEX_INITIALIZER;
+NameSearchIndex* getNameSearchIndex(Database* database) {
+	pthread_mutex_lock(&nameSearchIndexMutex);
+	if (!database->nameSearchIndex)
+		database->nameSearchIndex = createNameSearchIndex(database->personRoots);
+	pthread_mutex_unlock(&nameSearchIndexMutex);
+	return database->nameSearchIndex;
+}
+
+// withinOneEdit returns true if two words differ by at most one insertion, deletion or
+// substitution.
+static bool withinOneEdit(String a, int la, String b, int lb) {
+	if (abs(la - lb) > 1) return false;
+	int i = 0, j = 0;
+	bool edited = false;
+	while (i < la && j < lb) {
+		if (a[i] == b[j]) {
+			i++; j++;
+		} else {
+			if (edited) return false;
+			edited = true;
+			if (la > lb) i++;
+			else if (lb > la) j++;
+			else { i++; j++; }
+		}
+	}
+	return (la - i) + (lb - j) + (edited ? 1 : 0) <= 1;
+}
+
+// WordMatches holds the scores of the persons matched by one query word.
+typedef struct WordMatches {
+	int* scores;  // Best score of each person; 0 if not matched.
+	int* touched; // Persons with non-zero scores.
+	int numTouched;
+} WordMatches;
+
+// creditTerm gives the persons with a term a score, keeping their best scores.
+static void creditTerm(WordMatches* matches, NameTerm* term, int score) {
+	for (int i = 0; i < term->numSurnames + term->numGivens; i++) {
+		bool surname = i < term->numSurnames;
+		int person = surname ? term->surnames[i] : term->givens[i - term->numSurnames];
+		int value = 2*score + (surname ? 1 : 0);
+		if (!matches->scores[person]) matches->touched[matches->numTouched++] = person;
+		if (value > matches->scores[person]) matches->scores[person] = value;
+	}
+}
+
+// lowerBound returns the index of the first term not less than a word.
+static int lowerBound(NameSearchIndex* index, String word) {
+	int lo = 0, hi = index->numTerms;
+	while (lo < hi) {
+		int mid = (lo + hi)/2;
+		if (strcmp(index->terms[mid]->text, word) < 0) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+// matchWord finds the terms that match a normalized query word and credits their persons. Exact
+// matches are always credited.
+static void matchWord(NameSearchIndex* index, String word, int types, WordMatches* matches) {
+	int length = (int) strlen(word);
+	if (types & nameSearchSubstring) {
+		if (length < 3) { // Too short for a trigram; check every term.
+			for (int t = 0; t < index->numTerms; t++)
+				if (strstr(index->terms[t]->text, word)) creditTerm(matches, index->terms[t], substringScore);
+		} else { // Check the terms with the word's rarest trigram.
+			int best = -1, bestCount = 0;
+			for (int k = 0; k + 2 < length; k++) {
+				int g = ((word[k] - 'a' + 1)*27 + word[k+1] - 'a' + 1)*27 + word[k+2] - 'a' + 1;
+				int count = index->trigramStarts[g+1] - index->trigramStarts[g];
+				if (best < 0 || count < bestCount) {
+					best = g;
+					bestCount = count;
+				}
+			}
+			for (int p = index->trigramStarts[best]; p < index->trigramStarts[best+1]; p++) {
+				NameTerm* term = index->terms[index->trigramTerms[p]];
+				if (strstr(term->text, word)) creditTerm(matches, term, substringScore);
+			}
+		}
+	}
+	if (types & nameSearchFuzzy) {
+		int trigrams[MAXLINELEN+2];
+		int n = trigramsOf(word, length, trigrams);
+		int numDistinct = 0;
+		for (int k = 0; k < n; k++) { // Remove duplicate trigrams.
+			bool seen = false;
+			for (int j = 0; j < numDistinct; j++) if (trigrams[j] == trigrams[k]) seen = true;
+			if (!seen) trigrams[numDistinct++] = trigrams[k];
+		}
+		// One edit changes at most three trigrams, so a term within one edit shares the rest.
+		int threshold = numDistinct - 3;
+		if (threshold <= 0) {
+			for (int t = 0; t < index->numTerms; t++) {
+				NameTerm* term = index->terms[t];
+				if (withinOneEdit(word, length, term->text, term->length))
+					creditTerm(matches, term, fuzzyScore);
+			}
+		} else {
+			int* counts = (int*) stdalloc(max(index->numTerms, 1)*sizeof(int));
+			memset(counts, 0, max(index->numTerms, 1)*sizeof(int));
+			for (int k = 0; k < numDistinct; k++) {
+				int g = trigrams[k];
+				for (int p = index->trigramStarts[g]; p < index->trigramStarts[g+1]; p++) {
+					int t = index->trigramTerms[p];
+					if (++counts[t] != threshold) continue;
+					NameTerm* term = index->terms[t];
+					if (withinOneEdit(word, length, term->text, term->length))
+						creditTerm(matches, term, fuzzyScore);
+				}
+			}
+			stdfree(counts);
+		}
+	}
+	for (int t = lowerBound(index, word); t < index->numTerms; t++) { // Prefix range.
+		NameTerm* term = index->terms[t];
+		if (strncmp(term->text, word, length)) break;
+		if (term->length == length) creditTerm(matches, term, exactScore);
+		else if (types & nameSearchPrefix) creditTerm(matches, term, prefixScore);
+		else break; // Only the exact match was wanted.
+	}
+}
+
+// searchNames returns the keys of the persons whose names match all the words in a query. Each
+// word of the query must match a surname or given name of the person in one of the ways chosen
+// by types. The keys are ranked by the sum of the scores of the person's best match for each word;
+// ties are in RootList order.
+// MNOTE: the List holds keys from the Database; the caller deletes the List but not the keys.
+List* searchNames(NameSearchIndex* index, String query, int types) {
+	List* results = createList(null, null, null, false);
+	char words[MAXQUERYWORDS][MAXLINELEN+1];
+	int numWords = 0;
+	char piece[MAXLINELEN+1];
+	while (*query && numWords < MAXQUERYWORDS) { // Split the query into normalized words.
+		while (*query && (iswhite(*query) || *query == '/' || *query == ',')) query++;
+		int length = 0;
+		while (*query && !iswhite(*query) && *query != '/' && *query != ',' && length < MAXLINELEN)
+			piece[length++] = *query++;
+		piece[length] = 0;
+		if (normalizeName(piece, words[numWords], MAXLINELEN+1)) numWords++;
+	}
+	if (!numWords || !index->numPersons) return results;
+	int numPersons = index->numPersons;
+	int* totals = (int*) stdalloc(numPersons*sizeof(int));
+	memset(totals, 0, numPersons*sizeof(int));
+	WordMatches matches;
+	matches.scores = (int*) stdalloc(numPersons*sizeof(int));
+	matches.touched = (int*) stdalloc(numPersons*sizeof(int));
+	memset(matches.scores, 0, numPersons*sizeof(int));
+	int* candidates = (int*) stdalloc(numPersons*sizeof(int));
+	int numCandidates = 0, maxTotal = 0;
+	for (int w = 0; w < numWords; w++) {
+		matches.numTouched = 0;
+		matchWord(index, words[w], types, &matches);
+		if (w == 0) { // The first word chooses the candidates.
+			for (int i = 0; i < matches.numTouched; i++) candidates[numCandidates++] = matches.touched[i];
+		}
+		int kept = 0;
+		for (int i = 0; i < numCandidates; i++) { // Later words must also match.
+			int person = candidates[i];
+			if (!matches.scores[person]) continue;
+			totals[person] += matches.scores[person];
+			candidates[kept++] = person;
+		}
+		numCandidates = kept;
+		for (int i = 0; i < matches.numTouched; i++) matches.scores[matches.touched[i]] = 0;
+	}
+	for (int i = 0; i < numCandidates; i++) maxTotal = max(maxTotal, totals[candidates[i]]);
+	int* marks = matches.scores; // Reused to put the candidates in index order.
+	for (int i = 0; i < numCandidates; i++) marks[candidates[i]] = 1;
+	int* counts = (int*) stdalloc((maxTotal + 2)*sizeof(int));
+	memset(counts, 0, (maxTotal + 2)*sizeof(int));
+	numCandidates = 0;
+	for (int person = 0; person < numPersons; person++) {
+		if (!marks[person]) continue;
+		candidates[numCandidates++] = person;
+		counts[maxTotal - totals[person] + 1]++;
+	}
+	for (int k = 0; k <= maxTotal; k++) counts[k+1] += counts[k];
+	GNode** ranked = (GNode**) stdalloc(max(numCandidates, 1)*sizeof(GNode*));
+	for (int i = 0; i < numCandidates; i++) { // Stable counting sort on descending score.
+		int person = candidates[i];
+		ranked[counts[maxTotal - totals[person]]++] = index->persons[person];
+	}
+	for (int i = 0; i < numCandidates; i++) appendToList(results, ranked[i]->key);
+	stdfree(ranked);
+	stdfree(counts);
+	stdfree(totals);
+	stdfree(matches.scores);
+	stdfree(matches.touched);
+	stdfree(candidates);
+	return results;
+}
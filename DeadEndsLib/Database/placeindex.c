@@ -0,0 +1,210 @@
+//
+//  DeadEnds Library
+//
+//  placeindex.c has the functions that build and use PlaceIndexes. The PLAC values are split at
+//  their commas, and the segments are interned in a trie from the last segment, usually the
+//  country, to the first, usually the town. Each trie node counts the events in its place and
+//  the places within it, so questions about places are answered without searching the records.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "gedcom.h"
+#include "gnode.h"
+#include "hashtable.h"
+#include "list.h"
+#include "place.h"
+#include "placeindex.h"
+
+static bool debugging = false;
+static int numPlaceBuckets = 4097;
+
+// PlaceValue maps a PLAC value to its PlaceNode.
+typedef struct PlaceValue {
+	String value; // The value from the PLAC GNode; not freed.
+	PlaceNode* node;
+} PlaceValue;
+
+// getPlaceKey gets the place of a PlaceNode.
+static String getPlaceKey(void* element) {
+	return ((PlaceNode*) element)->place;
+}
+
+// getValueKey gets the value of a PlaceValue.
+static String getValueKey(void* element) {
+	return ((PlaceValue*) element)->value;
+}
+
+// compare compares two places or values.
+static int compare(String a, String b) {
+	return strcmp(a, b);
+}
+
+// deletePlaceNode frees a PlaceNode; the events are not freed.
+static void deletePlaceNode(void* element) {
+	PlaceNode* node = (PlaceNode*) element;
+	stdfree(node->name);
+	stdfree(node->place);
+	deleteList(node->children);
+	if (node->events) stdfree(node->events);
+	stdfree(node);
+}
+
+// deletePlaceValue frees a PlaceValue.
+static void deletePlaceValue(void* element) {
+	stdfree(element);
+}
+
+// createPlaceNode creates a PlaceNode and adds it to its parent.
+static PlaceNode* createPlaceNode(String name, String place, PlaceNode* parent) {
+	PlaceNode* node = (PlaceNode*) stdalloc(sizeof(PlaceNode));
+	node->name = strsave(name);
+	node->place = strsave(place);
+	node->parent = parent;
+	node->level = parent ? parent->level + 1 : 0;
+	node->children = createList(null, null, null, false);
+	node->numEvents = 0;
+	node->maxEvents = 0;
+	node->events = null;
+	node->totalEvents = 0;
+	if (parent) appendToList(parent->children, node);
+	return node;
+}
+
+// createPlaceIndex creates an empty PlaceIndex.
+PlaceIndex* createPlaceIndex(void) {
+	PlaceIndex* index = (PlaceIndex*) stdalloc(sizeof(PlaceIndex));
+	index->root = createPlaceNode("", "", null);
+	index->places = createHashTable(getPlaceKey, compare, deletePlaceNode, numPlaceBuckets);
+	index->values = createHashTable(getValueKey, compare, deletePlaceValue, numPlaceBuckets);
+	return index;
+}
+
+// deletePlaceIndex frees a PlaceIndex; the PlaceNodes are freed by the places table.
+void deletePlaceIndex(PlaceIndex* index) {
+	if (!index) return;
+	deleteHashTable(index->places);
+	deleteHashTable(index->values);
+	deletePlaceNode(index->root);
+	stdfree(index);
+}
+
+// deleteSegment frees a segment from placeToList.
+static void deleteSegment(void* segment) {
+	stdfree(segment);
+}
+
+// placeToNode returns the PlaceNode of a place, splitting it into segments and adding the nodes
+// that are new to the trie if create is true. Returns null if the place has no segments, or if
+// create is false and the place is not in the trie.
+static PlaceNode* placeToNode(PlaceIndex* index, String place, bool create) {
+	List* segments = createList(null, null, deleteSegment, false);
+	placeToList(place, segments);
+	PlaceNode* node = index->root;
+	for (int i = lengthList(segments) - 1; i >= 0 && node; i--) {
+		String segment = (String) getListElement(segments, i);
+		String path = node->place; // The segments after this one.
+		String full = (String) stdalloc(strlen(segment) + strlen(path) + 3);
+		if (node == index->root) strcpy(full, segment);
+		else sprintf(full, "%s, %s", segment, path);
+		PlaceNode* child = (PlaceNode*) searchHashTable(index->places, full);
+		if (!child && create) {
+			child = createPlaceNode(segment, full, node);
+			addToHashTable(index->places, child, false);
+		}
+		stdfree(full);
+		node = child;
+	}
+	deleteList(segments);
+	return node == index->root ? null : node;
+}
+
+// addEvent adds an event to a PlaceNode and counts it in the node and the nodes above it.
+static void addEvent(PlaceNode* node, GNode* event) {
+	if (node->numEvents >= node->maxEvents) {
+		node->maxEvents = node->maxEvents ? 2*node->maxEvents : 4;
+		GNode** events = (GNode**) stdalloc(node->maxEvents*sizeof(GNode*));
+		if (node->events) {
+			memcpy(events, node->events, node->numEvents*sizeof(GNode*));
+			stdfree(node->events);
+		}
+		node->events = events;
+	}
+	node->events[node->numEvents++] = event;
+	for (; node; node = node->parent) node->totalEvents++;
+}
+
+// addRecordToPlaceIndex adds the events of a record that have places to a PlaceIndex. The event
+// of a place is the parent of its PLAC GNode.
+void addRecordToPlaceIndex(PlaceIndex* index, GNode* root) {
+	FORTRAVERSE(root, node)
+		if (node->parent && node->value && node->tagId == tagPLAC) {
+			PlaceValue* pvalue = (PlaceValue*) searchHashTable(index->values, node->value);
+			if (!pvalue) { // First time this value is seen.
+				pvalue = (PlaceValue*) stdalloc(sizeof(PlaceValue));
+				pvalue->value = node->value;
+				pvalue->node = placeToNode(index, node->value, true);
+				addToHashTable(index->values, pvalue, false);
+			}
+			if (pvalue->node) addEvent(pvalue->node, node->parent);
+		}
+	ENDTRAVERSE
+	if (debugging) printf("addRecordToPlaceIndex: %s: %d places.\n", root->key,
+						  sizeHashTable(index->places));
+}
+
+// searchPlaceIndex returns the PlaceNode of a place; null if the place is not in the index. The
+// place is split and trimmed as PLAC values are, so "Boston,Massachusetts" finds the PlaceNode
+// of "Boston, Massachusetts".
+PlaceNode* searchPlaceIndex(PlaceIndex* index, String place) {
+	if (!index || !place) return null;
+	return placeToNode(index, place, false);
+}
+
+// addEvents adds the events at and below a PlaceNode to a List.
+static void addEvents(PlaceNode* node, List* events) {
+	for (int i = 0; i < node->numEvents; i++) appendToList(events, node->events[i]);
+	FORLIST(node->children, child)
+		addEvents((PlaceNode*) child, events);
+	ENDLIST
+}
+
+// placeNodeToEvents returns a List of the events at and below a PlaceNode.
+List* placeNodeToEvents(PlaceNode* node) {
+	List* events = createList(null, null, null, false);
+	if (node) addEvents(node, events);
+	return events;
+}
+
+// ranksBefore returns true if a PlaceNode ranks before another in topPlaces.
+static bool ranksBefore(PlaceNode* a, PlaceNode* b, int level) {
+	int na = level ? a->totalEvents : a->numEvents;
+	int nb = level ? b->totalEvents : b->numEvents;
+	if (na != nb) return na > nb;
+	return strcmp(a->place, b->place) < 0;
+}
+
+// topPlaces returns a List of the PlaceNodes with the most events, most first. If level is 0 the
+// nodes are ranked by the events that have exactly their places; otherwise only the nodes at
+// that level are ranked, by the events at and below them.
+List* topPlaces(PlaceIndex* index, int count, int level) {
+	List* list = createList(null, null, null, false);
+	if (!index || count <= 0) return list;
+	PlaceNode** top = (PlaceNode**) stdalloc(count*sizeof(PlaceNode*));
+	int numTop = 0;
+	FORHASHTABLE(index->places, element)
+		PlaceNode* node = (PlaceNode*) element;
+		if ((level && node->level != level) || (!level && !node->numEvents)) continue;
+		if (numTop == count && !ranksBefore(node, top[count - 1], level)) continue;
+		int i = numTop < count ? numTop++ : count - 1; // Insert into the sorted top nodes.
+		while (i > 0 && ranksBefore(node, top[i - 1], level)) {
+			top[i] = top[i - 1];
+			i--;
+		}
+		top[i] = node;
+	ENDHASHTABLE
+	for (int i = 0; i < numTop; i++) appendToList(list, top[i]);
+	stdfree(top);
+	return list;
+}
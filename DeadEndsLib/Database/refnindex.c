@@ -5,7 +5,7 @@
 //  1 REFN nodes whose values give records unique identifiers.
 //
 //  Created by Thomas Wetmore on 16 December 2023.
-//  Last changed on 23 August 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "errors.h"
@@ -84,7 +84,7 @@ RefnIndex* getReferenceIndex(RecordIndex *index, String fname, IntegerTable* key
     RefnIndex* refnIndex = createRefnIndex();
     FORHASHTABLE(index, element)
         GNode* root = (GNode*) element;
-        GNode* refn = findTag(root->child, "REFN");
+        GNode* refn = findTagId(root->child, tagREFN);
         while (refn) {
             String value = refn->value;
             if (value == null || strlen(value) == 0) {
@@ -95,7 +95,7 @@ RefnIndex* getReferenceIndex(RecordIndex *index, String fname, IntegerTable* key
                 addErrorToLog(elog, err);
             }
             refn = refn->sibling;
-            if (refn && nestr(refn->tag, "REFN")) refn = null;
+            if (refn && refn->tagId != tagREFN) refn = null;
         }
     ENDHASHTABLE
     return refnIndex;
@@ -3,9 +3,10 @@
 // removeops.c has functions that perform remove operations on records in Databases.
 //
 // Created by Thomas Wetmore on 2 January 2024.
-// Last changed on 18 May 2025.
+// Last changed on 19 October 2026.
 //
 
+#include "database.h"
 #include "errors.h"
 #include "stdlib.h"
 #include "splitjoin.h"
@@ -13,7 +14,7 @@
 #include "gedcom.h"
 
 // removeChildFromFamily removes an existing child from an existing family.
-bool removeChildFromFamily(GNode* child, GNode* family) {
+bool removeChildFromFamily(GNode* child, GNode* family, Database* database) {
     // Find the CHIL node in the family that links to the person.
     GNode *frefn, *husb, *wife, *chil, *rest;
     splitFamily(family, &frefn, &husb, &wife, &chil, &rest);
@@ -59,11 +60,12 @@ bool removeChildFromFamily(GNode* child, GNode* family) {
     freeGNode(pnode);
     joinFamily(family, frefn, husb, wife, chil, rest);
     joinPerson(child, names, irefns, sex, body, famcs, famss);
+    noteDatabaseEdit(database);
     return true;
 }
 
 // removeSpouseFromFamily removes an existing spouse from an existing family.
-bool removeSpouseFromFamily(GNode* spouse, GNode* family, Error* error) {
+bool removeSpouseFromFamily(GNode* spouse, GNode* family, Database* database, Error* error) {
 	// Split the person and get its sex type.
 	GNode *names, *irefns, *sex, *body, *famcs, *famss;
 	splitPerson(spouse, &names, &irefns, &sex, &body, &famcs, &famss);
@@ -123,5 +125,6 @@ bool removeSpouseFromFamily(GNode* spouse, GNode* family, Error* error) {
 	joinFamily(family, frefn, husb, wife, chil, rest);
 	freeGNode(pnode);
 	freeGNode(fnode);
+	noteDatabaseEdit(database);
 	return true;
 }
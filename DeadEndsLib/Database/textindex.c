@@ -0,0 +1,370 @@
+//
+//  DeadEnds Library
+//
+//  textindex.c has the functions that build and search TextIndexes. The value of each NOTE, TEXT,
+//  SOUR and PLAC GNode is joined with its CONT and CONC lines once, split into words and folded
+//  to lower case. Each word keeps a compressed list of the records it is in. Queries are words,
+//  which must all be present, quoted phrases, whose words must be present in order, and OR, which
+//  separates alternatives.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include <pthread.h>
+#include "database.h"
+#include "gedcom.h"
+#include "gnode.h"
+#include "hashtable.h"
+#include "list.h"
+#include "textindex.h"
+
+static bool debugging = false;
+static int numTextBuckets = 8191;
+
+#define MAXWORDLEN 64
+
+// TextBuffer is a growable buffer that holds a joined value.
+typedef struct TextBuffer {
+	char* chars;
+	int length;
+	int maxLength;
+} TextBuffer;
+
+// Postings is an array of record indexes decoded from a TextTerm.
+typedef struct Postings {
+	int* records;
+	int count;
+} Postings;
+
+// getKey gets the word of a TextTerm.
+static String getKey(void* element) {
+	return ((TextTerm*) element)->word;
+}
+
+// compare compares two words.
+static int compare(String a, String b) {
+	return strcmp(a, b);
+}
+
+// delete frees a TextTerm.
+static void delete(void* element) {
+	TextTerm* term = (TextTerm*) element;
+	stdfree(term->word);
+	stdfree(term->postings);
+	stdfree(term);
+}
+
+// appendToBuffer appends characters to a TextBuffer.
+static void appendToBuffer(TextBuffer* buffer, String chars, int length) {
+	if (buffer->length + length + 1 > buffer->maxLength) {
+		int maxLength = max(2*buffer->maxLength, buffer->length + length + 1);
+		char* newChars = (char*) stdalloc(maxLength);
+		memcpy(newChars, buffer->chars, buffer->length);
+		stdfree(buffer->chars);
+		buffer->chars = newChars;
+		buffer->maxLength = maxLength;
+	}
+	memcpy(buffer->chars + buffer->length, chars, length);
+	buffer->length += length;
+	buffer->chars[buffer->length] = 0;
+}
+
+// joinValue puts the value of a GNode, joined with the values of its CONT and CONC children, in a
+// TextBuffer. CONT lines start on new lines; CONC lines continue the line before.
+static void joinValue(GNode* node, TextBuffer* buffer) {
+	buffer->length = 0;
+	buffer->chars[0] = 0;
+	if (node->value) appendToBuffer(buffer, node->value, (int) strlen(node->value));
+	for (GNode* child = node->child; child; child = child->sibling) {
+		bool cont = child->tagId == tagCONT;
+		if (!cont && child->tagId != tagCONC) continue;
+		if (cont) appendToBuffer(buffer, "\n", 1);
+		if (child->value) appendToBuffer(buffer, child->value, (int) strlen(child->value));
+	}
+}
+
+// isWordChar returns true if a character is part of a word; bytes of UTF-8 sequences are.
+static bool isWordChar(int c) {
+	return isalnum(c) || c >= 0x80;
+}
+
+// nextWord gets the next lower case word from a string and advances the string past it. It
+// returns false when there are no more words. Long words are truncated.
+static bool nextWord(String* pstring, char* word) {
+	unsigned char* p = (unsigned char*) *pstring;
+	while (*p && !isWordChar(*p)) p++;
+	if (!*p) return false;
+	int length = 0;
+	while (*p && isWordChar(*p)) {
+		if (length < MAXWORDLEN) word[length++] = tolower(*p);
+		p++;
+	}
+	word[length] = 0;
+	*pstring = (String) p;
+	return true;
+}
+
+// isTextNode returns true if a GNode holds free text that is indexed.
+static bool isTextNode(GNode* node) {
+	if (!node->value || isKey(node->value)) return false;
+	return node->tagId == tagNOTE || node->tagId == tagTEXT || node->tagId == tagSOUR ||
+		node->tagId == tagPLAC;
+}
+
+// addPosting adds a record to the postings of a TextTerm, if it is not the last record added.
+static void addPosting(TextTerm* term, int record) {
+	if (term->numRecords && term->lastRecord == record) return;
+	unsigned int gap = term->numRecords ? record - term->lastRecord : record;
+	if (term->length + 5 > term->maxLength) {
+		int maxLength = max(2*term->maxLength, 8);
+		unsigned char* postings = (unsigned char*) stdalloc(maxLength);
+		if (term->postings) {
+			memcpy(postings, term->postings, term->length);
+			stdfree(term->postings);
+		}
+		term->postings = postings;
+		term->maxLength = maxLength;
+	}
+	while (gap >= 0x80) {
+		term->postings[term->length++] = (gap & 0x7f) | 0x80;
+		gap >>= 7;
+	}
+	term->postings[term->length++] = gap;
+	term->lastRecord = record;
+	term->numRecords++;
+}
+
+// addWords adds the words of a string to a TextIndex as words of a record.
+static void addWords(TextIndex* index, String string, int record) {
+	char word[MAXWORDLEN+1];
+	while (nextWord(&string, word)) {
+		TextTerm* term = (TextTerm*) searchHashTable(index->terms, word);
+		if (!term) {
+			term = (TextTerm*) stdalloc(sizeof(TextTerm));
+			term->word = strsave(word);
+			term->numRecords = 0;
+			term->lastRecord = 0;
+			term->length = 0;
+			term->maxLength = 0;
+			term->postings = null;
+			addToHashTable(index->terms, term, false);
+		}
+		addPosting(term, record);
+	}
+}
+
+// createTextIndex creates the TextIndex of the persons, families, sources, events and other
+// records of a Database.
+TextIndex* createTextIndex(Database* database) {
+	RootList* lists[] = { database->personRoots, database->familyRoots, database->sourceRoots,
+		database->eventRoots, database->otherRoots };
+	int numLists = sizeof(lists)/sizeof(lists[0]);
+	TextIndex* index = (TextIndex*) stdalloc(sizeof(TextIndex));
+	index->numRecords = 0;
+	for (int i = 0; i < numLists; i++) index->numRecords += lengthList(lists[i]);
+	index->records = (GNode**) stdalloc(max(index->numRecords, 1)*sizeof(GNode*));
+	index->terms = createHashTable(getKey, compare, delete, numTextBuckets);
+	TextBuffer buffer = { stdalloc(256), 0, 256 };
+	int record = 0;
+	for (int i = 0; i < numLists; i++) {
+		FORLIST(lists[i], element)
+			GNode* root = (GNode*) element;
+			index->records[record] = root;
+			FORTRAVERSE(root, node)
+				if (isTextNode(node)) {
+					joinValue(node, &buffer);
+					addWords(index, buffer.chars, record);
+				}
+			ENDTRAVERSE
+			record++;
+		ENDLIST
+	}
+	stdfree(buffer.chars);
+	if (debugging) printf("createTextIndex: %d records, %d words.\n", index->numRecords,
+						  sizeHashTable(index->terms));
+	return index;
+}
+
+// deleteTextIndex frees a TextIndex; the records are not freed.
+void deleteTextIndex(TextIndex* index) {
+	if (!index) return;
+	deleteHashTable(index->terms);
+	stdfree(index->records);
+	stdfree(index);
+}
+
+// getTextIndex returns the TextIndex of a Database, creating it the first time.
+static pthread_mutex_t textIndexMutex = PTHREAD_MUTEX_INITIALIZER;
+TextIndex* getTextIndex(Database* database) {
+	pthread_mutex_lock(&textIndexMutex);
+	if (!database->textIndex) database->textIndex = createTextIndex(database);
+	pthread_mutex_unlock(&textIndexMutex);
+	return database->textIndex;
+}
+
+// decodePostings returns the record indexes of a word; none if the word is not in the index.
+static Postings decodePostings(TextIndex* index, String word) {
+	Postings postings = { null, 0 };
+	TextTerm* term = (TextTerm*) searchHashTable(index->terms, word);
+	if (!term) return postings;
+	postings.records = (int*) stdalloc(term->numRecords*sizeof(int));
+	int record = 0;
+	unsigned char* p = term->postings;
+	for (int i = 0; i < term->numRecords; i++) {
+		unsigned int gap = 0;
+		int shift = 0;
+		while (*p & 0x80) {
+			gap |= (*p++ & 0x7f) << shift;
+			shift += 7;
+		}
+		gap |= *p++ << shift;
+		record += gap;
+		postings.records[postings.count++] = record;
+	}
+	return postings;
+}
+
+// intersectPostings replaces one Postings with its intersection with another.
+static void intersectPostings(Postings* one, Postings two) {
+	int i = 0, j = 0, k = 0;
+	while (i < one->count && j < two.count) {
+		if (one->records[i] < two.records[j]) i++;
+		else if (one->records[i] > two.records[j]) j++;
+		else {
+			one->records[k++] = one->records[i++];
+			j++;
+		}
+	}
+	one->count = k;
+}
+
+// unionPostings replaces one Postings with its union with another.
+static void unionPostings(Postings* one, Postings two) {
+	int* records = (int*) stdalloc(max(one->count + two.count, 1)*sizeof(int));
+	int i = 0, j = 0, k = 0;
+	while (i < one->count || j < two.count) {
+		if (j == two.count || (i < one->count && one->records[i] < two.records[j]))
+			records[k++] = one->records[i++];
+		else if (i == one->count || two.records[j] < one->records[i])
+			records[k++] = two.records[j++];
+		else {
+			records[k++] = one->records[i++];
+			j++;
+		}
+	}
+	if (one->records) stdfree(one->records);
+	one->records = records;
+	one->count = k;
+}
+
+// hasPhrase returns true if the words of a phrase are next to each other, in order, in the same
+// text value of a record.
+static bool hasPhrase(GNode* root, char (*words)[MAXWORDLEN+1], int numWords, TextBuffer* buffer) {
+	bool found = false;
+	char (*window)[MAXWORDLEN+1] = stdalloc(numWords*sizeof(*window));
+	FORTRAVERSE(root, node)
+		if (!found && isTextNode(node)) {
+			joinValue(node, buffer);
+			String string = buffer->chars;
+			int seen = 0;
+			while (!found && nextWord(&string, window[seen % numWords])) {
+				seen++;
+				if (seen < numWords) continue;
+				found = true;
+				for (int i = 0; i < numWords && found; i++)
+					if (nestr(window[(seen + i) % numWords], words[i])) found = false;
+			}
+		}
+	ENDTRAVERSE
+	stdfree(window);
+	return found;
+}
+
+// searchClause finds the records that match a word or phrase of a query. It returns the number
+// of words in the clause, or -1 if there are more than MAXPHRASEWORDS. Words in a clause that is
+// not quoted, as in "o'brien", must also be next to each other.
+static int searchClause(TextIndex* index, String clause, TextBuffer* buffer, Postings* result) {
+	char words[MAXPHRASEWORDS+1][MAXWORDLEN+1];
+	int numWords = 0;
+	while (numWords <= MAXPHRASEWORDS && nextWord(&clause, words[numWords])) numWords++;
+	*result = (Postings) { null, 0 };
+	if (numWords > MAXPHRASEWORDS) return -1;
+	if (numWords == 0) return 0;
+	Postings postings = decodePostings(index, words[0]);
+	for (int i = 1; i < numWords && postings.count; i++) {
+		Postings more = decodePostings(index, words[i]);
+		intersectPostings(&postings, more);
+		if (more.records) stdfree(more.records);
+	}
+	if (numWords > 1) {
+		int k = 0;
+		for (int i = 0; i < postings.count; i++) {
+			if (hasPhrase(index->records[postings.records[i]], words, numWords, buffer))
+				postings.records[k++] = postings.records[i];
+		}
+		postings.count = k;
+	}
+	*result = postings;
+	return numWords;
+}
+
+// searchText returns the keys of the records that match a query, in index order. A query is a
+// list of words and quoted phrases that must all match, and may be followed by OR and more such
+// lists. Clauses without words, such as "--", are skipped. Returns null if a phrase has more than
+// MAXPHRASEWORDS words.
+List* searchText(TextIndex* index, String query) {
+	if (!index || !query) return createList(null, null, null, false);
+	TextBuffer buffer = { stdalloc(256), 0, 256 };
+	Postings results = { null, 0 };
+	Postings group = { null, 0 };
+	bool inGroup = false;
+	char clause[MAXLINELEN+1];
+	String p = query;
+	while (true) {
+		while (iswhite(*p)) p++;
+		bool atEnd = *p == 0;
+		bool isOr = !atEnd && !strncmp(p, "OR", 2) && (p[2] == 0 || iswhite(p[2]));
+		if (atEnd || isOr) { // End of a group of clauses.
+			if (inGroup) unionPostings(&results, group);
+			if (group.records) stdfree(group.records);
+			group = (Postings) { null, 0 };
+			inGroup = false;
+			if (atEnd) break;
+			p += 2;
+			continue;
+		}
+		bool phrase = *p == '"';
+		int length = 0;
+		if (phrase) {
+			p++;
+			while (*p && *p != '"' && length < MAXLINELEN) clause[length++] = *p++;
+			if (*p == '"') p++;
+		} else {
+			while (*p && !iswhite(*p) && length < MAXLINELEN) clause[length++] = *p++;
+		}
+		clause[length] = 0;
+		Postings postings;
+		int numWords = searchClause(index, clause, &buffer, &postings);
+		if (numWords < 0) {
+			if (group.records) stdfree(group.records);
+			if (results.records) stdfree(results.records);
+			stdfree(buffer.chars);
+			return null;
+		}
+		if (numWords == 0) continue;
+		if (!inGroup) {
+			group = postings;
+			inGroup = true;
+		} else {
+			intersectPostings(&group, postings);
+			if (postings.records) stdfree(postings.records);
+		}
+	}
+	List* keys = createList(null, null, null, false);
+	for (int i = 0; i < results.count; i++)
+		appendToList(keys, index->records[results.records[i]]->key);
+	if (results.records) stdfree(results.records);
+	stdfree(buffer.chars);
+	return keys;
+}
@@ -0,0 +1,181 @@
+//
+//  DeadEnds Library
+//
+//  vitalindex.c has the functions that build and use VitalIndexes. The dates of the births,
+//  christenings, deaths, burials and marriages are parsed once, when the Database is built, so
+//  scripts and reports that ask about them do not parse the same dates again and again.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "date.h"
+#include "gedcom.h"
+#include "gnode.h"
+#include "hashtable.h"
+#include "integertable.h"
+#include "list.h"
+#include "vitalindex.h"
+
+static bool debugging = false;
+
+// vitalTags are the Gedcom tags of the VitalEvents, in VitalEvent order.
+static String vitalTags[numVitalEvents] = { "BIRT", "CHR", "DEAT", "BURI", "MARR" };
+
+// tagToVitalEvent returns the VitalEvent of a Gedcom tag.
+VitalEvent tagToVitalEvent(String tag) {
+	if (!tag) return numVitalEvents;
+	for (int e = 0; e < numVitalEvents; e++)
+		if (eqstr(tag, vitalTags[e])) return (VitalEvent) e;
+	return numVitalEvents;
+}
+
+// mergeByYear sorts indexes by year, then by index, using scratch.
+static void mergeByYear(int* indexes, int count, int* years, int* scratch) {
+	if (count < 2) return;
+	int half = count/2;
+	mergeByYear(indexes, half, years, scratch);
+	mergeByYear(indexes + half, count - half, years, scratch);
+	int i = 0, j = half, k = 0;
+	while (i < half && j < count) {
+		int a = indexes[i], b = indexes[j];
+		if (years[a] < years[b] || (years[a] == years[b] && a < b)) scratch[k++] = indexes[i++];
+		else scratch[k++] = indexes[j++];
+	}
+	while (i < half) scratch[k++] = indexes[i++];
+	while (j < count) scratch[k++] = indexes[j++];
+	memcpy(indexes, scratch, count*sizeof(int));
+}
+
+// buildColumn parses the dates of the first events with a tag of an array of records.
+static void buildColumn(VitalColumn* column, GNode** records, int numRecords, String tag) {
+	int n = max(numRecords, 1);
+	column->numRecords = numRecords;
+	column->records = records;
+	column->years = (int*) stdalloc(n*sizeof(int));
+	column->months = (unsigned char*) stdalloc(n);
+	column->days = (unsigned char*) stdalloc(n);
+	column->modifiers = (unsigned char*) stdalloc(n);
+	column->byYear = (int*) stdalloc(n*sizeof(int));
+	int numDated = 0;
+	DateScanner scanner;
+	for (int i = 0; i < numRecords; i++) {
+		int modifier = 0, day = 0, month = 0, year = 0;
+		String date = eventToDate(findTag(records[i]->child, tag), false);
+		if (date) {
+			String yearString;
+			extractDateInto(&scanner, date, &modifier, &day, &month, &year, &yearString);
+		}
+		column->years[i] = year;
+		column->months[i] = month;
+		column->days[i] = day;
+		column->modifiers[i] = modifier;
+		if (year) column->byYear[numDated++] = i;
+	}
+	column->numDated = numDated;
+	int* scratch = (int*) stdalloc(max(numDated, 1)*sizeof(int));
+	mergeByYear(column->byYear, numDated, column->years, scratch);
+	stdfree(scratch);
+}
+
+// listToArray returns the elements of a RootList in an array.
+static GNode** listToArray(RootList* list, int* count, IntegerTable* indexes) {
+	*count = lengthList(list);
+	GNode** array = (GNode**) stdalloc(max(*count, 1)*sizeof(GNode*));
+	int i = 0;
+	FORLIST(list, element)
+		GNode* root = (GNode*) element;
+		array[i] = root;
+		insertInIntegerTable(indexes, root->key, i++);
+	ENDLIST
+	return array;
+}
+
+// createVitalIndex creates the VitalIndex of lists of persons and families.
+VitalIndex* createVitalIndex(RootList* persons, RootList* families) {
+	VitalIndex* index = (VitalIndex*) stdalloc(sizeof(VitalIndex));
+	index->indexes = createIntegerTable(4097);
+	index->persons = listToArray(persons, &index->numPersons, index->indexes);
+	index->families = listToArray(families, &index->numFamilies, index->indexes);
+	for (int e = 0; e < numVitalEvents; e++) {
+		if (e == vitalMarriage)
+			buildColumn(&index->columns[e], index->families, index->numFamilies, vitalTags[e]);
+		else
+			buildColumn(&index->columns[e], index->persons, index->numPersons, vitalTags[e]);
+		if (debugging) printf("createVitalIndex: %d %s dates with years.\n",
+							  index->columns[e].numDated, vitalTags[e]);
+	}
+	return index;
+}
+
+// deleteVitalIndex frees a VitalIndex; the persons and families are not freed.
+void deleteVitalIndex(VitalIndex* index) {
+	if (!index) return;
+	for (int e = 0; e < numVitalEvents; e++) {
+		VitalColumn* column = &index->columns[e];
+		stdfree(column->years);
+		stdfree(column->months);
+		stdfree(column->days);
+		stdfree(column->modifiers);
+		stdfree(column->byYear);
+	}
+	stdfree(index->persons);
+	stdfree(index->families);
+	deleteHashTable(index->indexes);
+	stdfree(index);
+}
+
+// recordIndex returns the index of a record in the column of a VitalEvent; -1 if not there.
+static int recordIndex(VitalIndex* index, GNode* record, VitalEvent event) {
+	if (!index || !record || event < 0 || event >= numVitalEvents) return -1;
+	int i = searchIntegerTable(index->indexes, record->key);
+	if (i == NAN) return -1;
+	VitalColumn* column = &index->columns[event];
+	if (i >= column->numRecords || column->records[i] != record) return -1;
+	return i;
+}
+
+// getVitalDate gets the parsed date of the first event of a type of a person or family. It
+// returns false if the event has no known year.
+bool getVitalDate(VitalIndex* index, GNode* record, VitalEvent event, VitalDate* date) {
+	int i = recordIndex(index, record, event);
+	if (i < 0 || !index->columns[event].years[i]) return false;
+	VitalColumn* column = &index->columns[event];
+	date->year = column->years[i];
+	date->month = column->months[i];
+	date->day = column->days[i];
+	date->modifier = column->modifiers[i];
+	return true;
+}
+
+// vitalYear returns the year of the first event of a type of a person or family.
+int vitalYear(VitalIndex* index, GNode* record, VitalEvent event) {
+	int i = recordIndex(index, record, event);
+	return i < 0 ? 0 : index->columns[event].years[i];
+}
+
+// vitalYearRange finds the records whose events of a type are in a range of years, inclusive.
+// It returns their count and sets indexes to their indexes in the column, which are in order
+// of year. Binary searches find the ends of the range.
+int vitalYearRange(VitalIndex* index, VitalEvent event, int firstYear, int lastYear,
+				   int** indexes) {
+	*indexes = null;
+	if (!index || event < 0 || event >= numVitalEvents || firstYear > lastYear) return 0;
+	VitalColumn* column = &index->columns[event];
+	int* byYear = column->byYear;
+	int lo = 0, hi = column->numDated;
+	while (lo < hi) { // First record with year >= firstYear.
+		int mid = (lo + hi)/2;
+		if (column->years[byYear[mid]] < firstYear) lo = mid + 1;
+		else hi = mid;
+	}
+	int first = lo;
+	hi = column->numDated;
+	while (lo < hi) { // First record with year > lastYear.
+		int mid = (lo + hi)/2;
+		if (column->years[byYear[mid]] <= lastYear) lo = mid + 1;
+		else hi = mid;
+	}
+	*indexes = byYear + first;
+	return lo - first;
+}
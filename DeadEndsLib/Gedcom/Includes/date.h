@@ -3,7 +3,7 @@
 // date.h is the header file for the functions that manipulate Gedcom date Strings.
 //
 // Created by Thomas Wetmore on 22 February 2023.
-// Last changed on 19 August 2024.
+// Last changed on 19 October 2026.
 
 #ifndef date_h
 #define date_h
@@ -20,9 +20,20 @@ typedef enum DateToken {
 	atEndToken = 0
 } DateToken;
 
+// DateScanner holds the state of a date extraction, so dates can be extracted in more than one
+// thread at once.
+typedef struct DateScanner {
+	String cursor;        // Next character to scan; null at the end.
+	char token[256];      // Where tokens are built.
+	char yearString[10];  // Year String returned by extractDateInto.
+} DateScanner;
+
 /* static */ void setExtractString(String);
 /*static*/ DateToken getDateToken(int *pInt, String *pString);
+void initDateScanner(DateScanner*, String);
+DateToken scanDateToken(DateScanner*, int *pInt, String *pString);
 
 void extractDate(String, int*, int*, int*, int*, String*);
+void extractDateInto(DateScanner*, String, int*, int*, int*, int*, String*);
 
 #endif // date_h
@@ -4,7 +4,7 @@
 //  gedcom.h is the header file for Gedcom related data types and operations.
 //
 //  Created by Thomas Wetmore on 7 November 2022.
-//  Last changed on 3 July 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef gedcom_h
@@ -40,16 +40,21 @@ String keyToKey(String);
 
 int compareRecordKeys(String, String);  // gedcom.c
 
+// REFTOPERSON and REFTOFAMILY return the person or family a key valued GNode refers to, using
+// the resolved referent if there is one.
+#define REFTOPERSON(node, index) ((node)->referent ? (node)->referent : keyToPerson((node)->value, index))
+#define REFTOFAMILY(node, index) ((node)->referent ? (node)->referent : keyToFamily((node)->value, index))
+
 // FORCHILDREN / ENDCHILDREN is a macro pair that iterates children in a family.
 #define FORCHILDREN(fam, childd, key, num, index) \
 	{\
-	GNode* __node = findTag(fam->child, "CHIL");\
+	GNode* __node = findTagId(fam->child, tagCHIL);\
 	GNode* childd;\
 	int num = 0;\
 	String key = null;\
 	while (__node) {\
 		key = __node->value;\
-		childd = keyToPerson(__node->value, index);\
+		childd = REFTOPERSON(__node, index);\
 		ASSERT(childd);\
 		num++;\
 		{
@@ -57,7 +62,7 @@ int compareRecordKeys(String, String);  // gedcom.c
 #define ENDCHILDREN \
         }\
         __node = __node->sibling;\
-        if (__node && nestr(__node->tag, "CHIL")) __node = null;\
+        if (__node && __node->tagId != tagCHIL) __node = null;\
     }}
 
 // FORFAMCS / ENDFAMCS iterates the FAMC nodes in a person record.
@@ -68,13 +73,13 @@ int compareRecordKeys(String, String);  // gedcom.c
 	String key;\
 	while (__node) {\
 		key = __node->value;\
-		family = keyToFamily(key, index);\
+		family = REFTOFAMILY(__node, index);\
 		{
 
 #define ENDFAMCS\
         }\
         __node = __node->sibling;\
-        if (__node && nestr(__node->tag, "FAMC")) __node = null;\
+        if (__node && __node->tagId != tagFAMC) __node = null;\
     }\
 }
 
@@ -86,13 +91,13 @@ int compareRecordKeys(String, String);  // gedcom.c
 	String key;\
 	while (__node) {\
 		key = __node->value;\
-		family = keyToFamily(key, index);\
+		family = REFTOFAMILY(__node, index);\
 		{
 
 #define ENDFAMSS\
         }\
         __node = __node->sibling;\
-        if (__node && nestr(__node->tag, "FAMS")) __node = null;\
+        if (__node && __node->tagId != tagFAMS) __node = null;\
     }\
 }
 
@@ -119,36 +124,36 @@ int compareRecordKeys(String, String);  // gedcom.c
 // FORHUSBS / ENDHUSBS iterates over the HUSB nodes in a family.
 #define FORHUSBS(fam, husb, key, index)\
 {\
-	GNode* __node = findTag(fam->child, "HUSB");\
+	GNode* __node = findTagId(fam->child, tagHUSB);\
 	GNode* husb = null;\
 	String key = null;\
 	while (__node) {\
 		key = __node->value;\
-		husb = key ? keyToPerson(key, index) : null;\
+		husb = key ? REFTOPERSON(__node, index) : null;\
 		{
 
 #define ENDHUSBS\
         }\
         __node = __node->sibling;\
-        if (__node && nestr(__node->tag, "HUSB")) __node = null;\
+        if (__node && __node->tagId != tagHUSB) __node = null;\
     }\
 }
 
 // FORWIFES / ENDWIFES iterates over the WIFE nodes in a family.
 #define FORWIFES(fam, wife, key, index)\
 {\
-	GNode* __node = findTag(fam->child, "WIFE");\
+	GNode* __node = findTagId(fam->child, tagWIFE);\
 	GNode* wife = null;\
 	String key = null;\
 	while (__node) {\
 		key = __node->value;\
-		wife = key ? keyToPerson(key, index) : null;\
+		wife = key ? REFTOPERSON(__node, index) : null;\
 		{
 
 #define ENDWIFES\
         }\
         __node = __node->sibling;\
-        if (__node && nestr(__node->tag, "WIFE")) __node = null;\
+        if (__node && __node->tagId != tagWIFE) __node = null;\
     }\
 }
 
@@ -162,7 +167,7 @@ int compareRecordKeys(String, String);  // gedcom.c
     int num = 0;\
     while (__fnode) {\
         spouse = null;\
-        fam = keyToFamily(__fnode->value, index);\
+        fam = REFTOFAMILY(__fnode, index);\
         if (__sex == sexMale)\
             spouse = familyToWife(fam, index);\
         else\
@@ -175,46 +180,42 @@ int compareRecordKeys(String, String);  // gedcom.c
             }\
         }\
         __fnode = __fnode->sibling;\
-        if(__fnode && nestr("FAMS", __fnode->tag)) __fnode = null;\
+        if(__fnode && __fnode->tagId != tagFAMS) __fnode = null;\
     }\
 }
 
-// FORTRAVERSE / ENDTRAVERSE is a macro pair that traverses the GNodes in a tree rooted at root.
+// FORTRAVERSE / ENDTRAVERSE is a macro pair that traverses the GNodes in a tree rooted at root
+// in pre-order. PRUNETRAVERSE in the body skips the children of the current node.
 #define FORTRAVERSE(root, node)\
 {\
-    GNode* node = root;\
-	int protection = 0;\
-    List *stack = createList(null, null, null, false);\
-    prependToList(stack, node);\
-    while (!isEmptyList(stack)) {\
-		protection++;\
-		if (protection > 500000) break;\
-        node = getAndRemoveFirstListElement(stack);\
+    GNodeWalk __walk;\
+    beginGNodeWalk(&__walk, root, false);\
+    for (GNode* node; (node = nextGNodeWalk(&__walk));) {\
         {
 
 #define ENDTRAVERSE\
         }\
-        if (node->sibling) prependToList(stack, node->sibling);\
-        if (node->child) prependToList(stack, node->child);\
     }\
-    deleteList(stack);\
+    endGNodeWalk(&__walk);\
 }
 
+#define PRUNETRAVERSE (__walk.prune = true)
+
 //  Macros that return specific GNodes from a record tree.
-#define NAME(indi)  findTag((indi)->child,"NAME") // First name of person.
-#define SEX(indi)   findTag((indi)->child,"SEX") // First sex of person.
-#define SEXV(indi)  valueToSex(findTag((indi)->child,"SEX")) // First sex value of person.
-#define BIRT(indi)  findTag((indi)->child,"BIRT") // First birth of person.
-#define DEAT(indi)  findTag((indi)->child,"DEAT") // First death of person.
-#define BAPT(indi)  findTag((indi)->child,"CHR") // First christening of person.
-#define BURI(indi)  findTag((indi)->child,"BURI") // First burial of person.
-#define FAMC(indi)  findTag((indi)->child,"FAMC") // First family as child of person.
-#define FAMS(indi)  findTag((indi)->child,"FAMS") // First family as spouse of person.
-#define HUSB(fam)   findTag((fam)->child,"HUSB") // First husband of family.
-#define WIFE(fam)   findTag((fam)->child,"WIFE") // First wife of family.
-#define MARR(fam)   findTag((fam)->child,"MARR") // First marriage of family.
-#define CHIL(fam)   findTag((fam)->child,"CHIL") // First child of family.
-#define DATE(evnt)  findTag((evnt)->child,"DATE") // First date of event.
-#define PLAC(evnt)  findTag((evnt)->child,"PLAC") // First place of event.
+#define NAME(indi)  findTagId((indi)->child,tagNAME) // First name of person.
+#define SEX(indi)   findTagId((indi)->child,tagSEX) // First sex of person.
+#define SEXV(indi)  valueToSex(findTagId((indi)->child,tagSEX)) // First sex value of person.
+#define BIRT(indi)  findTagId((indi)->child,tagBIRT) // First birth of person.
+#define DEAT(indi)  findTagId((indi)->child,tagDEAT) // First death of person.
+#define BAPT(indi)  findTagId((indi)->child,tagCHR) // First christening of person.
+#define BURI(indi)  findTagId((indi)->child,tagBURI) // First burial of person.
+#define FAMC(indi)  findTagId((indi)->child,tagFAMC) // First family as child of person.
+#define FAMS(indi)  findTagId((indi)->child,tagFAMS) // First family as spouse of person.
+#define HUSB(fam)   findTagId((fam)->child,tagHUSB) // First husband of family.
+#define WIFE(fam)   findTagId((fam)->child,tagWIFE) // First wife of family.
+#define MARR(fam)   findTagId((fam)->child,tagMARR) // First marriage of family.
+#define CHIL(fam)   findTagId((fam)->child,tagCHIL) // First child of family.
+#define DATE(evnt)  findTagId((evnt)->child,tagDATE) // First date of event.
+#define PLAC(evnt)  findTagId((evnt)->child,tagPLAC) // First place of event.
 
 #endif // gedcom_h
@@ -4,7 +4,7 @@
 //  gnode.h defines the GNode data type. GNodes represent lines in a Gedcom file.
 //
 //  Created by Thomas Wetmore on 4 November 2022.
-//  Last changed on 4 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef gnode_h
@@ -17,17 +17,47 @@ typedef struct HashTable HashTable;
 typedef enum SexType SexType;
 typedef HashTable RecordIndex;
 
+// TagId identifies the Gedcom tags the code looks for. A tag gets its TagId when it is put in
+// the tag table, so code can compare or switch on TagIds instead of Strings. Other tags have
+// TagId tagOther and are found by their Strings.
+typedef enum TagId {
+	tagOther = 0,
+	tagHEAD, tagTRLR, tagINDI, tagFAM, tagSOUR, tagEVEN, tagNOTE, tagOBJE, tagREPO, tagSUBM,
+	tagNAME, tagSEX, tagBIRT, tagCHR, tagDEAT, tagBURI, tagMARR, tagDIV,
+	tagFAMC, tagFAMS, tagHUSB, tagWIFE, tagCHIL,
+	tagDATE, tagPLAC, tagREFN, tagTITL, tagTEXT, tagCONT, tagCONC,
+	numTagIds
+} TagId;
+
 // GNode is the structure that holds a Gedcom line in its 'internal' form.
 typedef struct GNode GNode;
 struct GNode {
 	String key;     // Record key; only root nodes use this field.
 	String tag;     // Line tag; all nodes use this field.
+	TagId tagId;    // TagId of the tag; tagOther if the tag has none.
 	String value;   // Line value; values are optional.
 	GNode *parent;  // Parent node; all nodes except roots use this field.
 	GNode *child;   // First child none of this node, if any.
 	GNode *sibling; // Next sibling node of this node, if any.
+	GNode *referent; // Root of the record a key value refers to, once references are resolved.
 };
 
+// GNodeWalk is the state of a pre-order walk of a GNode tree. It holds the ancestors of the
+// current node, in a small array in the walk itself, moving to the heap for deep trees, so most
+// walks do not allocate.
+#define NUMWALKANCESTORS 32
+typedef struct GNodeWalk {
+	GNode* root;         // Root of the walk.
+	GNode* node;         // Node last returned; null before the first and after the last.
+	int level;           // Level of node below root.
+	bool forest;         // Walk the siblings of root and their trees too.
+	bool prune;          // Do not walk the children of node.
+	bool started;
+	int maxLevel;        // Size of ancestors.
+	GNode** ancestors;   // ancestors[i] is the ancestor of node at level i.
+	GNode* stack[NUMWALKANCESTORS];
+} GNodeWalk;
+
 // Application programming interface to this type.
 GNode* createGNode(String key, String tag, String value, GNode* parent);
 void freeGNode(GNode*);
@@ -39,20 +69,29 @@ String gnodesToString(GNode*);
 int treeStringLength(int, GNode*);
 GNode* personToFamilyAsChild(GNode *person, RecordIndex*);
 
+// The *Into functions fill caller buffers rather than static ones, so they can run in threads.
+#define SHORTDATELEN 7 // Size of a buffer for a shortened date.
 String personToEvent(GNode*, String, String, int, bool);
+String personToEventInto(GNode*, String tag, String head, int len, bool, String buffer, int size);
 String eventToString(GNode*, bool);
+String eventToStringInto(GNode*, bool, String buffer, int size);
 String eventToDate(GNode*, bool);
+String eventToDateInto(GNode*, bool, String buffer); // buffer has SHORTDATELEN characters.
 String eventToPlace(GNode*, bool);
 void showGNodeTree(GNode*);
 void showGNodes(int, GNode*);
 void showGNode(int level, GNode*);
 int lengthGNodes(GNode*);
 String shortenDate(String);
+String shortenDateInto(String, String buffer); // buffer has SHORTDATELEN characters.
 String shortenPlace(String);
 //static bool allDigits(String)
 GNode* copyGNode(GNode*);
 GNode* copyGNodes(GNode*, bool, bool);
 void traverseNodes (GNode* node, int level, bool (*func)(GNode*, int));
+void beginGNodeWalk(GNodeWalk*, GNode* root, bool forest);
+GNode* nextGNodeWalk(GNodeWalk*); // Next node in pre-order; null when done.
+void endGNodeWalk(GNodeWalk*);
 int num_spouses_of_indi(GNode*);
 GNode* findNode(GNode*, String, String, GNode**);
 
@@ -61,6 +100,9 @@ int countNodesBefore(GNode*);
 
 bool isKey(String);
 GNode* findTag(GNode*, String);
+GNode* findTagId(GNode*, TagId);
+TagId tagToTagId(String);
+String tagIdToTag(TagId);
 SexType valueToSex(GNode*);
 String full_value(GNode*);
 String recordKey(GNode* node);
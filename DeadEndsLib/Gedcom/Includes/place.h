@@ -3,12 +3,16 @@
 //  place.h
 //
 //  Created by Thomas Wetmore on 12 February 2024
-//  Last changed on 4 June 2025.
+//  Last changed on 19 October 2026.
 
 #ifndef place_h
 #define place_h
 
-bool placeToList(String place, List *list);
-bool valueToList (String str, List *list, String dlm); // TODO: Should be elsewhere.
+#include "standard.h"
+
+typedef struct List List;
+
+void placeToList(String place, List *list);
+void valueToList (String str, List *list, String dlm); // TODO: Should be elsewhere.
 
 #endif // place_h
@@ -0,0 +1,51 @@
+//
+//  DeadEnds Library
+//
+//  relationship.h is the header file for the relationship calculator. It finds how two persons
+//  are related by a bidirectional breadth first search up the parent graph from both persons.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef relationship_h
+#define relationship_h
+
+#include "standard.h"
+
+typedef struct GNode GNode;
+typedef struct HashTable HashTable;
+typedef struct List List;
+typedef HashTable RecordIndex;
+
+// MAXRELATIONDEPTH is the maximum number of generations searched above either person.
+#define MAXRELATIONDEPTH 100
+
+// RelationType is the kind of relationship found between two persons.
+typedef enum RelationType {
+	relationNone = 0, // Not related by blood or by a step link.
+	relationSelf,     // The two persons are the same person.
+	relationBlood,    // The persons share a nearest common ancestor.
+	relationStep      // The persons are linked through the spouse of a parent.
+} RelationType;
+
+// Relationship holds the result of relating person one to person two. up is the number of
+// generations from one to the nearest common ancestor, and down the number of generations from
+// that ancestor to two. The path holds the GNode roots from one to two through the ancestor.
+typedef struct Relationship {
+	RelationType type;
+	int up;            // Generations from person one to the common ancestor.
+	int down;          // Generations from person two to the common ancestor.
+	bool half;         // Collateral relationship through one ancestor and different other parents.
+	GNode* ancestor;   // Nearest common ancestor (or step link spouse).
+	GNode* coancestor; // Spouse of the ancestor who is also a common ancestor; or null.
+	List* path;        // GNode roots from person one to person two; not owned by the List.
+} Relationship;
+
+Relationship* relatePersons(GNode* one, GNode* two, RecordIndex*);
+void deleteRelationship(Relationship*);
+String relationshipToString(Relationship*, GNode* one); // MNOTE: caller owns the String.
+int cousinDegree(Relationship*);
+int cousinRemoval(Relationship*);
+
+#endif // relationship_h
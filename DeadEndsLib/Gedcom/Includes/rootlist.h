@@ -4,7 +4,7 @@
 //  rootlist.h
 //
 //  Created by Thomas Wetmore on 2 March 2024.
-//  Last changed on 2 August 2025.
+//  Last changed on 19 October 2026.
 
 #ifndef rootlist_h
 #define rootlist_h
@@ -23,6 +23,7 @@ RootList *createRootList(void);  // Create a root list.
 void deleteRootList(RootList*);
 void insertInRootList(RootList*, GNode*);
 void appendToRootList(RootList*, GNode*);
+void sortRootList(RootList*); // Radix sort by key; removes duplicate keys.
 //RootList* getRootListFromFile(File*, IntegerTable*, ErrorLog*);
 RootList* getRootListFromGNodeList(GNodeList*, String file, ErrorLog*);
 void showRootList(RootList*);
@@ -3,8 +3,9 @@
 // date.c has the functions that deal with Gedcom-based dates.
 //
 // Created by Thomas Wetmore on 22 February 2023.
-// Last changed on 13 September 2024.
+// Last changed on 19 October 2026.
 
+#include <pthread.h>
 #include <time.h>
 #include "standard.h"
 #include "date.h"
@@ -50,9 +51,9 @@ static struct {
 	{ "cmp", "CMP", "computed", "COMPUTED" }, // 10
 };
 
-static String extractString = null;
-static String extractCursor = null;
-static StringTable *monthTable = null; // Maps month Strings to integers.
+static _Thread_local DateScanner dateScanner; // Used by the non-reentrant interface; one per thread.
+static pthread_once_t monthTableOnce = PTHREAD_ONCE_INIT;
+static IntegerTable *monthTable = null; // Maps month Strings to integers; read only once built.
 
 /*==========================================
  * formatDate -- Do general date formatting
@@ -87,7 +88,7 @@ static StringTable *monthTable = null; // Maps month Strings to integers.
 String formatDate (String string, int dayFmt, int monthFmt, int yearFmt, int dateFmt, bool cmplx) {
     int mod, day, month, year;
     String sda, smo, syr;
-    static char scratch[50], daystr[4];
+    static _Thread_local char scratch[50], daystr[4];
     String p = scratch;
     if (!string) return null;
     extractDate(string, &mod, &day, &month, &year, &syr);
@@ -333,7 +334,7 @@ static void formatDateModifier (int mod, String *pp) {
 // format is a code.
 // MNOTE: may return a static buffer.
 static String formatDay (int day, int format) {
-    static char scratch[3];
+    static _Thread_local char scratch[3];
     String p;
     if (day < 0 || day > 99 || format < 0 || format > 2) return null;
     strcpy(scratch, "  ");
@@ -358,7 +359,7 @@ static String formatDay (int day, int format) {
 // is a code.
 // MNOTE: may return a static buffer or .text space.
 static String formatMonth (int month, int format) {
-    static char scratch[3];
+    static _Thread_local char scratch[3];
     String p;
     if (month < 0 || month > 12 || format < 0 || format > 6) return null;
     if (format <= 2)  {
@@ -378,7 +379,7 @@ static String formatMonth (int month, int format) {
 // formatYear formats the year part of a date.
 // MNOTE: return static .bss memory.
 static String formatYear (int year, int format) {
-    static char scratch[5];
+    static _Thread_local char scratch[5];
     if (year <= 0 || year > 5000) return null;
     switch (format) {
         default: sprintf(scratch, "%d", year);
@@ -386,15 +387,23 @@ static String formatYear (int year, int format) {
     return (String) scratch;
 }
 
-// extractDate attempts to extract a date from any String.
+// extractDate attempts to extract a date from any String. A null String continues with the
+// String of the previous call.
+// MNOTE: the year String is in the calling thread's scanner until its next call.
 void extractDate(String string, int *pmod, int *pday, int *pmonth, int *pyear, String *pyrstr) {
+    extractDateInto(&dateScanner, string, pmod, pday, pmonth, pyear, pyrstr);
+}
+
+// extractDateInto extracts a date using a caller's DateScanner. A null String continues with the
+// String the scanner was last given. The year String is in the scanner.
+void extractDateInto(DateScanner* scanner, String string, int *pmod, int *pday, int *pmonth,
+                     int *pyear, String *pyrstr) {
     int tok, ival, era = 0;
     String sval;
-    static unsigned char yrstr[10];  // Year string?
     *pyrstr = "";
     *pmod = *pday = *pmonth = *pyear = 0;
-    if (string) setExtractString(string);
-    while ((tok = getDateToken(&ival, &sval))) {
+    if (string) initDateScanner(scanner, string);
+    while ((tok = scanDateToken(scanner, &ival, &sval))) {
         switch (tok) {
             case monthToken: // Month string
                 if (*pmonth == 0) *pmonth = ival;
@@ -413,8 +422,8 @@ void extractDate(String string, int *pmod, int *pday, int *pmonth, int *pyear, S
                 if (ival >= 100 ||
                     (ival > 0 && sval[0] == '0' && sval[1] == '0')) {
                     if (eqstr(*pyrstr,"")) {
-                        strcpy((char*) yrstr, sval);
-                        *pyrstr = (char*) yrstr;
+                        snprintf(scanner->yearString, sizeof(scanner->yearString), "%s", sval);
+                        *pyrstr = scanner->yearString;
                         *pyear = ival;
                     }
                 }
@@ -430,68 +439,81 @@ combine:
     *pmod += era;
 }
 
-// setExtractString initializes the file static date extraction string.
+// setExtractString initializes the static date scanner.
 /*static*/ void setExtractString (String str) {
-    extractString = str;
-	extractCursor = str;
-    if (!monthTable)
-        initMonthTable();
+    initDateScanner(&dateScanner, str);
 }
 
-// getDateToken returns the next token from the date extraction string.
+// getDateToken returns the next token from the static date scanner.
 /*static*/ DateToken getDateToken(int *pInt, String *pString) {
-    static unsigned char scratch[256]; // Where tokens are built.
-    String p = (String) scratch;
+    return scanDateToken(&dateScanner, pInt, pString);
+}
+
+// initDateScanner prepares a DateScanner to scan a String.
+void initDateScanner(DateScanner* scanner, String string) {
+    scanner->cursor = string;
+    scanner->token[0] = 0;
+    scanner->yearString[0] = 0;
+    pthread_once(&monthTableOnce, initMonthTable);
+}
+
+// scanDateToken returns the next token from a DateScanner. The token is built in the scanner.
+DateToken scanDateToken(DateScanner* scanner, int *pInt, String *pString) {
+    String scratch = scanner->token;
+    String last = scratch + sizeof(scanner->token) - 1;
+    String p = scratch;
+    String cursor = scanner->cursor;
 	*pInt = 0;
-	*pString = (String) scratch;
+    *pString = scratch;
     int i, c;
-    if (!extractString) return atEndToken; // Must exist.
-    while (iswhite(*extractString++)) ; // Skip white.
-    extractString--;
+    if (!cursor) return atEndToken; // Must exist.
+    while (iswhite(*cursor)) cursor++; // Skip white.
 	// Found a letter so look for a word.
-    if (isLetter(*extractString)) {
-		while (isLetter(*p++ = *extractString++)) // Load word into scratch.
-			;
-        *--p = 0;
-        extractString--;
-		*pString = (String) scratch;
-		if (strlen((const char*) scratch) == 1) return charToken;
+    if (isLetter(*cursor)) {
+        char upperWord[sizeof(scanner->token)];
+        String q = upperWord;
+        while (isLetter(*cursor)) {
+            if (p < last) {
+                *q++ = toupper((unsigned char) *cursor);
+                *p++ = *cursor;
+            }
+            cursor++;
+        }
+        *p = *q = 0;
+        scanner->cursor = cursor;
+        if (strlen(scratch) == 1) return charToken;
 		// If the word is in the month table, return the month's integer.
-        if ((i = searchIntegerTable(monthTable, upper((String)scratch))) > 0 && i <= 12) {
+        if ((i = searchIntegerTable(monthTable, upperWord)) > 0 && i <= 12) {
             *pInt = i;
             return monthToken;
         }
 		// If word is one of the known date words return its index.
-        *pInt = 0;
 		if (i > 12 && i <= 22) {
 			*pInt = i - 12;
 			return wordToken;
 		}
-        *pInt = 0;
         return unknownToken;
     }
-    if (chartype(*extractString) == DIGIT) {
+    if (chartype(*cursor) == DIGIT) {
         i = 0;
-		while (chartype(c = *p++ = *extractString++) == DIGIT) {
+        while (chartype(c = *cursor) == DIGIT) {
+            if (p < last) *p++ = c;
 			i = i*10 + c - '0';
+            cursor++;
 		}
-        //if (c == '/') { // Intended to handle double year dates.
-            //while (chartype(*p++ = *extractString++) == DIGIT) ;
-        //}
-        *--p = 0;
-        extractString--;
-        *pString = (String) scratch;
+        *p = 0;
+        scanner->cursor = cursor;
         *pInt = i;
         return intToken;
     }
-    if (*extractString == 0)  {
-        extractString = null;
+    if (*cursor == 0)  {
+        scanner->cursor = null;
         return atEndToken;
     }
-	*p++ = *extractString++;
+    *p++ = *cursor++;
 	*p = 0;
-	*pString = (String) scratch;
-	*pInt = (int) scratch[0];
+    scanner->cursor = cursor;
+    *pInt = (int) (unsigned char) scratch[0];
 	return charToken;
 }
 
@@ -512,7 +534,7 @@ static void initMonthTable(void) {
 String get_date(void) {
     struct tm *pt;
     time_t curtime;
-    static char dat[20];
+    static _Thread_local char dat[20];
     curtime = time(null);
     pt = localtime(&curtime);
     sprintf(dat, "%d %s %d", pt->tm_mday, monthStrings[pt->tm_mon].su, 1900 + pt->tm_year);
@@ -4,7 +4,7 @@
 //  gedcom.c has basic Gedcom functions.
 //
 //  Created by Thomas Wetmore on 29 November 2022.
-//  Last changed on 4 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "gedcom.h"
@@ -13,14 +13,15 @@
 // recordType returns the type of a Gedcom record.
 RecordType recordType(GNode* root) {
     ASSERT(root);
-    String tag = root->tag;
-    if (eqstr(tag, "INDI")) return GRPerson;
-    if (eqstr(tag, "FAM"))  return GRFamily;
-    if (eqstr(tag, "SOUR")) return GRSource;
-    if (eqstr(tag, "EVEN")) return GREvent;
-    if (eqstr(tag, "HEAD")) return GRHeader;
-    if (eqstr(tag, "TRLR")) return GRTrailer;
-    return GROther;
+    switch (root->tagId) {
+    case tagINDI: return GRPerson;
+    case tagFAM:  return GRFamily;
+    case tagSOUR: return GRSource;
+    case tagEVEN: return GREvent;
+    case tagHEAD: return GRHeader;
+    case tagTRLR: return GRTrailer;
+    default:      return GROther;
+    }
 }
 
 //  compareRecordKeys compares record keys; longer keys sort after shorter keys.
@@ -58,7 +59,7 @@ bool validSexString(String s) {
 // keyToKey takes a "lazy" key (may omit @-signs and have lower case letters), and converts it to a real key.
 // NOTE: Returns static memory form the upper function
 String keyToKey(String userKey) {
-    static char buffer[MAXSTRINGSIZE];
+    static _Thread_local char buffer[MAXSTRINGSIZE];
     if (strlen(userKey) > MAXSTRINGSIZE - 2) return userKey;
     if (userKey[0] != '@') {
         buffer[0] = '@';
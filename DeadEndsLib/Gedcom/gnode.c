@@ -3,21 +3,46 @@
 //  gnode.c has many functions for the GNode data type.
 //
 //  Created by Thomas Wetmore on 12 November 2022.
-//  Last changed on 20 May 2025.
+//  Last changed on 19 October 2026.
 
+#include <pthread.h>
 #include "standard.h"
 #include "gnode.h"
 #include "nodeutils.h"
 #include "lineage.h"
-#include "stringtable.h"
+#include "hashtable.h"
 #include "name.h"
 #include "gedcom.h"
 #include "splitjoin.h"
 #include "readnode.h"
 #include "database.h"
 
-// tagTable is the StringTable that holds a single copy of all tags used in the GNodes.
-static StringTable *tagTable = null;
+// TagEntry is an element in the tag table.
+typedef struct TagEntry {
+	String tag;
+	TagId tagId;
+} TagEntry;
+
+// knownTags are the tags of the TagIds, in TagId order. They never change, so they are found
+// without locking.
+static TagEntry knownTags[numTagIds] = {
+	{ "", tagOther },
+	{ "HEAD", tagHEAD }, { "TRLR", tagTRLR }, { "INDI", tagINDI }, { "FAM", tagFAM },
+	{ "SOUR", tagSOUR }, { "EVEN", tagEVEN }, { "NOTE", tagNOTE }, { "OBJE", tagOBJE },
+	{ "REPO", tagREPO }, { "SUBM", tagSUBM },
+	{ "NAME", tagNAME }, { "SEX", tagSEX }, { "BIRT", tagBIRT }, { "CHR", tagCHR },
+	{ "DEAT", tagDEAT }, { "BURI", tagBURI }, { "MARR", tagMARR }, { "DIV", tagDIV },
+	{ "FAMC", tagFAMC }, { "FAMS", tagFAMS }, { "HUSB", tagHUSB }, { "WIFE", tagWIFE },
+	{ "CHIL", tagCHIL },
+	{ "DATE", tagDATE }, { "PLAC", tagPLAC }, { "REFN", tagREFN }, { "TITL", tagTITL },
+	{ "TEXT", tagTEXT }, { "CONT", tagCONT }, { "CONC", tagCONC }
+};
+
+// tagTable is the HashTable that holds a single copy of the other tags used in the GNodes. It is
+// shared by all threads, so it is read locked when searched and write locked when extended.
+static HashTable *tagTable = null;
+static pthread_once_t tagTableOnce = PTHREAD_ONCE_INIT;
+static pthread_rwlock_t tagTableLock = PTHREAD_RWLOCK_INITIALIZER;
 
 // numGNodeAllocs returns the number of GNodes that have been allocated. Debugging.
 static int gnodeAllocs = 0;
@@ -27,12 +52,72 @@ int numGNodeAllocs(void) { return gnodeAllocs; }
 static int gnodeFrees = 0;
 int numGNodeFrees(void) { return gnodeFrees; }
 
-// getFromTagTable returns the persistent tag value from the tag table.
+// getTagKey returns the tag of a TagEntry.
+static String getTagKey(void* element) {
+	return ((TagEntry*) element)->tag;
+}
+
+// compareTags compares two tags.
+static int compareTags(String a, String b) {
+	return strcmp(a, b);
+}
+
+// addToTagTable adds a tag and its TagId to the tag table.
+static TagEntry* addToTagTable(String tag, TagId tagId) {
+	TagEntry* entry = (TagEntry*) stdalloc(sizeof(TagEntry));
+	entry->tag = strsave(tag);
+	entry->tagId = tagId;
+	addToHashTable(tagTable, entry, false);
+	return entry;
+}
+
+// initTagTable creates the empty tag table.
 static int numBucketsInTagTable = 67;
-static String getFromTagTable(String tag) {
-	if (tagTable) return fixString(tagTable, tag);
-	tagTable = createStringTable(numBucketsInTagTable);
-	return fixString(tagTable, tag);
+static void initTagTable(void) {
+	tagTable = createHashTable(getTagKey, compareTags, null, numBucketsInTagTable);
+}
+
+// searchKnownTags returns the entry of a tag that has a TagId; null if the tag has none.
+static TagEntry* searchKnownTags(String tag) {
+	for (int i = 1; i < numTagIds; i++) {
+		if (tag[0] == knownTags[i].tag[0] && eqstr(tag, knownTags[i].tag)) return &knownTags[i];
+	}
+	return null;
+}
+
+// searchTagTable returns the entry of a tag; null if the tag has not been seen.
+static TagEntry* searchTagTable(String tag) {
+	TagEntry* entry = searchKnownTags(tag);
+	if (entry) return entry;
+	pthread_once(&tagTableOnce, initTagTable);
+	pthread_rwlock_rdlock(&tagTableLock);
+	entry = (TagEntry*) searchHashTable(tagTable, tag);
+	pthread_rwlock_unlock(&tagTableLock);
+	return entry;
+}
+
+// getFromTagTable returns the entry of a tag, adding it to the tag table if it is new.
+static TagEntry* getFromTagTable(String tag) {
+	TagEntry* entry = searchTagTable(tag);
+	if (entry) return entry;
+	pthread_rwlock_wrlock(&tagTableLock);
+	entry = (TagEntry*) searchHashTable(tagTable, tag); // Another thread may have added it.
+	if (!entry) entry = addToTagTable(tag, tagOther);
+	pthread_rwlock_unlock(&tagTableLock);
+	return entry;
+}
+
+// tagToTagId returns the TagId of a tag; tagOther if the tag has none.
+TagId tagToTagId(String tag) {
+	if (!tag) return tagOther;
+	TagEntry* entry = searchKnownTags(tag);
+	return entry ? entry->tagId : tagOther;
+}
+
+// tagIdToTag returns the tag of a TagId; the empty String for tagOther.
+String tagIdToTag(TagId tagId) {
+	if (tagId < 0 || tagId >= numTagIds) return "";
+	return knownTags[tagId].tag;
 }
 
 // freeGNode frees a GNode. Do not free the tag!
@@ -50,11 +135,14 @@ GNode* createGNode(String key, String tag, String value, GNode* parent) {
 	gnodeAllocs++;
 	GNode* node = (GNode*) stdalloc(sizeof(GNode));;
 	node->key = strsave(key);
-	node->tag = getFromTagTable(tag);
+	TagEntry* entry = getFromTagTable(tag);
+	node->tag = entry->tag;
+	node->tagId = entry->tagId;
 	node->value = strsave(value);
 	node->parent = parent;
 	node->child = null;
 	node->sibling = null;
+	node->referent = null;
 	return node;
 }
 
@@ -81,60 +169,56 @@ int gnodeLevel(GNode* node) {
 
 // personToEvent converta an event tree to a string; returns static memory.
 String personToEvent(GNode* person, String tag, String head, int len, bool shorten) {
-	static char scratch[200];
-	String event;
-	size_t n;
-	if (!person) return null;
+	static _Thread_local char scratch[200];
+	return personToEventInto(person, tag, head, len, shorten, scratch, sizeof(scratch));
+}
+
+// personToEventInto converts the first event with a tag of a person to a string in a caller's
+// buffer; returns the buffer, or null if there is no event.
+String personToEventInto(GNode* person, String tag, String head, int len, bool shorten,
+						 String buffer, int size) {
+	char event[MAXLINELEN+1];
+	if (!person || size < 2) return null;
 	if (!(person = findTag(person->child, tag))) return null;
-	event = eventToString(person, shorten);
-	if (!event) return null;
-	sprintf(scratch, "%s%s", head, event);
-	n = strlen(scratch);
-	if (scratch[n-1] != '.') {
-		scratch[n] = '.';
-		scratch[++n] = 0;
+	if (!eventToStringInto(person, shorten, event, sizeof(event))) return null;
+	int n = snprintf(buffer, size - 1, "%s%s", head, event);
+	if (n > size - 2) n = size - 2;
+	if (n > 0 && buffer[n-1] != '.') {
+		buffer[n] = '.';
+		buffer[++n] = 0;
 	}
-	if (n > len) scratch[len] = 0;
-	return scratch;
+	if (n > len) buffer[len] = 0;
+	return buffer;
 }
 
 // eventToString converts an event to a string; returns static memory.
 String eventToString(GNode* node, bool shorten) {
-	static char scratch[MAXLINELEN+1];
-	String date, plac, p;
+	static _Thread_local char scratch[MAXLINELEN+1];
+	return eventToStringInto(node, shorten, scratch, sizeof(scratch));
+}
+
+// eventToStringInto converts an event to a string in a caller's buffer; returns the buffer, or
+// null if the event has no date or place.
+String eventToStringInto(GNode* node, bool shorten, String buffer, int size) {
+	char shortDate[MAXLINELEN+1];
+	String date, plac;
 	date = plac = null;
 	if (!node) return null;
 	node = node->child;
 	while (node) {
-		if (eqstr("DATE", node->tag) && !date) date = node->value;
-		if (eqstr("PLAC", node->tag) && !plac) plac = node->value;
+		if (node->tagId == tagDATE && !date) date = node->value;
+		if (node->tagId == tagPLAC && !plac) plac = node->value;
 		node = node->sibling;
 	}
 	if (!date && !plac) return null;
 	if (shorten) {
-		date = shortenDate(date);
+		date = shortenDateInto(date, shortDate);
 		plac = shortenPlace(plac);
 		if (!date && !plac) return null;
 	}
-	p = scratch;
-	if (date && !plac) {
-		strcpy(p, date);
-		p += strlen(p);
-	}
-	if (date && plac) {
-		strcpy(p, date);
-		p += strlen(p);
-		strcpy(p, ", ");
-		p += 2;
-		strcpy(p, plac);
-		p += strlen(p);
-	}
-	if (!date && plac) {
-		strcpy(p, plac);
-		p += strlen(p);
-	}
-	*p = 0;
-	return scratch;
+	if (date && plac) snprintf(buffer, size, "%s, %s", date, plac);
+	else snprintf(buffer, size, "%s", date ? date : plac);
+	return buffer;
 }
 
 // eventToDate returns the date of an event as a string.
@@ -145,6 +229,15 @@ String eventToDate(GNode* node, bool shorten) {
 	return node->value;
 }
 
+// eventToDateInto returns the date of an event as a string; a shortened date is put in a
+// caller's buffer.
+String eventToDateInto(GNode* node, bool shorten, String buffer) {
+	if (!node) return null;
+	if (!(node = DATE(node))) return null;
+	if (shorten) return shortenDateInto(node->value, buffer);
+	return node->value;
+}
+
 // eventToPlace returns the place of an event as a string.
 String eventToPlace (GNode* node, bool shorten) {
 	if (!node) return null;
@@ -192,23 +285,28 @@ int lengthGNodes(GNode* node) {
 	return len;
 }
 
-// shortenDate returns the short form of a date value.
+// shortenDate returns the short form of a date value; returns one of three static buffers.
 String shortenDate(String date) {
-	static char buffer[3][MAXLINELEN+1];
-	static int dex = 0;
+	static _Thread_local char buffer[3][MAXLINELEN+1];
+	static _Thread_local int dex = 0;
+	if (++dex > 2) dex = 0;
+	return shortenDateInto(date, buffer[dex]);
+}
+
+// shortenDateInto puts the short form of a date value, its first 3 or 4 digit number, in a
+// caller's buffer of at least SHORTDATELEN characters; returns the buffer or null.
+String shortenDateInto(String date, String buffer) {
 	String p = date, q;
 	int c, len;
 	/* Allow 3 or 4 digit years. The previous test for strlen(date) < 4
 	 * prevented dates consisting of only 3 digit years from being
 	 * returned. - pbm 12 oct 99 */
 	if (!date || (int) strlen(date) < 3) return null;
-	if (++dex > 2) dex = 0;
-	q = buffer[dex];
 	while (true) {
 		while ((c = *p++) && chartype(c) != DIGIT)
 			;
 		if (c == 0) return null;
-		q = buffer[dex];
+		q = buffer;
 		*q++ = c;
 		len = 1;
 		while ((c = *p++) && chartype(c) == DIGIT) {
@@ -218,8 +316,7 @@ String shortenDate(String date) {
 			}
 		}
 		*q = 0;
-		if (strlen(buffer[dex]) == 3 || strlen(buffer[dex]) == 4)
-			return buffer[dex];
+		if (len == 3 || len == 4) return buffer;
 		if (c == 0) return null;
 	}
 }
@@ -240,7 +337,9 @@ String shortenPlace(String place) {
 
 // copyGNode copies a GNode.
 GNode* copyGNode(GNode* node) {
-	return createGNode(node->key, node->tag, node->value, null);
+	GNode* copy = createGNode(node->key, node->tag, node->value, null);
+	copy->referent = node->referent;
+	return copy;
 }
 
 // copyGNodes copies a GNode tree. If kids or sibs copy children or siblings respectively.
@@ -263,23 +362,76 @@ GNode* copyGNodes(GNode* node, bool kids, bool sibs) {
 	return new;
 }
 
-// traverseNodes traverse the GNodes of a Gedcom record calling a function on each.
-void traverseNodes(GNode* node, int level, bool (*func)(GNode*, int)) {
-	if (func == null) return;
-	for (; node; node = node->sibling) {
-		if (!(*func)(node, level)) continue;
-		if (node->child) traverseNodes(node->child, level+1, func);
+// beginGNodeWalk starts a pre-order walk of the tree at root. If forest is true the siblings of
+// root and their trees are walked after it.
+void beginGNodeWalk(GNodeWalk* walk, GNode* root, bool forest) {
+	walk->root = root;
+	walk->node = null;
+	walk->level = 0;
+	walk->forest = forest;
+	walk->prune = false;
+	walk->started = false;
+	walk->maxLevel = NUMWALKANCESTORS;
+	walk->ancestors = walk->stack;
+}
+
+// pushAncestor adds the current node of a walk to its ancestors, moving them to a larger array
+// when they fill.
+static void pushAncestor(GNodeWalk* walk) {
+	if (walk->level == walk->maxLevel) {
+		GNode** ancestors = (GNode**) stdalloc(2*walk->maxLevel*sizeof(GNode*));
+		memcpy(ancestors, walk->ancestors, walk->maxLevel*sizeof(GNode*));
+		if (walk->ancestors != walk->stack) stdfree(walk->ancestors);
+		walk->ancestors = ancestors;
+		walk->maxLevel *= 2;
 	}
+	walk->ancestors[walk->level++] = walk->node;
+}
+
+// nextGNodeWalk returns the next node of a walk in pre-order; null when the walk is done. If the
+// prune flag was set the children of the last node are skipped.
+GNode* nextGNodeWalk(GNodeWalk* walk) {
+	if (!walk->started) {
+		walk->started = true;
+		return walk->node = walk->root;
+	}
+	GNode* node = walk->node;
+	if (!node) return null;
+	if (node->child && !walk->prune) {
+		pushAncestor(walk);
+		return walk->node = node->child;
+	}
+	walk->prune = false;
+	while (walk->level > 0 && !node->sibling) node = walk->ancestors[--walk->level];
+	if (walk->level == 0 && !walk->forest) return walk->node = null;
+	return walk->node = node->sibling;
+}
+
+// endGNodeWalk frees the memory a walk of a deep tree used.
+void endGNodeWalk(GNodeWalk* walk) {
+	if (walk->ancestors != walk->stack) stdfree(walk->ancestors);
+	walk->ancestors = walk->stack;
+}
+
+// traverseNodes traverse the GNodes of a Gedcom record calling a function on each. If the
+// function returns false the children of the node are not traversed.
+void traverseNodes(GNode* node, int level, bool (*func)(GNode*, int)) {
+	if (!node || !func) return;
+	GNodeWalk walk;
+	beginGNodeWalk(&walk, node, true);
+	for (GNode* next; (next = nextGNodeWalk(&walk));)
+		if (!func(next, level + walk.level)) walk.prune = true;
+	endGNodeWalk(&walk);
 }
 
 // countGNodes return the number of GNodes in a GNode tree or forest.
 int countGNodes(GNode* node) {
-	if (node == null) return 0;
-	int count = 1 + countGNodes(node->child) + countGNodes(node->sibling);
-	if (count > 40000) {
-		printf("Recursing forever?????\n");
-		exit(3);
-	}
+	if (!node) return 0;
+	int count = 0;
+	GNodeWalk walk;
+	beginGNodeWalk(&walk, node, true);
+	while (nextGNodeWalk(&walk)) count++;
+	endGNodeWalk(&walk);
 	return count;
 }
 
@@ -316,8 +468,11 @@ bool isKey(String str) {
 	return str && str[0] == '@' && str[strlen(str) - 1] == '@' && strlen(str) >= 3;
 }
 
-// findTag searches a list of nodes and returns the first with a specific tag.
+// findTag searches a list of nodes and returns the first with a specific tag. Tags with TagIds
+// are found by findTagId.
 GNode* findTag(GNode* node, String tag) {
+	TagId tagId = tagToTagId(tag);
+	if (tagId != tagOther) return findTagId(node, tagId);
 	while (node) {
 		if (eqstr(tag, node->tag)) return node;
 		node = node->sibling;
@@ -325,6 +480,15 @@ GNode* findTag(GNode* node, String tag) {
 	return null;
 }
 
+// findTagId searches a list of nodes and returns the first with a specific TagId.
+GNode* findTagId(GNode* node, TagId tagId) {
+	while (node) {
+		if (node->tagId == tagId) return node;
+		node = node->sibling;
+	}
+	return null;
+}
+
 // valueToSex converts a 1 SEX GNode value to enumerated form.
 SexType valueToSex (GNode* node) {
 	if (!node || !node->value) return sexUnknown;
@@ -342,7 +506,7 @@ String full_value(GNode* node) {
 	if (!node) return null;
 	if ((p = node->value)) len += strlen(p) + 1;
 	cont = node->child;
-	while (cont && !strcmp("CONT", cont->tag)) {
+	while (cont && cont->tagId == tagCONT) {
 		if ((p = cont->value))
 			len += strlen(p) + 1;
 		else
@@ -356,7 +520,7 @@ String full_value(GNode* node) {
 		p += strlen(p);
 	}
 	cont = node->child;
-	while (cont && !strcmp("CONT", cont->tag)) {
+	while (cont && cont->tagId == tagCONT) {
 		if ((q = cont->value))
 			sprintf(p, "%s\n", q);
 		else
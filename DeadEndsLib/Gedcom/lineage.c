@@ -4,7 +4,7 @@
 //  lineage.c holds functions that peform genealogical operations on GNodes.
 //
 //  Created by Thomas Wetmore on 17 February 2023.
-//  Last changed on 4 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "database.h"
@@ -33,10 +33,10 @@ GNode* personToPreviousSibling(GNode* indi, RecordIndex* index) {
 	if (!famc) return null;
 	GNode* prev = null;
 	GNode* node = CHIL(famc);
-	while (node && eqstr("CHIL", node->tag)) {
+	while (node && node->tagId == tagCHIL) {
 		if (eqstr(indi->key, node->value)) {
 			if (!prev) return null;
-			return keyToPerson(prev->value, index);
+			return REFTOPERSON(prev, index);
 		}
 		prev = node;
 		node = node->sibling;
@@ -51,28 +51,28 @@ GNode* personToNextSibling(GNode* indi, RecordIndex* index) {
 	GNode* fam = personToFamilyAsChild(indi, index);
 	if (!fam) return null;
 	GNode* node = CHIL(fam);
-	while (node && eqstr("CHIL", node->tag)) {
+	while (node && node->tagId == tagCHIL) {
 		if (eqstr(indi->key, node->value)) break;
 		node = node->sibling;
 	}
 	if (!node) return null;
 	node = node->sibling;
-	if (!node || nestr("CHIL", node->tag)) return null;
-	return keyToPerson(node->value, index);
+	if (!node || node->tagId != tagCHIL) return null;
+	return REFTOPERSON(node, index);
 }
 
 // familyToHusband -return the first husband of a family, the first HUSB in the family.
 GNode* familyToHusband(GNode* node, RecordIndex* index) {
 	if (!node) return null;
-	if (!(node = findTag(node->child, "HUSB"))) return null;
-	return keyToPerson(node->value, index);
+	if (!(node = findTagId(node->child, tagHUSB))) return null;
+	return REFTOPERSON(node, index);
 }
 
 // familyToWife returns the first wife of a family, the first WIFE in the family.
 GNode* familyToWife(GNode* node, RecordIndex* index) {
 	if (!node) return null;
-	if (!(node = findTag(node->child, "WIFE"))) return null;
-	return keyToPerson(node->value, index);
+	if (!(node = findTagId(node->child, tagWIFE))) return null;
+	return REFTOPERSON(node, index);
 }
 
 // familyToSpouse return the first spouse with given sex from a family.
@@ -95,7 +95,7 @@ GNode *personToSpouse(GNode *person, GNode *family)
 GNode* familyToFirstChild(GNode* node, RecordIndex* index) {
 	if (!node) return null;
 	if (!(node = CHIL(node))) return null;
-	return keyToPerson(node->value, index);
+	return REFTOPERSON(node, index);
 }
 
 // familyToLastChild return the last child of a family, the last CHIL in the family.
@@ -104,10 +104,10 @@ GNode* familyToLastChild(GNode* node, RecordIndex* index) {
 	if (!(node = CHIL(node))) return null;
 	GNode* chil = null;
 	while (node) {
-		if (eqstr(node->tag, "CHIL")) chil = node;
+		if (node->tagId == tagCHIL) chil = node;
 		node = node->sibling;
 	}
-	return keyToPerson(chil->value, index);
+	return REFTOPERSON(chil, index);
 }
 
 // numberOfSpouses returns the number of spouses of a person.
@@ -125,7 +125,7 @@ int numberOfFamilies(GNode* person) {
 	if (!person) return 0;
 	int nfamilies = 0;
 	GNode* fams = FAMS(person);
-	while (fams && eqstr("FAMS", fams->tag)) {
+	while (fams && fams->tagId == tagFAMS) {
 		nfamilies++;
 		fams = fams->sibling;
 	}
@@ -136,21 +136,21 @@ int numberOfFamilies(GNode* person) {
 GNode* personToFamilyAsChild(GNode* person, RecordIndex* index) {
 	if (!person) return null;
 	if (!(person = FAMC(person))) return null;
-	return keyToFamily(person->value, index);
+	return REFTOFAMILY(person, index);
 }
 
 // personToName returns the name of a person, the value of the first NAME in the person. length
 // is the max number of characters to use for the name.
 String personToName(GNode* person, int length) {
 	if (!person) return "";
-	if (!(person = findTag(person->child, "NAME"))) return "";
+	if (!(person = findTagId(person->child, tagNAME))) return "";
 	return manipulateName(person->value, true, true, length);
 }
 
 // personToTitle returns the title of a person, the value of the first TITL node in the person.
 String personToTitle(GNode* indi, int len) {
 	if (!indi) return null;
-	if (!(indi = findTag(indi->child, "TITL"))) return null;
+	if (!(indi = findTagId(indi->child, tagTITL))) return null;
 	return indi->value;
 }
 
@@ -5,7 +5,7 @@
 //  static memory. Callers beware.
 //
 //  Created by Thomas Wetmore on 7 November 2022.
-//  Last changed on 7 July 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "database.h"
@@ -16,10 +16,8 @@
 #include "set.h"
 #include "standard.h"
 
-static int old = 0;
-
 // Static functions used in this file.
-static int codeOf(int letter);
+static int codeOf(int letter, int* old);
 static String partsToName(String* parts);
 static bool pieceMatch(String partial, String complete);
 static void nameToParts(String name, String *parts);
@@ -31,14 +29,21 @@ static String nameSurnameFirst(String);
 
 // nameToNameKey converts a Gedcom name or partial name to a name key.
 String nameToNameKey(String name) {
-    static char key[6];
-    char finitial = getFirstInitial(name);
-    String sdex = soundex(getSurname(name));
-    key[0] = finitial;
-    key[1] = *sdex++;
-    key[2] = *sdex++;
-    key[3] = *sdex++;
-    key[4] = *sdex;
+    static _Thread_local char key[6];
+    return nameToNameKeyInto(name, key);
+}
+
+// nameToNameKeyInto converts a Gedcom name or partial name to a name key in a buffer of at least
+// six characters. It uses no static memory so it can be called from more than one thread.
+String nameToNameKeyInto(String name, String key) {
+    char surname[MAXLINELEN+1];
+    char sdex[5];
+    soundexInto(getSurnameInto(name, surname), sdex);
+    key[0] = getFirstInitial(name);
+    key[1] = sdex[0];
+    key[2] = sdex[1];
+    key[3] = sdex[2];
+    key[4] = sdex[3];
     key[5] = 0;
     return key;
 }
@@ -46,18 +51,22 @@ String nameToNameKey(String name) {
 // getSurname returns the surname part of a Gedcom name.
 #define NBUFFERS (4)
 String getSurname(String name) {
-    int c;
-    static char buffer[NBUFFERS][MAXLINELEN+1];
-    static int dex = 0;
-    String p, surname;
+    static _Thread_local char buffer[NBUFFERS][MAXLINELEN+1];
+    static _Thread_local int dex = 0;
     if (++dex > NBUFFERS-1) dex = 0;
-    p = surname = buffer[dex];
+    return getSurnameInto(name, buffer[dex]);
+}
+
+// getSurnameInto puts the surname part of a Gedcom name in a buffer of MAXLINELEN+1 characters.
+String getSurnameInto(String name, String surname) {
+    int c;
+    String p = surname;
     while ((c = *name++) && c != '/')
         ;
-    if (c == 0) return "____";
+    if (c == 0) return strcpy(surname, "____");
     while (iswhite(c = *name++))
         ;
-    if (c == 0 || c == '/' || !isLetter(c)) return "____";
+    if (c == 0 || c == '/' || !isLetter(c)) return strcpy(surname, "____");
     *p++ = c;
     while ((c = *name++) && c != '/')
         *p++ = c;
@@ -81,20 +90,22 @@ int getFirstInitial(String name) {
 
 // soundex returns the Soundex code of a surname.
 String soundex(String name) {
-    static char scratch[MAXNAMELEN];
+    static _Thread_local char scratch[5];
+    return soundexInto(name, scratch);
+}
+
+// soundexInto puts the Soundex code of a surname in a buffer of at least five characters.
+String soundexInto(String name, String code) {
     int c, j;
-    if (!name || strlen(name) > MAXNAMELEN || !strcmp(name, "____"))
-        return "Z999";
+    if (!name || !*name || strlen(name) > MAXNAMELEN || !strcmp(name, "____"))
+        return strcpy(code, "Z999");
     String p = name;
-    String q = scratch;
-    while ((c = *p++))
-        *q++ = toupper(c);
-    *q = 0;
-    p = q = &scratch[1];
+    String q = code;
+    *q++ = toupper(*p++);
     int i = 1;
-    old = 0;
+    int old = 0;
     while ((c = *p++) && i < 4) {
-        if ((j = codeOf(c)) == 0) continue;
+        if ((j = codeOf(toupper(c), &old)) == 0) continue;
         *q++ = j;
         i++;
     }
@@ -103,11 +114,11 @@ String soundex(String name) {
         i++;
     }
     *q = 0;
-    return scratch;
+    return code;
 }
 
-// codeof returns a letter's Soundex code.
-static int codeOf(int letter) {
+// codeof returns a letter's Soundex code; old holds the code of the letter before.
+static int codeOf(int letter, int* old) {
     int new = 0;
     switch (letter) {
     case 'B': case 'P': case 'F': case 'V':
@@ -127,11 +138,11 @@ static int codeOf(int letter) {
 		break;
     }
     if (new == 0) {
-        old = 0;
+        *old = 0;
         return 0;
     }
-    if (new == old) return 0;
-    old = new;
+    if (new == *old) return 0;
+    *old = new;
     return new;
 }
 
@@ -205,32 +216,37 @@ String* personKeysFromName(String name, RecordIndex* rindex, NameIndex* nindex,
 		initBlock(&recordKeys);
         first = false;
     }
-	*pcount = 0;
+	*pcount = personKeysFromNameInto(name, rindex, nindex, &recordKeys);
+	return *pcount ? (String*) recordKeys.elements : null;
+}
+
+// personKeysFromNameInto puts the keys of the persons with a name that matches a name pattern
+// in a caller's Block, which is emptied first; returns the number of keys. The keys are not
+// copied.
+int personKeysFromNameInto(String name, RecordIndex* rindex, NameIndex* nindex, Block* keys) {
+	emptyBlock(keys, null);
 	// Get Set of person keys with names that match the pattern.
-    Set *keySet = searchNameIndex(nindex, name);
-    if (!keySet || lengthSet(keySet) == 0) return null;
-	// Copy person keys with matching names to a Block.
-    emptyBlock(&recordKeys, null);
-	int count = 0;
+	Set *keySet = searchNameIndex(nindex, name);
+	if (!keySet || lengthSet(keySet) == 0) return 0;
+	// Copy person keys with matching names to the Block.
 	List* list = listOfSet(keySet);
 	FORLIST(list, recordKey)
 		GNode* person = keyToPerson((String) recordKey, rindex);
-		for (GNode* node = NAME(person); node && eqstr(node->tag, "NAME"); node = node->sibling) {
+		for (GNode* node = NAME(person); node && node->tagId == tagNAME; node = node->sibling) {
 			if (!exactMatch(name, node->value)) continue; // exactMatch doesn't mean 'exact.'
-			appendToBlock(&recordKeys, recordKey);
-			count++;
+			appendToBlock(keys, recordKey);
 			break;
 		}
 	ENDLIST
-	*pcount = count;
-    return (String*) recordKeys.elements;
+	return keys->length;
 }
 
 // compareNames compares two Gedcom names and returns their relationship.
 int compareNames(String name1, String name2) {
     char sqz1[MAXNAMELEN], sqz2[MAXNAMELEN];
+    char surname1[MAXLINELEN+1], surname2[MAXLINELEN+1];
     String p1 = sqz1,  p2 = sqz2;
-    int r = strcmp(getSurname(name1), getSurname(name2));
+    int r = strcmp(getSurnameInto(name1, surname1), getSurnameInto(name2, surname2));
     if (r) return r;
     r = getFirstInitial(name1) - getFirstInitial(name2);
     if (r) return r;
@@ -247,6 +263,37 @@ int compareNames(String name1, String name2) {
     return 0;
 }
 
+// nameToCollationKey returns a String that compares with strcmp as compareNames compares names,
+// with ties broken by record key, so persons can be sorted by name without parsing their names
+// again. The surname, first initial and squeezed given names are separated by bytes that sort
+// before any name character. A null name sorts before all others.
+// MNOTE: the String is in the heap.
+String nameToCollationKey(String name, String recordKey) {
+    char buffer[2*MAXLINELEN + MAXNAMELEN];
+    String p = buffer;
+    if (name) {
+        char surname[MAXLINELEN+1];
+        char pieces[MAXLINELEN+2];
+        strcpy(p, getSurnameInto(name, surname));
+        p += strlen(p);
+        *p++ = 1;
+        *p++ = getFirstInitial(name) + 129; // Unsigned bytes in the order of compareNames' ints.
+        *p++ = 1;
+        cmpsqueeze(name, pieces);
+        for (String q = pieces; *q; q += strlen(q) + 1) {
+            strcpy(p, q);
+            p += strlen(p);
+            *p++ = 2;
+        }
+    }
+    *p++ = 1;
+    int length = min((int) strlen(recordKey), MAXNAMELEN - 1);
+    *p++ = 3 + length; // Shorter keys sort first, as in compareRecordKeys.
+    memcpy(p, recordKey, length);
+    p[length] = 0;
+    return strsave(buffer);
+}
+
 // cmpsqueeze squeezes a Gedcom name to a superstring of given names.
 static void cmpsqueeze(String in, String out) {
     int c;
@@ -268,7 +315,7 @@ static void cmpsqueeze(String in, String out) {
 // TODO: I don't see how this ignores the surname.
 String getGivenNames(String name) {
     int c;
-    static char scratch[MAXNAMELEN+1];
+    static _Thread_local char scratch[MAXNAMELEN+1];
     String out = scratch;
     while ((name = nextPiece(name))) { // Next piece.
         while (true) {
@@ -337,7 +384,7 @@ String trimName(String name, int len) {
 
 // nameToParts converts a Gedcom name to its parts; keep slashes.
 static void nameToParts(String name, String* parts) {
-    static char scratch[MAXNAMELEN+1];
+    static _Thread_local char scratch[MAXNAMELEN+1];
     String p = scratch;
     int c, i = 0;
     ASSERT(strlen(name) <= MAXNAMELEN);
@@ -395,7 +442,7 @@ bool nameToList(String name, List* list, int* plen, int* psind) {
 // partsToName converts a list of name parts to a single String; uses static memeory.
 static String partsToName(String* parts) {
     int i;
-    static char scratch[MAXNAMELEN+1];
+    static _Thread_local char scratch[MAXNAMELEN+1];
     String p = scratch;
     for (i = 0; i < MAXPARTS; i++) {
         if (!parts[i]) continue;
@@ -412,7 +459,7 @@ static String partsToName(String* parts) {
 
 // upsurname makes a Gedcom name have an all uppercase surname. Static memory returned.
 String upsurname(String name) {
-    static char scratch[MAXNAMELEN+1];
+    static _Thread_local char scratch[MAXNAMELEN+1];
     String p = scratch;
     int c;
     while ((c = *p++ = *name++) && c != '/') ;
@@ -436,7 +483,7 @@ String manipulateName(String name, bool caps, bool reg, int len) {
 
 // nameString removes the slashes from a Gedcom name; uses static memory.
 String nameString(String name) {
-    static char scratch[MAXNAMELEN+1];
+    static _Thread_local char scratch[MAXNAMELEN+1];
     String p = scratch;
     ASSERT(strlen(name) <= MAXNAMELEN);
     while (*name) {
@@ -450,7 +497,7 @@ String nameString(String name) {
 
 // nameSurnameFirst converts a Gedcom name to surname first form.
 static String nameSurnameFirst(String name) {
-    static char scratch[MAXNAMELEN+1];
+    static _Thread_local char scratch[MAXNAMELEN+1];
     String p = scratch;
     ASSERT(strlen(name) <= MAXNAMELEN);
     strcpy(p, getSurname(name));
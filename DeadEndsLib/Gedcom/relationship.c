@@ -0,0 +1,462 @@
+//
+//  DeadEnds Library
+//
+//  relationship.c holds the relationship calculator. relatePersons runs a bidirectional breadth
+//  first search up the parent graph from two persons. Each side keeps a HashTable of the persons
+//  it has reached, with their generation and the person they were reached from. When one side
+//  reaches a person already reached by the other side, that person is a common ancestor. The
+//  search stops when no undiscovered common ancestor can be nearer than the nearest found.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "database.h"
+#include "gedcom.h"
+#include "gnode.h"
+#include "hashtable.h"
+#include "lineage.h"
+#include "list.h"
+#include "relationship.h"
+
+static bool debugging = false;
+static int numBucketsInRelationTables = 257;
+
+// RelationEl is an element of a search side's table of reached persons. next is the person one
+// generation nearer the person the side started from.
+typedef struct RelationEl {
+	GNode* person;
+	GNode* next;
+	int depth;
+} RelationEl;
+
+// SearchSide holds the state of one side of the bidirectional search.
+typedef struct SearchSide {
+	HashTable* seen; // Persons reached by this side.
+	List* frontier;  // Persons reached in the last generation expanded.
+	int level;       // Generation of the frontier.
+	bool done;       // Frontier is empty or too deep.
+} SearchSide;
+
+// getKey returns the key of a RelationEl.
+static String getKey(void* element) {
+	return ((RelationEl*) element)->person->key;
+}
+
+// compare compares the keys of two RelationEls.
+static int compare(String a, String b) {
+	return strcmp(a, b);
+}
+
+// delete frees a RelationEl; the GNodes are not freed.
+static void delete(void* element) {
+	stdfree(element);
+}
+
+// createRelationEl creates a RelationEl.
+static RelationEl* createRelationEl(GNode* person, GNode* next, int depth) {
+	RelationEl* el = (RelationEl*) stdalloc(sizeof(RelationEl));
+	el->person = person;
+	el->next = next;
+	el->depth = depth;
+	return el;
+}
+
+// initSearchSide initializes a SearchSide to start at a person.
+static void initSearchSide(SearchSide* side, GNode* person) {
+	side->seen = createHashTable(getKey, compare, delete, numBucketsInRelationTables);
+	addToHashTable(side->seen, createRelationEl(person, null, 0), false);
+	side->frontier = createList(null, null, null, false);
+	appendToList(side->frontier, person);
+	side->level = 0;
+	side->done = false;
+}
+
+// termSearchSide frees the memory used by a SearchSide.
+static void termSearchSide(SearchSide* side) {
+	deleteHashTable(side->seen);
+	deleteList(side->frontier);
+}
+
+// Candidates is the List of common ancestors found at the best total distance so far.
+typedef struct Candidates {
+	int best;
+	List* ancestors;
+} Candidates;
+
+// noteMeeting records a person reached by both sides as a candidate common ancestor.
+static void noteMeeting(Candidates* cands, GNode* person, int total) {
+	if (total > cands->best) return;
+	if (total < cands->best) {
+		cands->best = total;
+		emptyList(cands->ancestors);
+	}
+	appendToList(cands->ancestors, person);
+}
+
+// visitParent adds a parent to a side if it has not been reached, and checks the other side.
+static void visitParent(SearchSide* side, SearchSide* other, GNode* parent, GNode* child,
+						List* next, Candidates* cands) {
+	if (!parent || isInHashTable(side->seen, parent->key)) return;
+	int depth = side->level + 1;
+	addToHashTable(side->seen, createRelationEl(parent, child, depth), false);
+	appendToList(next, parent);
+	RelationEl* el = (RelationEl*) searchHashTable(other->seen, parent->key);
+	if (el) noteMeeting(cands, parent, depth + el->depth);
+}
+
+// expandSide moves a side up one generation, visiting the parents in all families of the
+// persons in its frontier.
+static void expandSide(SearchSide* side, SearchSide* other, RecordIndex* index, Candidates* cands) {
+	List* next = createList(null, null, null, false);
+	FORLIST(side->frontier, element)
+		GNode* person = (GNode*) element;
+		FORFAMCS(person, family, fkey, index)
+			if (family) {
+				FORHUSBS(family, husband, hkey, index)
+					visitParent(side, other, husband, person, next, cands);
+				ENDHUSBS
+				FORWIFES(family, wife, wkey, index)
+					visitParent(side, other, wife, person, next, cands);
+				ENDWIFES
+			}
+		ENDFAMCS
+	ENDLIST
+	deleteList(side->frontier);
+	side->frontier = next;
+	side->level++;
+	if (isEmptyList(next) || side->level >= MAXRELATIONDEPTH) side->done = true;
+}
+
+// lowerBound returns the least total distance of a common ancestor not yet found. A person not
+// yet reached by both sides must be beyond the level of at least one of them.
+static int lowerBound(SearchSide* one, SearchSide* two) {
+	int infinity = 2*MAXRELATIONDEPTH + 1;
+	int a = one->done ? infinity : one->level + 1;
+	int b = two->done ? infinity : two->level + 1;
+	return min(a, b);
+}
+
+// depthIn returns the depth of a person in a side; -1 if the person was not reached.
+static int depthIn(SearchSide* side, GNode* person) {
+	RelationEl* el = (RelationEl*) searchHashTable(side->seen, person->key);
+	return el ? el->depth : -1;
+}
+
+// areSpouses returns true if two persons are spouses in a family.
+static bool areSpouses(GNode* one, GNode* two, RecordIndex* index) {
+	FORSPOUSES(one, spouse, family, num, index)
+		if (spouse == two) return true;
+	ENDSPOUSES
+	return false;
+}
+
+// buildPath returns the List of persons from the first side's start person, up to the ancestor,
+// and then down to the second side's start person.
+static List* buildPath(SearchSide* one, SearchSide* two, GNode* ancestor) {
+	List* path = createList(null, null, null, false);
+	for (GNode* person = ancestor; person;) {
+		prependToList(path, person);
+		person = ((RelationEl*) searchHashTable(one->seen, person->key))->next;
+	}
+	GNode* person = ((RelationEl*) searchHashTable(two->seen, ancestor->key))->next;
+	while (person) {
+		appendToList(path, person);
+		person = ((RelationEl*) searchHashTable(two->seen, person->key))->next;
+	}
+	return path;
+}
+
+// otherParent returns the other parent of a child in the family in which a person is one of the
+// child's parents; null if the person is not a parent of the child or no other parent is
+// recorded.
+static GNode* otherParent(GNode* child, GNode* parent, RecordIndex* index) {
+	FORFAMCS(child, family, fkey, index)
+		if (family) {
+			bool isParent = false;
+			GNode* other = null;
+			FORHUSBS(family, husband, hkey, index)
+				if (husband == parent) isParent = true;
+				else if (husband) other = husband;
+			ENDHUSBS
+			FORWIFES(family, wife, wkey, index)
+				if (wife == parent) isParent = true;
+				else if (wife) other = wife;
+			ENDWIFES
+			if (isParent) return other;
+		}
+	ENDFAMCS
+	return null;
+}
+
+// isHalfRelation returns true if a collateral relationship with one common ancestor is half.
+// The children of the ancestor on the two lines must both record another parent, and those
+// parents must differ; full siblings with only one recorded parent are not half siblings.
+static bool isHalfRelation(Relationship* relation, RecordIndex* index) {
+	if (relation->up == 0 || relation->down == 0 || relation->coancestor) return false;
+	GNode* childOne = (GNode*) getListElement(relation->path, relation->up - 1);
+	GNode* childTwo = (GNode*) getListElement(relation->path, relation->up + 1);
+	GNode* otherOne = otherParent(childOne, relation->ancestor, index);
+	GNode* otherTwo = otherParent(childTwo, relation->ancestor, index);
+	return otherOne && otherTwo && otherOne != otherTwo;
+}
+
+// createRelationship allocates a Relationship of a given type.
+static Relationship* createRelationship(RelationType type) {
+	Relationship* relation = (Relationship*) stdalloc(sizeof(Relationship));
+	memset(relation, 0, sizeof(Relationship));
+	relation->type = type;
+	relation->path = createList(null, null, null, false);
+	return relation;
+}
+
+// stepParentLink returns the parent in a family who is a spouse of a person who is not a parent
+// in the family; null if there is none.
+static GNode* stepParentLink(GNode* family, GNode* person, RecordIndex* index) {
+	FORHUSBS(family, husband, hkey, index)
+		if (husband == person) return null;
+	ENDHUSBS
+	FORWIFES(family, wife, wkey, index)
+		if (wife == person) return null;
+	ENDWIFES
+	FORHUSBS(family, husband, hkey, index)
+		if (husband && areSpouses(husband, person, index)) return husband;
+	ENDHUSBS
+	FORWIFES(family, wife, wkey, index)
+		if (wife && areSpouses(wife, person, index)) return wife;
+	ENDWIFES
+	return null;
+}
+
+// stepRelationship looks for a link through the spouse of a parent between two persons who have
+// no common ancestor. Returns null if there is none.
+static Relationship* stepRelationship(GNode* one, GNode* two, RecordIndex* index) {
+	Relationship* relation = null;
+	FORFAMCS(one, family, fkey, index) // Is two the spouse of a parent of one?
+		if (family) {
+			GNode* parent = stepParentLink(family, two, index);
+			if (!relation && parent) {
+				relation = createRelationship(relationStep);
+				relation->up = 1;
+				relation->ancestor = parent;
+			}
+		}
+	ENDFAMCS
+	if (!relation) { // Is one the spouse of a parent of two?
+		Relationship* inverse = null;
+		FORFAMCS(two, family, fkey, index)
+			if (family) {
+				GNode* parent = stepParentLink(family, one, index);
+				if (!inverse && parent) {
+					inverse = createRelationship(relationStep);
+					inverse->down = 1;
+					inverse->ancestor = parent;
+				}
+			}
+		ENDFAMCS
+		relation = inverse;
+	}
+	if (relation) {
+		appendToList(relation->path, one);
+		appendToList(relation->path, relation->ancestor);
+		appendToList(relation->path, two);
+		return relation;
+	}
+	GNode* father = personToFather(one, index); // Are parents of the two persons spouses?
+	GNode* mother = personToMother(one, index);
+	GNode* parents[] = { father, mother };
+	for (int i = 0; i < 2 && !relation; i++) {
+		if (!parents[i]) continue;
+		FORSPOUSES(parents[i], spouse, family, num, index)
+			if (!relation && (spouse == personToFather(two, index) || spouse == personToMother(two, index))) {
+				relation = createRelationship(relationStep);
+				relation->up = relation->down = 1;
+				relation->ancestor = parents[i];
+				relation->coancestor = spouse;
+			}
+		ENDSPOUSES
+	}
+	if (!relation) return null;
+	appendToList(relation->path, one);
+	appendToList(relation->path, relation->ancestor);
+	appendToList(relation->path, relation->coancestor);
+	appendToList(relation->path, two);
+	return relation;
+}
+
+// relatePersons finds the relationship of person one to person two. It returns a Relationship
+// whose type is relationNone if the persons are not related by blood or a step link.
+// MNOTE: the caller must delete the Relationship.
+Relationship* relatePersons(GNode* one, GNode* two, RecordIndex* index) {
+	if (!one || !two) return null;
+	if (one == two) {
+		Relationship* relation = createRelationship(relationSelf);
+		relation->ancestor = one;
+		appendToList(relation->path, one);
+		return relation;
+	}
+	SearchSide a, b;
+	initSearchSide(&a, one);
+	initSearchSide(&b, two);
+	Candidates cands = { 2*MAXRELATIONDEPTH + 1, createList(null, null, null, false) };
+	while (!(a.done && b.done)) {
+		if (lowerBound(&a, &b) > cands.best) break;
+		// Expand the lower side so the lower bound rises; break ties on frontier size.
+		SearchSide *side = &a, *other = &b;
+		if (a.done || (!b.done && (b.level < a.level ||
+			(b.level == a.level && lengthList(b.frontier) < lengthList(a.frontier))))) {
+			side = &b;
+			other = &a;
+		}
+		expandSide(side, other, index, &cands);
+	}
+	if (debugging) printf("relatePersons: %d candidates at distance %d.\n",
+						  lengthList(cands.ancestors), cands.best);
+	Relationship* relation = null;
+	if (isEmptyList(cands.ancestors)) {
+		relation = stepRelationship(one, two, index);
+		if (!relation) relation = createRelationship(relationNone);
+	} else {
+		// Choose the most even split of generations; ties go to the first found.
+		GNode* ancestor = null;
+		int bestSkew = 2*MAXRELATIONDEPTH + 1;
+		FORLIST(cands.ancestors, element)
+			GNode* person = (GNode*) element;
+			int skew = abs(depthIn(&a, person) - depthIn(&b, person));
+			if (skew < bestSkew) {
+				bestSkew = skew;
+				ancestor = person;
+			}
+		ENDLIST
+		relation = createRelationship(relationBlood);
+		relation->ancestor = ancestor;
+		relation->up = depthIn(&a, ancestor);
+		relation->down = depthIn(&b, ancestor);
+		FORLIST(cands.ancestors, element)
+			GNode* person = (GNode*) element;
+			if (person != ancestor && depthIn(&a, person) == relation->up &&
+				depthIn(&b, person) == relation->down && areSpouses(ancestor, person, index)) {
+				relation->coancestor = person;
+				break;
+			}
+		ENDLIST
+		deleteList(relation->path);
+		relation->path = buildPath(&a, &b, ancestor);
+		relation->half = isHalfRelation(relation, index);
+	}
+	deleteList(cands.ancestors);
+	termSearchSide(&a);
+	termSearchSide(&b);
+	return relation;
+}
+
+// deleteRelationship frees a Relationship; the GNodes in its path are not freed.
+void deleteRelationship(Relationship* relation) {
+	if (!relation) return;
+	deleteList(relation->path);
+	stdfree(relation);
+}
+
+// cousinDegree returns the cousin degree of a blood relationship; 0 for siblings, uncles and
+// nephews, and -1 for direct lines.
+int cousinDegree(Relationship* relation) {
+	if (!relation || relation->type != relationBlood) return -1;
+	if (relation->up == 0 || relation->down == 0) return -1;
+	return min(relation->up, relation->down) - 1;
+}
+
+// cousinRemoval returns the number of generations by which two blood relatives are removed.
+int cousinRemoval(Relationship* relation) {
+	if (!relation || relation->type != relationBlood) return 0;
+	return abs(relation->up - relation->down);
+}
+
+static char *ordinals[] = {
+	"first", "second", "third", "fourth", "fifth", "sixth", "seventh", "eighth", "ninth",
+	"tenth", "eleventh", "twelfth"
+};
+
+// ordinal adds the ordinal of a number to a buffer, as a word up to twelfth and then as digits
+// with the suffix: 13th, 21st, 22nd, 23rd, 111th, 112th.
+static void ordinal(String buffer, int number) {
+	if (number >= 1 && number <= 12) {
+		strcat(buffer, ordinals[number - 1]);
+		return;
+	}
+	String suffix = "th";
+	if (number % 100 < 11 || number % 100 > 13) {
+		if (number % 10 == 1) suffix = "st";
+		else if (number % 10 == 2) suffix = "nd";
+		else if (number % 10 == 3) suffix = "rd";
+	}
+	sprintf(buffer + strlen(buffer), "%d%s", number, suffix);
+}
+
+// greats adds the "grand" and "great" prefixes used for generations beyond the first.
+static void greats(String buffer, int generations) {
+	if (generations == 2) strcat(buffer, "grand");
+	else if (generations == 3) strcat(buffer, "great grand");
+	else if (generations > 3) sprintf(buffer + strlen(buffer), "great(%d) grand", generations - 2);
+}
+
+// uncleGreats adds the "great" prefixes used for uncles, aunts, nephews and nieces.
+static void uncleGreats(String buffer, int generations) {
+	if (generations == 3) strcat(buffer, "great ");
+	else if (generations > 3) sprintf(buffer + strlen(buffer), "great(%d) ", generations - 2);
+}
+
+// relationshipToString returns the relationship of person one to person two as a String, for
+// example "first cousin twice removed" or "half brother". The sex of one chooses the words.
+// MNOTE: the String is in the heap.
+String relationshipToString(Relationship* relation, GNode* one) {
+	char buffer[MAXSTRINGSIZE];
+	buffer[0] = 0;
+	if (!relation) return strsave("");
+	SexType sex = one ? SEXV(one) : sexUnknown;
+	bool male = sex == sexMale, female = sex == sexFemale;
+	int up = relation->up, down = relation->down;
+	switch (relation->type) {
+	case relationNone:
+		return strsave("not related");
+	case relationSelf:
+		return strsave("self");
+	case relationStep:
+		strcpy(buffer, "step");
+		if (up == 0) strcat(buffer, male ? "father" : female ? "mother" : "parent");
+		else if (down == 0) strcat(buffer, male ? "son" : female ? "daughter" : "child");
+		else strcat(buffer, male ? "brother" : female ? "sister" : "sibling");
+		return strsave(buffer);
+	case relationBlood:
+		break;
+	}
+	if (up == 0) { // One is an ancestor of two.
+		greats(buffer, down);
+		strcat(buffer, male ? "father" : female ? "mother" : "parent");
+		return strsave(buffer);
+	}
+	if (down == 0) { // One is a descendant of two.
+		greats(buffer, up);
+		strcat(buffer, male ? "son" : female ? "daughter" : "child");
+		return strsave(buffer);
+	}
+	if (relation->half) strcat(buffer, "half ");
+	if (up == 1 && down == 1) {
+		strcat(buffer, male ? "brother" : female ? "sister" : "sibling");
+	} else if (up == 1) {
+		uncleGreats(buffer, down);
+		strcat(buffer, male ? "uncle" : female ? "aunt" : "uncle or aunt");
+	} else if (down == 1) {
+		uncleGreats(buffer, up);
+		strcat(buffer, male ? "nephew" : female ? "niece" : "nephew or niece");
+	} else {
+		int degree = cousinDegree(relation);
+		int removal = cousinRemoval(relation);
+		ordinal(buffer, degree);
+		strcat(buffer, " cousin");
+		if (removal == 1) strcat(buffer, " once removed");
+		else if (removal == 2) strcat(buffer, " twice removed");
+		else if (removal == 3) strcat(buffer, " thrice removed");
+		else if (removal > 3) sprintf(buffer + strlen(buffer), " %d times removed", removal);
+	}
+	return strsave(buffer);
+}
@@ -5,7 +5,7 @@
 //  the root GNodes of Gedcom records.
 //
 //  Created by Thomas Wetmore on 2 March 2024.
-//  Last changed on 2 August 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "errors.h"
@@ -40,8 +40,15 @@ void deleteRootList(RootList* rootlist) {
     deleteList(rootlist);
 }
 
-// insertInRootList adds a GNode* to a RootList.
+// insertInRootList adds a GNode* to a RootList, keeping it sorted. A root whose key follows
+// the last key is appended without a search.
 void insertInRootList(RootList* list, GNode* root) {
+	int length = lengthList(list);
+	if (list->isSorted && (!length ||
+			compare(getKey(getListElement(list, length - 1)), getKey(root)) < 0)) {
+		appendToRootList(list, root);
+		return;
+	}
 	int index = -1;
 	if (findInList(list, list->getKey(root), &index)) {
 		printf("THERE IS A ERROR -- DUPLICATE ROOT KEYS\n");
@@ -50,8 +57,64 @@ void insertInRootList(RootList* list, GNode* root) {
 	insertInList(list, root, index);
 }
 
+// appendToRootList appends a GNode* to a RootList. The RootList stays sorted if the root's key
+// follows the last key.
 void appendToRootList(RootList* list, GNode* gnode) {
-    appendToList(list, gnode);
+	int length = lengthList(list);
+	bool sorted = list->isSorted && (!length ||
+			compare(getKey(getListElement(list, length - 1)), getKey(gnode)) < 0);
+	appendToList(list, gnode);
+	list->isSorted = sorted;
+}
+
+// sortRootList sorts a RootList by key with a radix sort, and removes roots with duplicate keys,
+// keeping the first. Keys sort by length, then by character, so there is one counting pass for
+// each character position, from last to first, and a final pass by length.
+void sortRootList(RootList* list) {
+	if (list->isSorted) return;
+	Block* block = &(list->block);
+	int length = block->length;
+	int maxLength = 0;
+	for (int i = 0; i < length; i++) {
+		String key = getKey(block->elements[i]);
+		maxLength = max(maxLength, key ? (int) strlen(key) : 0);
+	}
+	void** elements = block->elements;
+	void** sorted = (void**) stdalloc(max(length, 1)*sizeof(void*));
+	int numBuckets = max(256, maxLength + 1);
+	int* counts = (int*) stdalloc((numBuckets + 1)*sizeof(int));
+	for (int pos = maxLength - 1; pos >= -1; pos--) { // pos == -1 is the pass by length.
+		memset(counts, 0, (numBuckets + 1)*sizeof(int));
+		for (int i = 0; i < length; i++) {
+			String key = getKey(elements[i]);
+			int keyLength = key ? (int) strlen(key) : 0;
+			int bucket = pos < 0 ? keyLength : (pos < keyLength ? (unsigned char) key[pos] : 0);
+			counts[bucket + 1]++;
+		}
+		for (int b = 0; b < numBuckets; b++) counts[b + 1] += counts[b];
+		for (int i = 0; i < length; i++) {
+			String key = getKey(elements[i]);
+			int keyLength = key ? (int) strlen(key) : 0;
+			int bucket = pos < 0 ? keyLength : (pos < keyLength ? (unsigned char) key[pos] : 0);
+			sorted[counts[bucket]++] = elements[i];
+		}
+		void** swap = elements;
+		elements = sorted;
+		sorted = swap;
+	}
+	int unique = 0; // Remove duplicates; the sort is stable so the first of each key is kept.
+	for (int i = 0; i < length; i++) {
+		if (unique && eqstr(getKey(elements[unique - 1]), getKey(elements[i]))) {
+			printf("THERE IS A ERROR -- DUPLICATE ROOT KEYS\n");
+			continue;
+		}
+		elements[unique++] = elements[i];
+	}
+	memmove(block->elements, elements, unique*sizeof(void*));
+	stdfree(elements == block->elements ? sorted : elements);
+	stdfree(counts);
+	block->length = unique;
+	list->isSorted = true;
 }
 
 // getNodeTreesFromNodeList processes the GNodeList of all GNodes from a Gedcom source into
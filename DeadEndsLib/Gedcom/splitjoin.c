@@ -5,7 +5,7 @@
 //  together. Calling split and join formats GNode trees into standard form.
 //
 //  Created by Thomas Wetmore on 7 November 2022.
-//  Last changed on 4 June 2025.
+//  Last changed on 19 October 2026.
 
 #include "gedcom.h"
 #include "gnode.h"
@@ -17,28 +17,36 @@ void splitPerson(GNode* indi, GNode** pname, GNode** prefn, GNode** psex, GNode*
                  GNode** pfamc, GNode** pfams) {
     GNode *name, *lnam, *refn, *sex, *body, *famc, *fams, *last;
     GNode *lfmc, *lfms, *lref, *prev, *node;
-    ASSERT(eqstr("INDI", indi->tag));
+    ASSERT(indi->tagId == tagINDI);
     name = sex = body = famc = fams = last = lfms = lfmc = lnam = null;
     refn = lref = null;
     node = indi->child;
     indi->child = indi->sibling = null;
     while (node) {
-        String tag = node->tag;
-        if (eqstr("NAME", tag)) {
+        switch (node->tagId) {
+        case tagNAME:
             if (!name) name = lnam = node;
             else lnam = lnam->sibling = node;
-        } else if (!sex && eqstr("SEX", tag)) {
-            sex = node;
-        } else if (eqstr("FAMC", tag)) {
+            break;
+        case tagFAMC:
             if (!famc) famc = lfmc = node;
             else lfmc = lfmc->sibling = node;
-         } else if (eqstr("FAMS", tag)) {
+            break;
+        case tagFAMS:
             if (!fams) fams = lfms = node;
             else lfms = lfms->sibling = node;
-         } else if (eqstr("REFN", tag)) {
+            break;
+        case tagREFN:
             if (!refn) refn = lref = node;
             else lref = lref->sibling = node;
-        } else {
+            break;
+        case tagSEX:
+            if (!sex) {
+                sex = node;
+                break;
+            }
+            // Later SEX nodes go in the body.
+        default:
             if (!body) body = last = node;
             else last = last->sibling = node;
         }
@@ -58,7 +66,7 @@ void splitPerson(GNode* indi, GNode** pname, GNode** prefn, GNode** psex, GNode*
 void joinPerson(GNode* indi, GNode* name, GNode* refn, GNode* sex, GNode* body, GNode* famc,
                  GNode* fams) {
     GNode *node = null;
-    ASSERT(indi && eqstr("INDI", indi->tag));
+    ASSERT(indi && indi->tagId == tagINDI);
     indi->child = null;
     if (name) {
         indi->child = node = name;
@@ -95,37 +103,42 @@ void splitFamily(GNode* fam, GNode** prefn, GNode** phusb, GNode** pwife, GNode*
                   GNode** prest) {
     GNode *node, *rest, *last, *husb, *lhsb, *wife, *lwfe, *chil, *lchl;
     GNode *prev, *refn, *lref;
-    String tag;
     rest = last = husb = wife = chil = lchl = lhsb = lwfe = null;
     prev = refn = lref = null;
     node = fam->child;
     fam->child = fam->sibling = null;
     while (node) {
-        tag = node->tag;
-        if (eqstr("HUSB", tag)) {
+        switch (node->tagId) {
+        case tagHUSB:
             if (husb)
                 lhsb = lhsb->sibling = node;
             else
                 husb = lhsb = node;
-        } else if (eqstr("WIFE", tag)) {
+            break;
+        case tagWIFE:
             if (wife)
                 lwfe = lwfe->sibling = node;
             else
                 wife = lwfe = node;
-        } else if (eqstr("CHIL", tag)) {
+            break;
+        case tagCHIL:
             if (chil)
                 lchl = lchl->sibling = node;
             else
                 chil = lchl = node;
-        } else if (eqstr("REFN", tag)) {
+            break;
+        case tagREFN:
             if (refn)
                 lref = lref->sibling = node;
             else
                 refn = lref = node;
-        } else if (rest)
-            last = last->sibling = node;
-        else
-            last = rest = node;
+            break;
+        default:
+            if (rest)
+                last = last->sibling = node;
+            else
+                last = rest = node;
+        }
         prev = node;
         node = node->sibling;
         prev->sibling = null;
@@ -171,14 +184,12 @@ void joinFamily (GNode* fam, GNode* refn, GNode* husb, GNode* wife, GNode* chil,
 static void splitTree(GNode* root, GNode** prefn, GNode** prest) {
 	GNode *node, *rest, *last;
 	GNode *prev, *refn, *lref;
-	String tag;
 	rest = last = null;
 	prev = refn = lref = null;
 	node = root->child;
 	root->child = root->sibling = null;
 	while (node) {
-		tag = node->tag;
-		if (eqstr("REFN", tag)) {
+		if (node->tagId == tagREFN) {
 			if (refn)
 				lref = lref->sibling = node;
 			else
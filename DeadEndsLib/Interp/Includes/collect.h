@@ -0,0 +1,47 @@
+//
+//  DeadEnds Library
+//
+//  collect.h is the header file for the collector of the Lists, Tables and Sequences that scripts
+//  create. A Context keeps track of them, frees the ones that can no longer be reached when
+//  enough have been created since the last collection, and frees the rest when it is deleted.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef collect_h
+#define collect_h
+
+#include "pvalue.h"
+
+typedef struct Context Context;
+
+// Aggregate is a List, Table or Sequence created by a script.
+typedef struct Aggregate {
+	PVType type;
+	void* value;
+	bool marked; // Reachable from a variable.
+} Aggregate;
+
+// Aggregates holds the Aggregates of a Context.
+typedef struct Aggregates {
+	Aggregate* elements;
+	int length;
+	int maxLength;
+	int numSorted; // The first numSorted elements are sorted by address.
+	int nextCollection; // Collect when length reaches this.
+	int numHolding; // User functions called from expressions; nothing is collected while positive.
+	PValue* roots; // Values held by loop statements rather than variables.
+	int numRoots;
+	int maxRoots;
+} Aggregates;
+
+// Interface to the collector.
+Aggregates* createAggregates(void);
+PValue trackAggregate(Context*, PValue); // Returns the PValue.
+void pushRoot(Context*, PValue); // Keeps the value's Aggregate until popRoot.
+void popRoot(Context*);
+void collectAggregates(Context*); // Frees the Aggregates no variable or root can reach.
+void freeAggregates(Aggregates*); // Frees all the Aggregates.
+
+#endif // collect_h
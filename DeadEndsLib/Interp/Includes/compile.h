@@ -0,0 +1,97 @@
+//
+//  DeadEnds Library
+//
+//  compile.h is the header file for the bytecode compiler and the virtual machine that runs its
+//  code. The compiler is an optional pass run after the resolver; it compiles the body of each
+//  procedure and function into a Code that runRoutine runs in place of the PNode tree.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef compile_h
+#define compile_h
+
+#include "interp.h"
+#include "pvalue.h"
+
+typedef struct Program Program;
+
+extern bool compiling; // If true Programs are compiled to bytecode after they are parsed.
+
+// OpCode enumerates the instructions of the virtual machine. The machine keeps a stack of
+// PValues and an error flag that the instructions set and test as the builtins they replace do.
+typedef enum OpCode {
+	// Expressions; each pushes one value.
+	OpInt, OpFloat, OpString,   // Push the constant in the PNode; clear the flag.
+	OpSlot,                     // Push the value of variable a.
+	OpNewline, OpSpace,         // nl() and sp().
+	OpTrue, OpFalse,            // Push a boolean; the flag is left alone.
+	OpAccumulate,               // Push integer a to start an add or mul.
+	OpBuiltin,                  // Call the builtin of the PNode; it evaluates its arguments.
+	OpEvaluate,                 // Evaluate the PNode with the tree walker.
+	OpCall,                     // Call the function of the PNode with the a values on the stack.
+	OpCheckArgument,            // If the flag is set drop the a arguments, report the error and
+	                            // push null and jump to b, or if b is -1 end with InterpError.
+	OpBail,                     // If the flag is set drop a values, push null and jump to b.
+	OpAdd, OpMul,               // Add or multiply the top value into the one below; b on failure.
+	OpSub, OpDiv, OpMod,        // Binary arithmetic as evalBinary does it.
+	OpNeg, OpNot, OpDecimal,    // neg(), not() and d().
+	OpEq, OpNe, OpLt, OpLe, OpGt, OpGe, // Comparisons.
+	OpAnd, OpOr,                // Test the top value; on a decision push it and jump to b.
+	// Statements.
+	OpOutput,                   // Write the String constant of the PNode.
+	OpOutputSlot,               // Write variable a if it is a String.
+	OpOutputValue,              // Pop a builtin's value; report an error or write a String.
+	OpBuiltinStatement,         // Call the builtin of the PNode and write a String value.
+	OpFunctionStatement,        // Call a function with a arguments and write a String value.
+	OpProcedure,                // Call the procedure of the PNode with a arguments.
+	OpSet, OpIncr, OpDecr,      // set(), incr() and decr() of variable a.
+	OpCondition,                // Pop a condition; report an error or jump to b if false.
+	OpConditionSet,             // Same, assigning the value to variable a.
+	OpConditionError,           // A condition whose first argument is not an identifier.
+	OpJump,                     // Jump to b.
+	OpLoop,                     // Jump to b, the top of a loop, collecting if it is time.
+	OpReturnValue,              // Pop the value of a return statement.
+	OpEnd, OpBreak, OpContinue, OpReturn, // Leave with InterpOkay, ...Break, ...Continue, ...Return.
+	OpFatal,                    // A PNode that can't be interpreted.
+	// Loops; a is the loop's state, b is the instruction that ends the loop; the b of OpTraverse
+	// is its node stack.
+	OpChildren, OpNextChild,
+	OpSpouses, OpNextSpouse,
+	OpFamilies, OpNextFamily,
+	OpFathers, OpNextFather,
+	OpMothers, OpNextMother,
+	OpParents, OpNextParent,
+	OpNotes, OpNextNote, OpEndNotes,
+	OpNodes, OpNextNode,
+	OpRecords, OpNextRecord, OpEndRecords, // forindi, forfam, forsour, foreven and forothr.
+	OpSequence, OpNextElement, OpEndSequence,
+	OpList, OpNextItem, OpEndList,
+	OpTraverse, OpNextTraverse, OpEndTraverse
+} OpCode;
+
+// Instruction is an instruction of a Code.
+typedef struct Instruction {
+	OpCode op;
+	int a;        // Variable slot, count or loop state.
+	int b;        // Instruction jumped to.
+	PNode* pnode; // PNode the instruction was compiled from.
+} Instruction;
+
+// Code is the compiled body of a procedure or function.
+typedef struct Code {
+	Instruction* instructions;
+	int length;
+	int maxLength;
+	int maxStack;      // Most values on the stack at once.
+	int numLoops;      // Most loops nested at once.
+	int numTraverses;  // Most traverse loops nested at once.
+} Code;
+
+// Interface to the compiler and virtual machine.
+void compileProgram(Program*);
+void deleteCode(Code*);
+InterpType runCode(Code*, Context*, PValue* returnValue); // Returns what interpret returns.
+
+#endif // compile_h
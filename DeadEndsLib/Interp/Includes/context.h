@@ -3,7 +3,7 @@
 //  context.h
 //
 //  Created by Thomas Wetmore on 21 May 2025.
-//  Last changed on 13 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef context_h
@@ -18,6 +18,7 @@ typedef struct PValue PValue;
 typedef struct Frame Frame;
 typedef struct File File;
 typedef struct List List;
+typedef struct Aggregates Aggregates;
 
 // Structure that holds parsed DeadEnds programs.
 typedef struct Program {
@@ -29,15 +30,18 @@ typedef struct Program {
 
 Program* createProgram(void); // TODO: Change to take parameters.
 void deleteProgram(Program*);
-void validateCalls(FunctionTable*, FunctionTable*);
+int linkProgram(Program*); // Returns the number of link errors.
 
 // Context holds the context in which interpretation takes place.
 typedef struct Context {
     Database* database; // The database.
     Program* program;
-    SymbolTable* globals; // Global symbol table.
+    PValue* globals; // Values of the global variables, in globalIdents order.
+    int numGlobals;
     Frame* frame; // Bottom frame of run time stack.
+    Frame* freeFrames; // Deleted frames kept for reuse.
     File* file; // Current program output file.
+    Aggregates* aggregates; // Lists, Tables and Sequences the script created.
 } Context;
 
 // Interface.
@@ -4,7 +4,7 @@
 //  evaluate.h
 //
 //  Created by Thomas Wetmore on 15 December 2022.
-//  Last changed on 8 May 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef evaluate_h
@@ -27,5 +27,9 @@ GNode* evaluateFamily(PNode*, Context*, bool*);    // Evaluate and return a fami
 PValue evaluateBoolean(PNode*, Context*, bool*);   // Evaluate a boolean expression.
 int evaluateInteger(PNode*, Context*, bool*);      // Evaluate an integer expression.
 String evaluateString(PNode*, Context*, bool*);    // Evaluate a string expression.
+bool pvalueToBoolean(PValue);                      // Convert a value to a boolean.
+GNode* pvalueToPerson(PValue, PNode*, bool*);      // Return the person of an evaluated expression.
+GNode* pvalueToFamily(PValue, PNode*, bool*);      // Return the family of an evaluated expression.
+GNode* pvalueToGNode(PValue, bool*);               // Return the GNode of an evaluated expression.
 
 #endif /* evaluate_h */
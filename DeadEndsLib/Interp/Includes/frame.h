@@ -3,27 +3,35 @@
 //  frame.h is the header file for the sturture that defines the DeadEnds script run time stack.
 //
 //  Created by Thomas Wetmore on 20 May 2025.
-//  Last changed on 26 July 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef frame_h
 #define frame_h
 
-typedef struct HashTable HashTable;
-typedef HashTable SymbolTable;
+#include "pvalue.h"
+
+typedef struct Context Context;
 typedef struct PNode PNode;
 
-// A Frame holds a calling PNode, definition PNode, SymbolTable, and caller's Frame.
+// A Frame holds a calling PNode, definition PNode, the values of the routine's parameters and
+// local variables, and caller's Frame. The resolver gives each variable its slot in the values.
+// Deleted Frames are kept by their Context and reused, so a call does not allocate once the
+// Context has Frames with enough slots.
 typedef struct Frame Frame;
 typedef struct Frame {
     PNode* call; // Routine's call site (in caller).
     PNode* defn; // Routine's definition.
-    SymbolTable* table; // Routine's SymbolTable.
-    Frame* caller; // Frame of the routine's caller.
+    PValue* slots; // Values of the routine's variables; defn->numSlots of them.
+    int maxSlots; // Number of slots allocated.
+    Frame* caller; // Frame of the routine's caller; next free Frame when not in use.
 } Frame;
 
 // Interface to Frame.
-Frame* createFrame(PNode*, PNode*, SymbolTable*, Frame*);
-void deleteFrame(Frame*);
+Frame* createFrame(Context*, PNode*, PNode*);
+void deleteFrame(Context*, Frame*);
+void freeFrames(Frame*);
+void assignValueToFrame(Frame*, int slot, PValue);
+void showFrame(Frame*);
 
 #endif // frame_h
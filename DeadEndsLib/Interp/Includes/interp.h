@@ -4,7 +4,7 @@
 //  interp.h is the header file for the DeadEnds script interpreter.
 //
 //  Created by Thomas Wetmore on 8 December 2022.
-//  Last changed on 2 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef interp_h
@@ -24,6 +24,7 @@ typedef struct Script Script;
 typedef struct Program Program;
 
 #define CC 32 // 'Commutative constant'.
+#define MAXTRAVERSEDEPTH 100 // Deepest Gedcom node a traverse loop reaches.
 
 // InterpType enumerates the interpreter functions return types.
 typedef enum InterpType {
@@ -54,6 +55,7 @@ InterpType interpForList(PNode*, Context*, PValue*);
 InterpType interpIfStatement(PNode*, Context*, PValue*);
 InterpType interpWhileStatement(PNode*, Context*, PValue*);
 InterpType interpProcCall(PNode*, Context*, PValue*);  // User-defined procedure calls.
+InterpType runRoutine(PNode*, Frame*, Context*, PValue*); // Runs a procedure or function body.
 InterpType interpTraverse(PNode*, Context*, PValue*);
 InterpType interp_fornodes(PNode*, Context*, PValue*);
 
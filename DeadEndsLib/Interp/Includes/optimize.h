@@ -0,0 +1,22 @@
+//
+//  DeadEnds Library
+//
+//  optimize.h is the header file for the optimizer, the pass run after parsing that simplifies
+//  the PNode trees of a Program before they are interpreted.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef optimize_h
+#define optimize_h
+
+#include "standard.h"
+
+typedef struct Program Program;
+
+extern bool optimizing; // If false Programs are interpreted as parsed.
+
+void optimizeProgram(Program*);
+
+#endif // optimize_h
@@ -6,7 +6,7 @@
 //  procedures and functions it parses. The nodes represent both statements and expressions.
 //
 //  Created by Thomas Wetmore on 14 December 2022.
-//  Last changed on 3 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef pnode_h
@@ -14,6 +14,7 @@
 
 #include "standard.h"
 
+typedef struct Code Code;
 typedef struct Context Context;
 typedef struct HashTable SymbolTable;
 typedef struct PNode PNode;
@@ -60,6 +61,21 @@ struct PNode {
 	String idenOne;
 	String idenTwo;
 	String idenThree;
+
+	// Variable slots set by the resolver; see resolver.h.
+	int slot;           // Slot of the identifier in stringOne.
+	int slotOne;        // Slots of idenOne, idenTwo and idenThree.
+	int slotTwo;
+	int slotThree;
+	int numSlots;       // Procedure and function definitions: number of local slots,
+	String* slotNames;  // and their names, parameters first.
+
+	// Call links set by linkProgram.
+	PNode* routine;     // Procedure and function calls: the definition called.
+	int numArgs;        // Procedure and function calls: number of arguments.
+	int numParams;      // Procedure and function definitions: number of parameters.
+
+	Code* code;         // Procedure and function definitions: body compiled by compileProgram.
 };
 
 // Mnemonic names for the program node fields.
@@ -105,6 +121,23 @@ struct PNode {
 #define stringCons  stringOne
 #define noteIden    stringOne  // The value of a GNode value field (with continuation) in NOTE node.
 
+// Mnemonic names for the slots of the loop identifiers; they follow the identifier names above.
+#define countSlot   slotThree
+#define levelSlot   slotTwo
+#define valueSlot   slotTwo
+#define personSlot  slotOne
+#define familySlot  slotOne
+#define childSlot   slotOne
+#define spouseSlot  slotTwo
+#define gnodeSlot   slotOne
+#define fatherSlot  slotTwo
+#define motherSlot  slotTwo
+#define sourceSlot  slotOne
+#define eventSlot   slotOne
+#define otherSlot   slotOne
+#define elementSlot slotOne
+#define noteSlot    slot
+
 PNode *iconsPNode(long);
 PNode *fconsPNode(double);
 PNode *sconsPNode(String string);
@@ -0,0 +1,32 @@
+//
+//  DeadEnds Library
+//
+//  profile.h is the header file for the script profiler. While a script runs it counts and times
+//  the statements of each line, the calls of each procedure and function, and the calls of each
+//  builtin, and optionally samples the run time stack for flame graphs.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef profile_h
+#define profile_h
+
+#include "pvalue.h"
+
+typedef struct Context Context;
+typedef struct PNode PNode;
+
+extern bool profileScripts; // If true runProgram profiles the scripts it runs.
+extern String profileStacksFile; // If not null the run time stack is sampled into this file.
+extern bool profiling; // True while a script is being profiled.
+
+// Interface to the profiler.
+void beginProfile(Context*);
+void endProfile(FILE*); // Writes the report and the folded stacks.
+void profileLine(PNode*); // Called before each statement.
+void enterRoutine(PNode*); // Called with the definition of a procedure or function.
+void leaveRoutine(void);
+PValue profileBuiltin(PNode*, Context*, bool* errflg); // Calls and times a builtin.
+
+#endif // profile_h
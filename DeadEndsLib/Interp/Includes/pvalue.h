@@ -6,7 +6,7 @@
 //  returned by script functions.
 //
 //  Created by Thomas Wetmore on 15 December 2022.
-//  Last changed on 17 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef pvalue_h
@@ -45,15 +45,22 @@ typedef union VUnion {
 } VUnion;
 
 // PValue is the type of the script language expressions. It is a value type whenever possible,
-// though PValues in symbol tables are in the heap. Note that special care is reqired throughout
-// in handling PVString PValues because Strings are usually on the heap.
+// though PValues in symbol tables are in the heap. The String of a PVString PValue is a PString;
+// each PValue that holds it holds one reference to it.
 typedef struct PValue {
 	PVType type;
 	VUnion value;
 } PValue;
 
+// PStrings are the immutable, reference counted Strings of PVString PValues. The count is kept
+// in front of the characters, so a PString is read as an ordinary String.
+String createPString(String); // Count is one.
+String retainPString(String);
+void releasePString(String); // Frees the PString when its count reaches zero.
+
 // User Interface to PValues.
 PValue createStringPValue(String);
+PValue retainPValue(PValue);
 void showPValue(PValue value);
 bool isPValue(PValue value);
 bool isRecordType(PVType type); // PValue is a GNode root.
@@ -114,5 +121,6 @@ void setPValue(PValue, int, VUnion);
 PValue copyPValue(PValue);
 PValue* allocPValue(PVType type, VUnion value);
 void freePValue(PValue* pvalue);
+void clearPValue(PValue* pvalue); // Releases a String value and makes the PValue null.
 
 #endif // pvalue_h
@@ -3,7 +3,7 @@
 //  Library
 //
 //  Created by Thomas Wetmore on 27 July 2025.
-//  Last changed on 28 July 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef pvaluelist_h
@@ -14,5 +14,6 @@
 typedef List PValueList;
 
 PValueList* createPValueList(void);
+void deletePValueList(PValueList*);
 
 #endif // pvaluelist_h
@@ -0,0 +1,25 @@
+//
+//  DeadEnds Library
+//
+//  resolver.h is the header file for the resolver, the pass run after parsing that gives every
+//  script variable a slot. The parameters and local variables of a procedure or function get
+//  slots 0, 1, ... in its Frames; the globals get slots in the Context.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#ifndef resolver_h
+#define resolver_h
+
+typedef struct Program Program;
+
+// Slots of local variables are not negative; slots of globals are encoded below -1.
+#define NOSLOT (-1)
+#define globalSlot(index) (-2 - (index))
+#define isGlobalSlot(slot) ((slot) <= -2)
+#define globalSlotIndex(slot) (-2 - (slot))
+
+void resolveProgram(Program*);
+
+#endif // resolver_h
@@ -7,7 +7,7 @@
 //  used as a more general purpose data structure.
 //
 //  Created by Thomas Wetmore on 1 March 2023.
-//  Last changed on 17 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef sequence_h
@@ -18,7 +18,8 @@
 typedef struct GNode GNode;
 typedef struct HashTable HashTable;
 typedef HashTable RecordIndex;
-typedef HashTable NameIndex;
+typedef struct NameIndex NameIndex;
+typedef struct NameOrder NameOrder;
 typedef HashTable RefnIndex;
 typedef struct Block Block;
 typedef struct PValue PValue;
@@ -34,7 +35,7 @@ typedef enum {
 typedef struct SequenceEl {
 	GNode* root; // Root of record. MNOTE: do not free on delete.
 	String name; // If element is a person. MNOTE: do not free on delete.
-	PValue* value; // MNOTE: what do we do with this? Scenarios exists for do or not do free.
+	PValue* value; // In the heap; owned by the element; Sequences derived from it get copies.
 } SequenceEl;
 
 // Sequence is a data type that holds sequences/sets/arrays of records.
@@ -57,6 +58,7 @@ void appendSequenceToSequence(Sequence* dst, Sequence* src);
 bool isInSequence(Sequence*, String key);
 bool removeFromSequence(Sequence*, String key);
 void nameSortSequence(Sequence*);
+void nameSortSequenceWithOrder(Sequence*, NameOrder*); // Uses the collation keys of a NameOrder.
 void keySortSequence(Sequence*);
 Sequence* uniqueSequence(Sequence*);
 void uniqueSequenceInPlace(Sequence*);
@@ -5,7 +5,7 @@
 //  DeadEnds programs. Symbol tables are implented with hash tables.
 //
 //  Created by Thomas Wetmore on 23 March 2023.
-//  Last changed on 6 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef symboltable_h
@@ -29,10 +29,11 @@ typedef struct Symbol {
 //  Interface to SymbolTable.
 SymbolTable *createSymbolTable(void);
 void deleteSymbolTable(SymbolTable*);
-void assignValueToSymbol(Context*, String, PValue);
 void assignValueToSymbolTable(SymbolTable*, String, PValue);
-PValue getValueOfSymbol(Context*, String);
 PValue getValueFromSymbolTable(SymbolTable*, String);
+void assignValueToSlot(Context*, int slot, PValue);
+PValue getValueOfSlot(Context*, int slot);
+void clearLocalSlot(Context*, int slot);
 void showSymbolTable(SymbolTable*); // Debug.
 
 #endif // symboltable_h
@@ -3,13 +3,15 @@
 //  builtin.c contains many built-in functions of the DeadEnds script language.
 //
 //  Created by Thomas Wetmore on 14 December 2022.
-//  Last changed on 2 September 2025.
+//  Last changed on 19 October 2026.
 //
 
+#include "collect.h"
 #include "context.h"
 #include "database.h"
 #include "date.h"
 #include "evaluate.h"
+#include "file.h"
 #include "frame.h"
 #include "gedcom.h"
 #include "gnode.h"
@@ -185,10 +187,10 @@ PValue __set(PNode* pnode, Context* context, bool* errflg) {
     }
 	PValue value = evaluate(expr, context, errflg);
 	if (*errflg) return nullPValue;
-	assignValueToSymbol(context, iden->identifier, value);
+	assignValueToSlot(context, iden->slot, value);
     if (symbolTableDebugging) {
         printf("Symtab after set() builtin with variable %s\n", iden->identifier);
-        showSymbolTable(context->frame->table);
+        showFrame(context->frame);
     }
 	return nullPValue;
 }
@@ -379,7 +381,7 @@ PValue __concat(PNode *pnode, Context *context, bool *errflg) {
 	for (int i = 0; i < nstrs; i++) {
 		strcpy(p, hold[i]);
 		p += strlen(p);
-		stdfree(hold[i]);
+		releasePString(hold[i]);
 	}
 	*p = 0;
     PValue rvalue = createStringPValue(nstring);
@@ -418,6 +420,7 @@ PValue __print(PNode *pnode, Context *context, bool *errflg) {
         PValue svalue = evaluate(arg, context, errflg);
         if (*errflg) return nullPValue;
         if (svalue.type != PVString) continue;
+        flushStdout();
         printf("%s", svalue.value.uString);
     }
     return nullPValue;
@@ -468,16 +471,16 @@ PValue __extractdate(PNode *pnode, Context *context, bool* errflg) {
 		return nullPValue;
 	}
 	// gnode should be either a DATE node or an event node.
-    if (nestr("DATE", gnode->tag))
+    if (gnode->tagId != tagDATE)
         str = eventToDate(gnode, false);
     else
         str = gnode->value;
 	if (!str || *str == 0) return nullPValue;  // Not considered an error.
 	String stryear;
     extractDate(str, &daormo, &day, &month, &year, &stryear);
-    assignValueToSymbol(context, dvar->identifier, PVALUE(PVInt, uInt, day));
-	assignValueToSymbol(context, mvar->identifier, PVALUE(PVInt, uInt, month));
-	assignValueToSymbol(context, yvar->identifier, PVALUE(PVInt, uInt, year));
+    assignValueToSlot(context, dvar->slot, PVALUE(PVInt, uInt, day));
+	assignValueToSlot(context, mvar->slot, PVALUE(PVInt, uInt, month));
+	assignValueToSlot(context, yvar->slot, PVALUE(PVInt, uInt, year));
     *errflg = false;
     return nullPValue;
 }
@@ -492,7 +495,7 @@ PValue __extractnames (PNode *pnode, Context *context, bool *errflg) {
 	PNode *svar = lvar->next;
 	GNode *node = evaluateGNode(nexp, context, errflg); // First arg is a Gedcom node.
     if (*errflg) return nullPValue; // Error will have been reported.
-	if (nestr(node->tag, "NAME")) {
+	if (node->tagId != tagNAME) {
         node = NAME(node);
         if (!node) {
             *errflg = true;
@@ -520,8 +523,8 @@ PValue __extractnames (PNode *pnode, Context *context, bool *errflg) {
 	}
 	String str = node->value;
 	if (!str || *str == 0) { // Return an empty list.
-		assignValueToSymbol(context, lvar->identifier, PVALUE(PVInt, uInt, 0));
-		assignValueToSymbol(context, svar->identifier, PVALUE(PVInt, uInt, 0));
+		assignValueToSlot(context, lvar->slot, PVALUE(PVInt, uInt, 0));
+		assignValueToSlot(context, svar->slot, PVALUE(PVInt, uInt, 0));
 		return nullPValue;
 	}
 	int len, sind;
@@ -532,14 +535,15 @@ PValue __extractnames (PNode *pnode, Context *context, bool *errflg) {
     // Convert the Strings in the temporary parts list to PValues and append them to list.
     for (int i = 0; i < len; i++) {
         String part = (String) getListElement(parts, i);
-        PValue pvalue = PVALUE(PVString, uString, part); // Transfer String ownership.
+        PValue pvalue = createStringPValue(part);
+        stdfree(part);
         PValue* ppvalue = (PValue*) stdalloc(sizeof(PValue)); // Create PValue* in the heap.
         *ppvalue = pvalue;
         appendToList(list, ppvalue);  // Add the PValue* to the list.
     }
     deleteList(parts); // Free temporary list.
-	assignValueToSymbol(context, lvar->identifier, PVALUE(PVInt, uInt, len));
-	assignValueToSymbol(context, svar->identifier, PVALUE(PVInt, uInt, sind));
+	assignValueToSlot(context, lvar->slot, PVALUE(PVInt, uInt, len));
+	assignValueToSlot(context, svar->slot, PVALUE(PVInt, uInt, sind));
 	return nullPValue;
 }
 
@@ -555,7 +559,7 @@ PValue __extractplaces(PNode *pnode, Context *context, bool *errflg) {
     // There are a number of edge cases to handle. There may or may not be a string to process.
     String str = null;
     if (node) {
-        if (eqstr(node->tag, "PLAC")) {
+        if (node->tagId == tagPLAC) {
             str = node->value;
         } else {
             GNode* plac = PLAC(node);
@@ -580,7 +584,7 @@ PValue __extractplaces(PNode *pnode, Context *context, bool *errflg) {
         return nullPValue;
     }
     if (!str || *str == 0) { // Return an empty list.
-        assignValueToSymbol(context, cvar->identifier, PVALUE(PVInt, uInt, 0));
+        assignValueToSlot(context, cvar->slot, PVALUE(PVInt, uInt, 0));
         return nullPValue;
     }
     // Use placeToList to separate a PLAC value into list of string parts.
@@ -591,13 +595,14 @@ PValue __extractplaces(PNode *pnode, Context *context, bool *errflg) {
         String string = (String) element;
         PValue* svalue = stdalloc(sizeof(PValue));
         svalue->type = PVString;
-        svalue->value.uString = string; // Transfers memory ownership.
+        svalue->value.uString = createPString(string);
+        stdfree(string);
         appendToList(list, svalue);
     ENDLIST
     deleteList(parts); // Does not free the strings.
 
     // Assign the count to the symbol table
-    assignValueToSymbol(context, cvar->identifier, PVALUE(PVInt, uInt, lengthList(list)));
+    assignValueToSlot(context, cvar->slot, PVALUE(PVInt, uInt, lengthList(list)));
     return nullPValue;
 }
 
@@ -617,6 +622,7 @@ PValue __copyfile (PNode *pnode, Context *context, bool *errflg) {
 		return nullPValue;
 	}
 	char buffer[1024];
+	flushStdout();
 	while (fgets(buffer, 1024, cfp)) {
 		printf("%s", buffer);  // TODO: CHANGE TO A MORE POUTPUT APPROACH.
 	}
@@ -643,7 +649,7 @@ PValue __children(PNode *pnode, Context *context, bool* errflg) {
 	if (*errflg || !family) return nullPValue;
 	Sequence *children = familyToChildren(family, context->database->recordIndex);
 	if (!children) return nullPValue;
-	return PVALUE(PVSequence, uSequence, children);
+	return trackAggregate(context, PVALUE(PVSequence, uSequence, children));
 }
 
 // __version returns the version of the DeadEnds program.
@@ -723,6 +729,7 @@ PValue __addnode(PNode* pnode, Context* context, bool* errflg) {
 		prevNode->sibling = thisNode;
 	}
 	thisNode->sibling = nextNode;
+	noteDatabaseEdit(context->database);
 	return nullPValue;
 }
 
@@ -758,6 +765,7 @@ PValue __deletenode(PNode *node, Context *context, bool *errflg) {
 		prev->sibling = next;
 	this->parent = null;
 	this->sibling = null;
+	noteDatabaseEdit(context->database);
 	return nullPValue;
 }
 
@@ -838,10 +846,11 @@ PValue __extracttokens (PNode *pnode, Context *context, bool *errflg) {
         String string = (String) element;
         PValue* svalue = stdalloc(sizeof(PValue));
         svalue->type = PVString;
-        svalue->value.uString = string; // Transfer memory ownership.
+        svalue->value.uString = createPString(string);
+        stdfree(string);
         appendToList(list, svalue);
     ENDLIST
-	assignValueToSymbol(context, lvar->identifier, PVALUE(PVInt, uInt, lengthList(list)));
+	assignValueToSlot(context, lvar->slot, PVALUE(PVInt, uInt, lengthList(list)));
     deleteList(tokens);
 	return nullPValue;
 }
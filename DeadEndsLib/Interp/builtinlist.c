@@ -5,9 +5,10 @@
 //  datatype. The elements of the lists are program values.
 //
 //  Created by Thomas Wetmore on 16 April 2023.
-//  Last changed on 27 July 2025.
+//  Last changed on 19 October 2026.
 //
 
+#include "collect.h"
 #include "context.h"
 #include "frame.h"
 #include "hashtable.h"
@@ -33,11 +34,9 @@ PValue __list(PNode* pnode, Context* context, bool* errflg) {
         *errflg = true;
         return nullPValue;
     }
-    String ident = var->identifier;
-    ASSERT(ident);
     List *list = createPValueList();
-    assignValueToSymbol(context, ident, PVALUE(PVList, uList, list));
-    if (localDebugging) showSymbolTable(context->frame->table);
+    assignValueToSlot(context, var->slot, trackAggregate(context, PVALUE(PVList, uList, list)));
+    if (localDebugging) showFrame(context->frame);
     return nullPValue;
 }
 
@@ -272,11 +271,9 @@ InterpType oldinterpForList(PNode* pnode, Context* context, PValue* pval) {
 	Block* block = &(list->block);
     for (int i = 0; i < block->length; i++) {
         PValue* fromList = (PValue*) block->elements[i];
-        PValue copy = *fromList;
-        if (copy.type == PVString && copy.value.uString)
-            copy.value.uString = strsave(copy.value.uString);  // deep copy
-        assignValueToSymbol(context, pnode->elementIden, copy);
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, count++));
+        PValue copy = retainPValue(*fromList);
+        assignValueToSlot(context, pnode->elementSlot, copy);
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, count++));
         switch (irc = interpret(pnode->loopState, context, pval)) {
             case InterpContinue:
             case InterpOkay: goto i;
@@ -300,24 +297,25 @@ InterpType interpForList(PNode* pnode, Context* context, PValue* pval) {
         return InterpError;
     }
     int count = 0;
-    InterpType irc;
+    InterpType irc = InterpOkay;
     Block* block = &(list->block);
+    pushRoot(context, pvalue); // No variable need hold the List.
     for (int i = 0; i < block->length; i++) {
         PValue* fromList = (PValue*) block->elements[i];
-        PValue copy = *fromList;
-        if (copy.type == PVString && copy.value.uString)
-            copy.value.uString = strsave(copy.value.uString);  // deep copy
-        assignValueToSymbol(context, pnode->elementIden, copy);
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, count++));
+        PValue copy = retainPValue(*fromList);
+        assignValueToSlot(context, pnode->elementSlot, copy);
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, count++));
         switch (irc = interpret(pnode->loopState, context, pval)) {
             case InterpContinue:
             case InterpOkay: goto i;
-            case InterpBreak: return InterpOkay;
-            default: return irc;
+            case InterpBreak: irc = InterpOkay; goto e;
+            default: goto e;
         }
     i:  ;
     }
-    return InterpOkay;
+    irc = InterpOkay;
+e:  popRoot(context);
+    return irc;
 }
 
 
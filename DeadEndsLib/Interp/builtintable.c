@@ -5,9 +5,10 @@
 //  language. It is implemented using PValueTable.
 //
 //  Created by Thomas Wetmore on 19 April 2023.
-//  Last changed on 3 June 2025.
+//  Last changed on 19 October 2026.
 //
 
+#include "collect.h"
 #include "context.h"
 #include "interp.h"
 #include "symboltable.h"
@@ -25,7 +26,7 @@ PValue __table(PNode* pnode, Context* context, bool* errflg) {
         return nullPValue;
     }
     PValueTable *pvtable = createPValueTable();
-    assignValueToSymbol(context, var->identifier, PVALUE(PVTable, uTable, pvtable));
+    assignValueToSlot(context, var->slot, trackAggregate(context, PVALUE(PVTable, uTable, pvtable)));
     return nullPValue;
 }
 
@@ -0,0 +1,175 @@
+//
+//  DeadEnds Library
+//
+//  collect.c has the collector of the Lists, Tables and Sequences created by scripts. These
+//  Aggregates are shared by the variables and values that hold them, and are never copied, so
+//  they can't be freed when a variable is assigned. Instead the Context keeps track of them.
+//  collectAggregates marks the Aggregates that can be reached from the globals, the Frames on
+//  the run time stack and the roots, and frees the others. It is called between statements once
+//  the number of Aggregates has doubled since the last collection. The loop statements push the
+//  Aggregates they iterate as roots. Builtins hold the values of their arguments in C variables,
+//  so nothing is collected while a user function called from an expression runs. The Aggregates
+//  left are freed with the Context.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include <stdint.h>
+#include "collect.h"
+#include "context.h"
+#include "frame.h"
+#include "hashtable.h"
+#include "list.h"
+#include "pnode.h"
+#include "pvaluelist.h"
+#include "pvaluetable.h"
+#include "sequence.h"
+#include "standard.h"
+
+static bool debugging = false;
+static int minCollection = 256; // Fewest Aggregates that are worth a collection.
+
+// createAggregates creates the Aggregates of a Context.
+Aggregates* createAggregates(void) {
+	Aggregates* aggregates = (Aggregates*) stdalloc(sizeof(Aggregates));
+	*aggregates = (Aggregates) { null, 0, 0, 0, minCollection, 0, null, 0, 0 };
+	return aggregates;
+}
+
+// trackAggregate adds the List, Table or Sequence of a PValue to the Aggregates of a Context.
+PValue trackAggregate(Context* context, PValue pvalue) {
+	Aggregates* aggregates = context->aggregates;
+	if (!pvalue.value.uWord) return pvalue;
+	if (aggregates->length >= aggregates->maxLength) {
+		aggregates->maxLength = aggregates->maxLength ? 2*aggregates->maxLength : 64;
+		Aggregate* elements = (Aggregate*) stdalloc(aggregates->maxLength*sizeof(Aggregate));
+		if (aggregates->elements) {
+			memcpy(elements, aggregates->elements, aggregates->length*sizeof(Aggregate));
+			stdfree(aggregates->elements);
+		}
+		aggregates->elements = elements;
+	}
+	aggregates->elements[aggregates->length++] = (Aggregate) { pvalue.type, pvalue.value.uWord, false };
+	return pvalue;
+}
+
+// pushRoot keeps the Aggregate of a value, and those it holds, from being collected until the
+// matching popRoot. Used by the loop statements for the Lists and Sequences they iterate.
+void pushRoot(Context* context, PValue pvalue) {
+	Aggregates* aggregates = context->aggregates;
+	if (aggregates->numRoots >= aggregates->maxRoots) {
+		aggregates->maxRoots = aggregates->maxRoots ? 2*aggregates->maxRoots : 16;
+		PValue* roots = (PValue*) stdalloc(aggregates->maxRoots*sizeof(PValue));
+		if (aggregates->roots) {
+			memcpy(roots, aggregates->roots, aggregates->numRoots*sizeof(PValue));
+			stdfree(aggregates->roots);
+		}
+		aggregates->roots = roots;
+	}
+	aggregates->roots[aggregates->numRoots++] = pvalue;
+}
+
+// popRoot removes the last root pushed.
+void popRoot(Context* context) {
+	ASSERT(context->aggregates->numRoots > 0);
+	context->aggregates->numRoots--;
+}
+
+// compareAddresses compares two Aggregates by the addresses of their values.
+static int compareAddresses(const void* a, const void* b) {
+	uintptr_t one = (uintptr_t) ((Aggregate*) a)->value;
+	uintptr_t two = (uintptr_t) ((Aggregate*) b)->value;
+	return one < two ? -1 : one > two;
+}
+
+// findAggregate returns the Aggregate of a value; null if the value is not tracked.
+static Aggregate* findAggregate(Aggregates* aggregates, void* value) {
+	Aggregate key = { PVNull, value, false };
+	return (Aggregate*) bsearch(&key, aggregates->elements, aggregates->length, sizeof(Aggregate),
+								compareAddresses);
+}
+
+// markPValue marks the Aggregate of a PValue and the Aggregates it holds.
+static void markPValue(Aggregates* aggregates, PValue pvalue) {
+	if (pvalue.type != PVList && pvalue.type != PVTable && pvalue.type != PVSequence) return;
+	if (!pvalue.value.uWord) return;
+	Aggregate* aggregate = findAggregate(aggregates, pvalue.value.uWord);
+	if (!aggregate || aggregate->marked) return;
+	aggregate->marked = true;
+	switch (pvalue.type) {
+	case PVList:
+		FORLIST(pvalue.value.uList, element)
+			if (element) markPValue(aggregates, *((PValue*) element));
+		ENDLIST
+		break;
+	case PVTable:
+		FORHASHTABLE(pvalue.value.uTable, element)
+			PValueElement* pelement = (PValueElement*) element;
+			if (pelement->value) markPValue(aggregates, *(pelement->value));
+		ENDHASHTABLE
+		break;
+	case PVSequence:
+		FORSEQUENCE(pvalue.value.uSequence, element, count)
+			if (element->value) markPValue(aggregates, *(element->value));
+		ENDSEQUENCE
+		break;
+	default:
+		break;
+	}
+}
+
+// freeAggregate frees the List, Table or Sequence of an Aggregate.
+static void freeAggregate(Aggregate* aggregate) {
+	switch (aggregate->type) {
+	case PVList: deletePValueList(aggregate->value); break;
+	case PVTable: deleteHashTable(aggregate->value); break;
+	case PVSequence: deleteSequence(aggregate->value); break;
+	default: break;
+	}
+}
+
+// sortAggregates sorts Aggregates by address and removes any tracked twice.
+static void sortAggregates(Aggregates* aggregates) {
+	if (aggregates->length == 0) return; // elements may be null; qsort must not see it.
+	qsort(aggregates->elements, aggregates->length, sizeof(Aggregate), compareAddresses);
+	int length = 0;
+	for (int i = 0; i < aggregates->length; i++) {
+		if (length && aggregates->elements[length - 1].value == aggregates->elements[i].value)
+			continue;
+		aggregates->elements[length++] = aggregates->elements[i];
+	}
+	aggregates->length = aggregates->numSorted = length;
+}
+
+// collectAggregates frees the Aggregates that can't be reached from the variables of a Context.
+void collectAggregates(Context* context) {
+	Aggregates* aggregates = context->aggregates;
+	if (!aggregates->length) return;
+	if (aggregates->numSorted < aggregates->length) sortAggregates(aggregates);
+	for (int i = 0; i < aggregates->length; i++) aggregates->elements[i].marked = false;
+	// Mark the Aggregates reachable from the globals, the Frames and the roots.
+	for (int i = 0; i < context->numGlobals; i++) markPValue(aggregates, context->globals[i]);
+	for (Frame* frame = context->frame; frame; frame = frame->caller) {
+		for (int i = 0; i < frame->defn->numSlots; i++) markPValue(aggregates, frame->slots[i]);
+	}
+	for (int i = 0; i < aggregates->numRoots; i++) markPValue(aggregates, aggregates->roots[i]);
+	// Free the unmarked Aggregates and keep the others in order.
+	int numKept = 0;
+	for (int i = 0; i < aggregates->length; i++) {
+		if (aggregates->elements[i].marked) aggregates->elements[numKept++] = aggregates->elements[i];
+		else freeAggregate(&(aggregates->elements[i]));
+	}
+	if (debugging) printf("collectAggregates: kept %d of %d.\n", numKept, aggregates->length);
+	aggregates->length = aggregates->numSorted = numKept;
+	aggregates->nextCollection = max(minCollection, 2*numKept);
+}
+
+// freeAggregates frees all the Aggregates of a Context. Called when the Context is deleted.
+void freeAggregates(Aggregates* aggregates) {
+	sortAggregates(aggregates);
+	for (int i = 0; i < aggregates->length; i++) freeAggregate(&(aggregates->elements[i]));
+	if (aggregates->elements) stdfree(aggregates->elements);
+	if (aggregates->roots) stdfree(aggregates->roots);
+	stdfree(aggregates);
+}
@@ -0,0 +1,468 @@
+//
+//  DeadEnds Library
+//
+//  compile.c has the bytecode compiler, an optional pass run after the resolver. It compiles the
+//  body of each procedure and function into a Code, the instructions of the virtual machine in
+//  vm.c, which runRoutine runs in place of the PNode tree.
+//
+//  Expressions are compiled to instructions that push their values on the machine's stack.
+//  The builtins the scripts call most, such as set, add, eq, lt, and, not, d and nl, get their
+//  own instructions whose arguments are evaluated before them. Other builtins are called with
+//  their PNodes and evaluate their own arguments. The loops over children, spouses, families,
+//  parents, records, sets, lists, notes, nodes and traversals get their own instructions that
+//  keep their state between iterations. Everything is compiled to do what the tree walker does,
+//  including how the builtins set and test their error flag, so a Program writes the same output
+//  and the same error messages whether or not it is compiled. Programs are compiled after they
+//  are linked, so each call has a routine with a parameter for each argument.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "compile.h"
+#include "context.h"
+#include "functiontable.h"
+#include "hashtable.h"
+#include "interp.h"
+#include "pnode.h"
+#include "pvalue.h"
+#include "standard.h"
+
+static bool debugging = false;
+bool compiling = false;
+
+// Builtins that are compiled to their own instructions.
+extern PValue __add(PNode*, Context*, bool*);
+extern PValue __and(PNode*, Context*, bool*);
+extern PValue __d(PNode*, Context*, bool*);
+extern PValue __decr(PNode*, Context*, bool*);
+extern PValue __div(PNode*, Context*, bool*);
+extern PValue __eq(PNode*, Context*, bool*);
+extern PValue __ge(PNode*, Context*, bool*);
+extern PValue __gt(PNode*, Context*, bool*);
+extern PValue __incr(PNode*, Context*, bool*);
+extern PValue __le(PNode*, Context*, bool*);
+extern PValue __lt(PNode*, Context*, bool*);
+extern PValue __mod(PNode*, Context*, bool*);
+extern PValue __mul(PNode*, Context*, bool*);
+extern PValue __ne(PNode*, Context*, bool*);
+extern PValue __neg(PNode*, Context*, bool*);
+extern PValue __nl(PNode*, Context*, bool*);
+extern PValue __not(PNode*, Context*, bool*);
+extern PValue __or(PNode*, Context*, bool*);
+extern PValue __set(PNode*, Context*, bool*);
+extern PValue __space(PNode*, Context*, bool*);
+extern PValue __sub(PNode*, Context*, bool*);
+
+// NativeBuiltin is a builtin compiled to its own instructions.
+typedef struct NativeBuiltin {
+	BIFunc func;
+	OpCode op;
+	int numArgs; // -1 if one or more.
+} NativeBuiltin;
+
+static NativeBuiltin nativeBuiltins[] = {
+	{__add, OpAdd, -1}, {__and, OpAnd, -1}, {__d, OpDecimal, 1}, {__div, OpDiv, 2},
+	{__eq, OpEq, 2}, {__ge, OpGe, 2}, {__gt, OpGt, 2}, {__le, OpLe, 2}, {__lt, OpLt, 2},
+	{__mod, OpMod, 2}, {__mul, OpMul, -1}, {__ne, OpNe, 2}, {__neg, OpNeg, 1},
+	{__nl, OpNewline, 0}, {__not, OpNot, 1}, {__or, OpOr, -1}, {__space, OpSpace, 0},
+	{__sub, OpSub, 2}
+};
+static int numNativeBuiltins = sizeof(nativeBuiltins)/sizeof(nativeBuiltins[0]);
+
+// LoopInfo is what the compiler knows about a loop while it compiles the loop's body.
+typedef struct LoopInfo {
+	PNode* pnode;
+	int top;            // Label continue jumps to.
+	int end;            // Label break jumps to.
+	int endOp;          // Instruction that ends the loop; -1 if none.
+	int state;          // Loop state of the loop's instructions.
+	bool endsOnReturn;  // The record loops end on a return and go on after the loop.
+} LoopInfo;
+
+// Compiler holds the state of the compiler while it compiles a procedure or function.
+typedef struct Compiler {
+	Code* code;
+	int* labels;        // Instruction each label is at.
+	int numLabels;
+	int maxLabels;
+	int* jumps;         // Instructions whose b is a label.
+	int numJumps;
+	int maxJumps;
+	LoopInfo* loops;    // Loops around the statement being compiled.
+	int numLoops;
+	int maxLoops;
+	int numTraverses;   // Traverse loops around the statement being compiled.
+	int depth;          // Values on the stack.
+} Compiler;
+
+static void compileExpression(Compiler*, PNode*);
+static void compileStatement(Compiler*, PNode*);
+static void compileStatements(Compiler*, PNode*);
+
+// growArray makes room for one more element in an array.
+static void* growArray(void* array, int length, int* maxLength, size_t size) {
+	if (length < *maxLength) return array;
+	*maxLength = *maxLength ? 2*(*maxLength) : 16;
+	void* grown = stdalloc(*maxLength*size);
+	if (array) {
+		memcpy(grown, array, length*size);
+		stdfree(array);
+	}
+	return grown;
+}
+
+// stackEffect returns the change an instruction makes to the number of values on the stack
+// when it doesn't jump.
+static int stackEffect(OpCode op, int a) {
+	switch (op) {
+	case OpInt: case OpFloat: case OpString: case OpSlot: case OpNewline: case OpSpace:
+	case OpTrue: case OpFalse: case OpAccumulate: case OpBuiltin: case OpEvaluate:
+		return 1;
+	case OpCall: return 1 - a;
+	case OpFunctionStatement: case OpProcedure: return -a;
+	case OpAdd: case OpMul: case OpSub: case OpDiv: case OpMod:
+	case OpEq: case OpNe: case OpLt: case OpLe: case OpGt: case OpGe:
+	case OpAnd: case OpOr:
+	case OpOutputValue: case OpSet: case OpCondition: case OpConditionSet: case OpReturnValue:
+	case OpChildren: case OpSpouses: case OpFamilies: case OpFathers: case OpMothers:
+	case OpParents: case OpNotes: case OpNodes: case OpSequence: case OpList: case OpTraverse:
+		return -1;
+	default:
+		return 0;
+	}
+}
+
+// emit adds an instruction to the Code being compiled.
+static void emit(Compiler* compiler, OpCode op, int a, int b, PNode* pnode) {
+	Code* code = compiler->code;
+	code->instructions = growArray(code->instructions, code->length, &code->maxLength,
+								   sizeof(Instruction));
+	code->instructions[code->length++] = (Instruction){ op, a, b, pnode };
+	compiler->depth += stackEffect(op, a);
+	if (compiler->depth > code->maxStack) code->maxStack = compiler->depth;
+}
+
+// emitJump adds an instruction whose b is a label.
+static void emitJump(Compiler* compiler, OpCode op, int a, int label, PNode* pnode) {
+	compiler->jumps = growArray(compiler->jumps, compiler->numJumps, &compiler->maxJumps,
+								sizeof(int));
+	compiler->jumps[compiler->numJumps++] = compiler->code->length;
+	emit(compiler, op, a, label, pnode);
+}
+
+// newLabel returns a label to be placed at an instruction later.
+static int newLabel(Compiler* compiler) {
+	compiler->labels = growArray(compiler->labels, compiler->numLabels, &compiler->maxLabels,
+								 sizeof(int));
+	compiler->labels[compiler->numLabels] = -1;
+	return compiler->numLabels++;
+}
+
+// placeLabel places a label at the next instruction.
+static void placeLabel(Compiler* compiler, int label) {
+	compiler->labels[label] = compiler->code->length;
+}
+
+// findNative returns the NativeBuiltin of a builtin call; null if the builtin isn't native or
+// the call has the wrong number of arguments.
+static NativeBuiltin* findNative(PNode* pnode) {
+	int numArgs = 0;
+	for (PNode* arg = pnode->arguments; arg; arg = arg->next) numArgs++;
+	for (int i = 0; i < numNativeBuiltins; i++) {
+		NativeBuiltin* native = &nativeBuiltins[i];
+		if (native->func != pnode->builtinFunc) continue;
+		if (native->numArgs < 0 ? numArgs < 1 : numArgs != native->numArgs) return null;
+		return native;
+	}
+	return null;
+}
+
+// compileBuiltin compiles a builtin call in an expression.
+static void compileBuiltin(Compiler* compiler, PNode* pnode) {
+	NativeBuiltin* native = findNative(pnode);
+	if (!native) {
+		emit(compiler, OpBuiltin, 0, -1, pnode);
+		return;
+	}
+	PNode* arg = pnode->arguments;
+	int end;
+	switch (native->op) {
+	case OpNewline:
+	case OpSpace:
+		emit(compiler, native->op, 0, -1, pnode);
+		break;
+	case OpAdd:
+	case OpMul: // Each argument is added or multiplied into the value below it.
+		end = newLabel(compiler);
+		emit(compiler, OpAccumulate, native->op == OpAdd ? 0 : 1, -1, pnode);
+		for (; arg; arg = arg->next) {
+			compileExpression(compiler, arg);
+			emitJump(compiler, native->op, 0, end, pnode);
+		}
+		placeLabel(compiler, end);
+		break;
+	case OpAnd:
+	case OpOr: // Each argument may decide the value.
+		end = newLabel(compiler);
+		for (; arg; arg = arg->next) {
+			compileExpression(compiler, arg);
+			emitJump(compiler, native->op, 0, end, pnode);
+		}
+		emit(compiler, native->op == OpAnd ? OpTrue : OpFalse, 0, -1, pnode);
+		placeLabel(compiler, end);
+		break;
+	case OpEq:
+	case OpNe: // The second argument isn't evaluated if the first fails.
+		end = newLabel(compiler);
+		compileExpression(compiler, arg);
+		emitJump(compiler, OpBail, 1, end, pnode);
+		compileExpression(compiler, arg->next);
+		emit(compiler, native->op, 0, -1, pnode);
+		placeLabel(compiler, end);
+		break;
+	default: // The arguments are evaluated before the instruction.
+		for (; arg; arg = arg->next) compileExpression(compiler, arg);
+		emit(compiler, native->op, 0, -1, pnode);
+		break;
+	}
+}
+
+// compileArguments compiles the arguments of a procedure or function call. An argument that
+// fails is reported and ends the statement, or with a function called in an expression, leaves
+// null as the value of the call. Constant arguments can't fail.
+static int compileArguments(Compiler* compiler, PNode* pnode, int label) {
+	int numArgs = 0;
+	for (PNode* arg = pnode->arguments; arg; arg = arg->next) {
+		compileExpression(compiler, arg);
+		numArgs++;
+		if (arg->type == PNICons || arg->type == PNFCons || arg->type == PNSCons) continue;
+		if (label < 0) emit(compiler, OpCheckArgument, numArgs, -1, pnode);
+		else emitJump(compiler, OpCheckArgument, numArgs, label, pnode);
+	}
+	return numArgs;
+}
+
+// compileExpression compiles an expression to instructions that push its value.
+static void compileExpression(Compiler* compiler, PNode* pnode) {
+	switch (pnode->type) {
+	case PNICons: emit(compiler, OpInt, 0, -1, pnode); break;
+	case PNFCons: emit(compiler, OpFloat, 0, -1, pnode); break;
+	case PNSCons: emit(compiler, OpString, 0, -1, pnode); break;
+	case PNIdent: emit(compiler, OpSlot, pnode->slot, -1, pnode); break;
+	case PNBltinCall: compileBuiltin(compiler, pnode); break;
+	case PNFuncCall: {
+		int end = newLabel(compiler);
+		emit(compiler, OpCall, compileArguments(compiler, pnode, end), -1, pnode);
+		placeLabel(compiler, end);
+		break;
+	}
+	default: // Statements used as expressions fail as they do in evaluate.
+		emit(compiler, OpEvaluate, 0, -1, pnode);
+		break;
+	}
+}
+
+// compileCondition compiles the condition of an if or while statement, jumping to a label when
+// it is false.
+static void compileCondition(Compiler* compiler, PNode* cond, int label) {
+	PNode* expr = cond->next;
+	if (!expr) {
+		compileExpression(compiler, cond);
+		emitJump(compiler, OpCondition, 0, label, cond);
+	} else if (cond->type != PNIdent) {
+		emit(compiler, OpConditionError, 0, -1, cond);
+	} else {
+		compileExpression(compiler, expr);
+		emitJump(compiler, OpConditionSet, cond->slot, label, cond);
+	}
+}
+
+// pushLoop adds a loop to the loops around the statements being compiled.
+static LoopInfo* pushLoop(Compiler* compiler, PNode* pnode, int endOp, bool endsOnReturn) {
+	compiler->loops = growArray(compiler->loops, compiler->numLoops, &compiler->maxLoops,
+								sizeof(LoopInfo));
+	LoopInfo* loop = &compiler->loops[compiler->numLoops];
+	*loop = (LoopInfo){ pnode, newLabel(compiler), newLabel(compiler), endOp,
+						compiler->numLoops, endsOnReturn };
+	compiler->numLoops++;
+	if (compiler->numLoops > compiler->code->numLoops) compiler->code->numLoops = compiler->numLoops;
+	return loop;
+}
+
+// compileLoop compiles a loop whose first instruction sets up the loop's state and whose second
+// starts each iteration or jumps to the end. The loops with a first expression pop its value.
+static void compileLoop(Compiler* compiler, PNode* pnode, OpCode first, OpCode next, int endOp,
+						bool endsOnReturn) {
+	int stack = -1;
+	if (first == OpTraverse) {
+		stack = compiler->numTraverses++;
+		if (compiler->numTraverses > compiler->code->numTraverses)
+			compiler->code->numTraverses = compiler->numTraverses;
+	}
+	if (first != OpRecords) compileExpression(compiler, pnode->expression);
+	LoopInfo loop = *pushLoop(compiler, pnode, endOp, endsOnReturn);
+	if (first == OpTraverse) emit(compiler, first, loop.state, stack, pnode);
+	else emitJump(compiler, first, loop.state, loop.end, pnode);
+	placeLabel(compiler, loop.top);
+	emitJump(compiler, next, loop.state, loop.end, pnode);
+	compileStatements(compiler, pnode->loopState);
+	emitJump(compiler, OpLoop, 0, loop.top, pnode);
+	placeLabel(compiler, loop.end);
+	if (endOp >= 0) emit(compiler, endOp, loop.state, -1, pnode);
+	compiler->numLoops--;
+	if (first == OpTraverse) compiler->numTraverses--;
+}
+
+// compileReturn compiles a return statement. The loops it leaves are ended; a record loop
+// ends the return, and the statements after the loop run, as in the tree walker.
+static void compileReturn(Compiler* compiler, PNode* pnode) {
+	if (pnode->returnExpr) {
+		compileExpression(compiler, pnode->returnExpr);
+		emit(compiler, OpReturnValue, 0, -1, pnode);
+	}
+	for (int i = compiler->numLoops - 1; i >= 0; i--) {
+		LoopInfo* loop = &compiler->loops[i];
+		if (loop->endsOnReturn) {
+			emitJump(compiler, OpJump, 0, loop->end, pnode);
+			return;
+		}
+		if (loop->endOp >= 0) emit(compiler, loop->endOp, loop->state, -1, loop->pnode);
+	}
+	emit(compiler, OpReturn, 0, -1, pnode);
+}
+
+// compileBuiltinStatement compiles a builtin call used as a statement.
+static void compileBuiltinStatement(Compiler* compiler, PNode* pnode) {
+	BIFunc func = pnode->builtinFunc;
+	PNode* arg = pnode->arguments;
+	if (func == __set && arg && arg->type == PNIdent && arg->next) {
+		compileExpression(compiler, arg->next);
+		emit(compiler, OpSet, arg->slot, -1, pnode);
+	} else if ((func == __incr || func == __decr) && arg && arg->type == PNIdent) {
+		emit(compiler, func == __incr ? OpIncr : OpDecr, arg->slot, -1, pnode);
+	} else if (findNative(pnode)) {
+		compileBuiltin(compiler, pnode);
+		emit(compiler, OpOutputValue, 0, -1, pnode);
+	} else {
+		emit(compiler, OpBuiltinStatement, 0, -1, pnode);
+	}
+}
+
+// compileStatements compiles a list of statements.
+static void compileStatements(Compiler* compiler, PNode* pnode) {
+	for (; pnode; pnode = pnode->next) compileStatement(compiler, pnode);
+}
+
+// compileStatement compiles a statement.
+static void compileStatement(Compiler* compiler, PNode* pnode) {
+	switch (pnode->type) {
+	case PNSCons: emit(compiler, OpOutput, 0, -1, pnode); break;
+	case PNICons:
+	case PNFCons: break;
+	case PNIdent: emit(compiler, OpOutputSlot, pnode->slot, -1, pnode); break;
+	case PNBltinCall: compileBuiltinStatement(compiler, pnode); break;
+	case PNProcCall:
+		emit(compiler, OpProcedure, compileArguments(compiler, pnode, -1), -1, pnode);
+		break;
+	case PNFuncCall:
+		emit(compiler, OpFunctionStatement, compileArguments(compiler, pnode, -1), -1, pnode);
+		break;
+	case PNIf: {
+		int other = newLabel(compiler), end = newLabel(compiler);
+		compileCondition(compiler, pnode->condExpr, other);
+		compileStatements(compiler, pnode->thenState);
+		if (pnode->elseState) emitJump(compiler, OpJump, 0, end, pnode);
+		placeLabel(compiler, other);
+		compileStatements(compiler, pnode->elseState);
+		placeLabel(compiler, end);
+		break;
+	}
+	case PNWhile: {
+		LoopInfo loop = *pushLoop(compiler, pnode, -1, false);
+		placeLabel(compiler, loop.top);
+		compileCondition(compiler, pnode->condExpr, loop.end);
+		compileStatements(compiler, pnode->loopState);
+		emitJump(compiler, OpLoop, 0, loop.top, pnode);
+		placeLabel(compiler, loop.end);
+		compiler->numLoops--;
+		break;
+	}
+	case PNBreak:
+		if (compiler->numLoops)
+			emitJump(compiler, OpJump, 0, compiler->loops[compiler->numLoops - 1].end, pnode);
+		else emit(compiler, OpBreak, 0, -1, pnode);
+		break;
+	case PNContinue:
+		if (compiler->numLoops)
+			emitJump(compiler, OpLoop, 0, compiler->loops[compiler->numLoops - 1].top, pnode);
+		else emit(compiler, OpContinue, 0, -1, pnode);
+		break;
+	case PNReturn: compileReturn(compiler, pnode); break;
+	case PNChildren: compileLoop(compiler, pnode, OpChildren, OpNextChild, -1, false); break;
+	case PNSpouses: compileLoop(compiler, pnode, OpSpouses, OpNextSpouse, -1, false); break;
+	case PNFamilies: compileLoop(compiler, pnode, OpFamilies, OpNextFamily, -1, false); break;
+	case PNFathers: compileLoop(compiler, pnode, OpFathers, OpNextFather, -1, false); break;
+	case PNMothers: compileLoop(compiler, pnode, OpMothers, OpNextMother, -1, false); break;
+	case PNFamsAsChild: compileLoop(compiler, pnode, OpParents, OpNextParent, -1, false); break;
+	case PNNotes: compileLoop(compiler, pnode, OpNotes, OpNextNote, OpEndNotes, false); break;
+	case PNNodes: compileLoop(compiler, pnode, OpNodes, OpNextNode, -1, false); break;
+	case PNIndis:
+	case PNFams:
+	case PNSources:
+	case PNEvents:
+	case PNOthers:
+		compileLoop(compiler, pnode, OpRecords, OpNextRecord, OpEndRecords, true);
+		break;
+	case PNSequence:
+		compileLoop(compiler, pnode, OpSequence, OpNextElement, OpEndSequence, false);
+		break;
+	case PNList: compileLoop(compiler, pnode, OpList, OpNextItem, OpEndList, false); break;
+	case PNTraverse:
+		compileLoop(compiler, pnode, OpTraverse, OpNextTraverse, OpEndTraverse, false);
+		break;
+	default: // Definitions and tables can't be interpreted.
+		emit(compiler, OpFatal, 0, -1, pnode);
+		break;
+	}
+}
+
+// compileRoutine compiles the body of a procedure or function into its Code.
+static void compileRoutine(PNode* defn) {
+	if (defn->code) return;
+	Compiler compiler = {};
+	compiler.code = (Code*) stdalloc(sizeof(Code));
+	memset(compiler.code, 0, sizeof(Code));
+	compileStatements(&compiler, defn->procBody);
+	emit(&compiler, OpEnd, 0, -1, defn);
+	Code* code = compiler.code;
+	for (int i = 0; i < compiler.numJumps; i++) { // Replace labels with instructions.
+		Instruction* instruction = &code->instructions[compiler.jumps[i]];
+		instruction->b = compiler.labels[instruction->b];
+		ASSERT(instruction->b >= 0);
+	}
+	if (debugging) printf("compileRoutine: %s: %d instructions, %d stack, %d loops.\n",
+						  defn->procName, code->length, code->maxStack, code->numLoops);
+	stdfree(compiler.labels);
+	stdfree(compiler.jumps);
+	stdfree(compiler.loops);
+	defn->code = code;
+}
+
+// compileProgram compiles the procedures and functions of a Program.
+void compileProgram(Program* program) {
+	if (!compiling) return;
+	FORHASHTABLE(program->procedures, element)
+		compileRoutine(((FunctionElement*) element)->function);
+	ENDHASHTABLE
+	FORHASHTABLE(program->functions, element)
+		compileRoutine(((FunctionElement*) element)->function);
+	ENDHASHTABLE
+}
+
+// deleteCode frees a Code.
+void deleteCode(Code* code) {
+	if (!code) return;
+	stdfree(code->instructions);
+	stdfree(code);
+}
@@ -3,10 +3,11 @@
 //  context.c
 //
 //  Created by Thomas Wetmore on 21 May 2025.
-//  Last changed on 13 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include <stdio.h>
+#include "collect.h"
 #include "context.h"
 #include "frame.h"
 #include "file.h"
@@ -39,82 +40,92 @@ Context* createContext(Program* program, Database* database, File* outfile) {
     context->database = database;
     context->file = outfile;
     context->frame = null;
-    context->globals = createSymbolTable();
-    FORLIST(program->globalIdents, ident)
-        assignValueToSymbolTable(context->globals, (String) ident, nullPValue);
-    ENDLIST
+    context->freeFrames = null;
+    context->aggregates = createAggregates();
+    context->numGlobals = lengthList(program->globalIdents);
+    context->globals = (PValue*) stdalloc(max(context->numGlobals, 1)*sizeof(PValue));
+    for (int i = 0; i < context->numGlobals; i++) context->globals[i] = nullPValue;
     return context;
 }
 
 /// Deletes a Context structure.
 void deleteContext(Context *context) {
-    deleteSymbolTable(context->globals);
+    for (int i = 0; i < context->numGlobals; i++) clearPValue(&(context->globals[i]));
+    stdfree(context->globals);
+    freeFrames(context->freeFrames);
+    freeAggregates(context->aggregates);
     if (context->file) closeFile(context->file);
     stdfree(context);
 }
 
-static void validatePNodeCalls(PNode*, FunctionTable*, FunctionTable*);
+static int linkPNodes(PNode*, Program*);
 static bool isBuiltinFunction(const char* name);
 
-/// Checks that functions and procedures called by a program are defined.
-void validateCalls(FunctionTable* procedures, FunctionTable* functions) {
-    ASSERT(procedures && functions);
-    FORHASHTABLE(procedures, entry) // Check procedures.
+/// Links the calls in a Program to the procedures and functions they call, and reports calls
+/// to undefined routines and calls with the wrong number of arguments. Called after parsing.
+/// Returns the number of errors reported.
+int linkProgram(Program* program) {
+    ASSERT(program && program->procedures && program->functions);
+    FORHASHTABLE(program->procedures, entry) // Count parameters first; the calls check them.
         PNode* proc = ((FunctionElement*) entry)->function;
-        validatePNodeCalls(proc->procBody, procedures, functions);
+        for (PNode* param = proc->parameters; param; param = param->next) proc->numParams++;
     ENDHASHTABLE
-    FORHASHTABLE(functions, entry) // Check functions.
+    FORHASHTABLE(program->functions, entry)
         PNode* func = ((FunctionElement*) entry)->function;
-        validatePNodeCalls(func->funcBody, procedures, functions);
+        for (PNode* param = func->parameters; param; param = param->next) func->numParams++;
     ENDHASHTABLE
+    int errors = 0;
+    FORHASHTABLE(program->procedures, entry) // Link procedures.
+        errors += linkPNodes(((FunctionElement*) entry)->function->procBody, program);
+    ENDHASHTABLE
+    FORHASHTABLE(program->functions, entry) // Link functions.
+        errors += linkPNodes(((FunctionElement*) entry)->function->funcBody, program);
+    ENDHASHTABLE
+    return errors;
+}
+
+/// Links a PNProcCall or PNFuncCall PNode to its definition. Returns the number of errors.
+static int linkCall(PNode* node, PNode* routine) {
+    for (PNode* arg = node->arguments; arg; arg = arg->next) node->numArgs++;
+    node->routine = routine;
+    if (routine && node->numArgs != routine->numParams) {
+        scriptError(node, "different numbers of arguments and parameters to %s", node->procName);
+        return 1;
+    }
+    return 0;
 }
 
-/// Checks that PNProcCall and PNFuncCall PNodes call defined procedures and functions.
-static void validatePNodeCalls(PNode* node, FunctionTable* procedures, FunctionTable* functions) {
-    while (node) {
+/// Links the calls in a list of PNodes and the PNodes below them. Returns the number of errors.
+static int linkPNodes(PNode* node, Program* program) {
+    int errors = 0;
+    for (; node; node = node->next) {
         switch (node->type) {
         case PNProcCall: {
-            String name = node->procName;
-            if (!searchHashTable(procedures, name)) {
-                scriptError(node, "undefined procedure: %s", name);
+            PNode* proc = searchFunctionTable(program->procedures, node->procName);
+            if (!proc) {
+                scriptError(node, "undefined procedure: %s", node->procName);
+                errors++;
             }
+            errors += linkCall(node, proc);
             break;
         }
         case PNFuncCall: {
-            String name = node->funcName;
-            if (!searchHashTable(functions, name) &&
-                !isBuiltinFunction(name)) {
-                scriptError(node, "undefined function: %s", name);
+            PNode* func = searchFunctionTable(program->functions, node->funcName);
+            if (!func && !isBuiltinFunction(node->funcName)) {
+                scriptError(node, "undefined function: %s", node->funcName);
+                errors++;
             }
+            errors += linkCall(node, func);
             break;
         }
-        case PNBltinCall: break;
-        case PNIf:
-            validatePNodeCalls(node->condExpr, procedures, functions);
-            validatePNodeCalls(node->thenState, procedures, functions);
-            validatePNodeCalls(node->elseState, procedures, functions);
-            break;
-        case PNWhile:
-            validatePNodeCalls(node->condExpr, procedures, functions);
-            validatePNodeCalls(node->loopState, procedures, functions);
-            break;
-        case PNReturn:
-            validatePNodeCalls(node->returnExpr, procedures, functions);
-            break;
         default:
-            // Loops and blocks
-            validatePNodeCalls(node->condExpr, procedures, functions);
-            validatePNodeCalls(node->expression, procedures, functions);
-            validatePNodeCalls(node->gnodeExpr, procedures, functions);
-            validatePNodeCalls(node->listExpr, procedures, functions);
-            validatePNodeCalls(node->setExpr, procedures, functions);
-            validatePNodeCalls(node->sequenceExpr, procedures, functions);
-            validatePNodeCalls(node->pnodeOne, procedures, functions);
-            validatePNodeCalls(node->pnodeTwo, procedures, functions);
             break;
         }
-        node = node->next;
+        errors += linkPNodes(node->expression, program);
+        errors += linkPNodes(node->pnodeOne, program);
+        errors += linkPNodes(node->pnodeTwo, program); // Includes the arguments of calls.
     }
+    return errors;
 }
 
 static bool isBuiltinFunction(const char* name) {
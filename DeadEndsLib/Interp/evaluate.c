@@ -9,9 +9,10 @@
 //  identifiers to PValue pointers.
 
 //  Created by Thomas Wetmore on 15 December 2022.
-//  Last changed on 16 August 2025.
+//  Last changed on 19 October 2026.
 //
 
+#include "collect.h"
 #include "evaluate.h"
 #include "frame.h"
 #include "gnode.h"
@@ -21,6 +22,7 @@
 #include "interp.h"
 #include "pvalue.h"
 #include "pnode.h"
+#include "profile.h"
 #include "utils.h"
 #include "context.h"
 
@@ -32,7 +34,6 @@ extern FunctionTable *functions;
 extern bool traceprogram;
 extern bool programDebugging;
 extern const PValue nullPValue;
-static bool pvalueToBoolean(PValue pvalue);
 
 // evaluate is the generic evaluator. It evaluates a PNode expression into a PValue. Evaluation
 // begins in this function. Based on PNode type, more specialied functions may be called.
@@ -42,32 +43,37 @@ PValue evaluate(PNode* pnode, Context* context, bool* errflg) {
         printf("evaluate:%d ", pnode->lineNumber);
         showPNode(pnode);
     }
-    if (pnode->type == PNIdent) return evaluateIdent(pnode, context);
-    if (pnode->type == PNBltinCall) return evaluateBuiltin(pnode, context, errflg);
-    if (pnode->type == PNFuncCall) return evaluateUserFunc(pnode, context, errflg);
-    *errflg = false;
-    if (pnode->type == PNICons) return PVALUE(PVInt, uInt, pnode->intCons);
-    if (pnode->type == PNSCons) return createStringPValue(pnode->stringCons);
-    if (pnode->type == PNFCons) return PVALUE(PVFloat, uFloat, pnode->floatCons);
-    *errflg = true;
-    return nullPValue;
+    switch (pnode->type) {
+    case PNBltinCall: return evaluateBuiltin(pnode, context, errflg);
+    case PNIdent: return evaluateIdent(pnode, context);
+    case PNFuncCall: { // Builtins around the call may hold Aggregates no variable holds.
+        context->aggregates->numHolding++;
+        PValue pvalue = evaluateUserFunc(pnode, context, errflg);
+        context->aggregates->numHolding--;
+        return pvalue;
+    }
+    case PNICons:
+        *errflg = false;
+        return PVALUE(PVInt, uInt, pnode->intCons);
+    case PNSCons:
+        *errflg = false;
+        return PVALUE(PVString, uString, retainPString(pnode->stringCons));
+    case PNFCons:
+        *errflg = false;
+        return PVALUE(PVFloat, uFloat, pnode->floatCons);
+    default:
+        *errflg = true;
+        return nullPValue;
+    }
 }
 
-// evaluateIdent evaluates an identifier by looking it up in the symbol tables.
+// evaluateIdent evaluates an identifier by getting the value in its slot.
 PValue evaluateIdent(PNode* pnode, Context* context) {
     ASSERT((pnode->type == PNIdent) && context);
     if (programDebugging)
         printf("evaluateIdent: %d: %s\n", pnode->lineNumber, pnode->identifier);
-    String ident = pnode->identifier;
-    ASSERT(ident);
-    if (symbolTableDebugging) showSymbolTable(context->frame->table);
-    PValue orig = getValueOfSymbol(context, ident);
-    // If the PValue is a string, copy the string.
-    if (orig.type == PVString) {
-        return createStringPValue(orig.value.uString);
-    } else {
-        return orig; // safe for non-owning types like int, float, etc.
-    }
+    if (symbolTableDebugging) showFrame(context->frame);
+    return getValueOfSlot(context, pnode->slot);
 }
 
 // evaluateConditional evaluates a conditional expression. They have the form ([iden,] expr),
@@ -89,59 +95,56 @@ bool evaluateConditional(PNode* pnode, Context* context, bool* errflg) {
         scriptError(pnode, "There was an error evaluating the conditional expression");
         return false;
     }
-    if (iden) assignValueToSymbol(context, pnode->identifier, value);
-    return pvalueToBoolean(value); // Coerce to bool.
+    bool result = pvalueToBoolean(value); // Coerce to bool.
+    if (iden) assignValueToSlot(context, pnode->slot, value);
+    else clearPValue(&value);
+    return result;
 }
 
 // evaluateBuiltin evaluates a built-in function call by calling its C code function.
 PValue evaluateBuiltin(PNode* pnode, Context* context, bool* errflg) {
     if (builtInDebugging) printf("%s %2.3f\n", pnode->stringOne, getMseconds());
+    if (profiling) return profileBuiltin(pnode, context, errflg);
     return (*(BIFunc) pnode->builtinFunc)(pnode, context, errflg);
 }
 
 // evaluateUserFunc evaluates a user defined function. The evaluator 'call' the function. The steps are:
-// 1. Find the function in the function table from the name in the pnode's funcName field.
-// 2. Create a SymbolTable and Frame and add it to the Context.
-// 3. Evaluate the arguments and bind them to the parameters in the SymbolTable.
+// 1. Get the function linked to the call by linkProgram.
+// 2. Create a Frame for the function.
+// 3. Evaluate the arguments and bind them to the parameters in the Frame.
+// 4. Add the Frame to the Context and interpret the function body.
 PValue evaluateUserFunc(PNode *pnode, Context *context, bool* errflg) {
     String name = pnode->funcName;
     if (debugging) printf("evaulateUserFunc: %s\n", name);
-    PNode *func = searchFunctionTable(context->program->functions, name);
+    PNode *func = pnode->routine;
     if (!func) {
         scriptError(pnode, "function %s is undefined", name);
         *errflg = true;
         return nullPValue;
     }
-    // Create a SymbolTable and Frame for this function, and add them to the Context.
-    SymbolTable *table = createSymbolTable();
+    if (pnode->numArgs != func->numParams) {
+        scriptError(pnode, "different numbers of arguments and parameters to %s", name);
+        *errflg = true;
+        return nullPValue;
+    }
+    // Create the Frame for this function; it is added to the Context after the arguments are bound.
+    Frame* frame = createFrame(context, pnode, func);
 
     // Bind the arguments to the parameters.
-    PNode *arg = pnode->arguments;
     PNode *parm = func->parameters;
-    while (arg && parm) {
+    for (PNode *arg = pnode->arguments; arg; arg = arg->next, parm = parm->next) {
         PValue value = evaluate(arg, context, errflg); // Eval arg.
         if (*errflg) {
             scriptError(pnode, "could not evaluate an argument of %s", name);
+            deleteFrame(context, frame);
             return nullPValue;
         }
-        assignValueToSymbolTable(table, parm->identifier, value);
-        arg = arg->next;
-        parm = parm->next;
+        assignValueToFrame(frame, parm->slot, value);
     }
-    if (arg || parm) {
-        scriptError(pnode, "different numbers of arguments and parameters to %s", name);
-        *errflg = true;
-        return nullPValue;
-    }
-    if (symbolTableDebugging) showSymbolTable(table);
-    // Create the frame for the called function. Call it. Delete the frame.
-    Frame* frame = createFrame(pnode, func, table, context->frame);
-    context->frame = frame;
-    PValue value;
-    InterpType irc = interpret((PNode*) func->funcBody, context, &value);
-    context->frame = frame->caller;
-    deleteFrame(frame);
-
+    if (symbolTableDebugging) showFrame(frame);
+    // Call the function with its frame; runRoutine deletes the frame.
+    PValue value = nullPValue;
+    InterpType irc = runRoutine(func, frame, context, &value);
     switch (irc) {
     case InterpReturn:
     case InterpOkay:
@@ -164,7 +167,7 @@ PValue evaluateBoolean(PNode* pnode, Context* context, bool* errflg) {
 }
 
 // pvalueToBoolean converts a program value to a boolean using C like rules.
-static bool pvalueToBoolean(PValue pvalue) {
+bool pvalueToBoolean(PValue pvalue) {
     switch (pvalue.type) {
     case PVNull: return false;
     case PVBool: return pvalue.value.uBool;
@@ -187,7 +190,12 @@ static bool pvalueToBoolean(PValue pvalue) {
 // evaluatePerson evaluates a person expression. Returns the root GNode of the person if there.
 GNode* evaluatePerson(PNode* pnode, Context* context, bool* errflg) {
     ASSERT(pnode && context);
-    PValue pvalue = evaluate(pnode, context, errflg);
+    return pvalueToPerson(evaluate(pnode, context, errflg), pnode, errflg);
+}
+
+// pvalueToPerson returns the person of the value of a person expression; null on an error or
+// a null value. Errors are reported at the expression.
+GNode* pvalueToPerson(PValue pvalue, PNode* pnode, bool* errflg) {
     if (*errflg || pvalue.type == PVNull) return null; // Error or null chaining.
     if (pvalue.type != PVPerson) {
         scriptError(pnode, "expression must be a person");
@@ -195,7 +203,7 @@ GNode* evaluatePerson(PNode* pnode, Context* context, bool* errflg) {
         return null;
     }
     GNode* indi = pvalue.value.uGNode;
-    if (nestr("INDI", indi->tag)) {
+    if (indi->tagId != tagINDI) {
         scriptError(pnode, "serious error: expression must be a person");
         *errflg = true;
         return null;
@@ -206,7 +214,12 @@ GNode* evaluatePerson(PNode* pnode, Context* context, bool* errflg) {
 // evaluateFamily evaluates a family expression. Return the root GNode of the family if there.
 GNode* evaluateFamily(PNode* pnode, Context* context, bool* errflg) {
     ASSERT(pnode && context);
-    PValue pvalue = evaluate(pnode, context, errflg);
+    return pvalueToFamily(evaluate(pnode, context, errflg), pnode, errflg);
+}
+
+// pvalueToFamily returns the family of the value of a family expression; null on an error or
+// a null value. Errors are reported at the expression.
+GNode* pvalueToFamily(PValue pvalue, PNode* pnode, bool* errflg) {
     if (*errflg || pvalue.type == PVNull) return null; // Error or null chaining.
     if (pvalue.type != PVFamily) {
         scriptError(pnode, "expression must be a family");
@@ -214,7 +227,7 @@ GNode* evaluateFamily(PNode* pnode, Context* context, bool* errflg) {
         return null;
     }
     GNode* fam = pvalue.value.uGNode;
-    if (nestr("FAM", fam->tag)) {
+    if (fam->tagId != tagFAM) {
         scriptError(pnode, "serious error: expression must be a family");
         *errflg = true;
         return null;
@@ -225,7 +238,12 @@ GNode* evaluateFamily(PNode* pnode, Context* context, bool* errflg) {
 // evaluateGNode evaluate a GNode expression. Return the Gedcom node.
 GNode* evaluateGNode(PNode* pnode, Context* context, bool* errflg) {
     ASSERT(pnode && context);
-    PValue pvalue = evaluate(pnode, context, errflg);
+    return pvalueToGNode(evaluate(pnode, context, errflg), errflg);
+}
+
+// pvalueToGNode returns the Gedcom node of the value of a GNode expression; null on an error or
+// if the value is not a GNode.
+GNode* pvalueToGNode(PValue pvalue, bool* errflg) {
     if (*errflg || !isGNodeType(pvalue.type)) return null;
     return pvalue.value.uGNode;
 }
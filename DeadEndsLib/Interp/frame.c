@@ -3,42 +3,71 @@
 //  frame.c
 //
 //  Created by Thomas Wetmore on 20 May 2025.
-//  Last changed on 28 July 2025.
+//  Last changed on 19 October 2026.
 //
 
-#include "hashtable.h"
+#include "context.h"
 #include "pnode.h"
 #include "pvalue.h"
 #include "standard.h"
-#include "set.h"
-#include "stringset.h"
 #include "symboltable.h"
 #include "frame.h"
 
-static StringSet* getParameterSet(PNode*);
-
-/// Creates a new frame for the run time stack.
+/// Creates a new frame for the run time stack. Its variables are null and its caller is the
+/// Context's current Frame. A Frame deleted earlier is reused if the Context has one; its slots
+/// are reallocated only if there are too few.
 ///
 /// Called by interpProcCall and evaluateUserFunc.
 ///
 /// - Parameters:
+///   - context: `Context` that owns the run time stack.
 ///   - pnode: `PNProcCall` node in the calling function.
 ///   - routine: `PNProcDef` node of the called function.
-///   - table: `SymbolTable` for the called function.
-///   - caller: `Frame` of the calling function.
-Frame* createFrame(PNode* pnode, PNode* routine, SymbolTable* table, Frame* caller) {
-    Frame* frame = (Frame*) stdalloc(sizeof(Frame));
+Frame* createFrame(Context* context, PNode* pnode, PNode* routine) {
+    Frame* frame = context->freeFrames;
+    if (frame) {
+        context->freeFrames = frame->caller;
+    } else {
+        frame = (Frame*) stdalloc(sizeof(Frame));
+        frame->slots = null;
+        frame->maxSlots = 0;
+    }
+    int numSlots = max(routine->numSlots, 1);
+    if (frame->maxSlots < numSlots) {
+        if (frame->slots) stdfree(frame->slots);
+        frame->slots = (PValue*) stdalloc(numSlots*sizeof(PValue));
+        frame->maxSlots = numSlots;
+    }
+    for (int i = 0; i < routine->numSlots; i++) frame->slots[i] = nullPValue;
     frame->call = pnode;
     frame->defn = routine;
-    frame->table = table;
-    frame->caller = caller;
+    frame->caller = context->frame;
     return frame;
 }
 
-/// Deletes a Frame.
-void deleteFrame(Frame* frame) {
-    deleteSymbolTable(frame->table);
-    stdfree(frame);
+/// Deletes a Frame: frees the Strings held by its variables and gives the Frame to its Context
+/// for reuse.
+void deleteFrame(Context* context, Frame* frame) {
+    for (int i = 0; i < frame->defn->numSlots; i++) clearPValue(&frame->slots[i]);
+    frame->caller = context->freeFrames;
+    context->freeFrames = frame;
+}
+
+/// Frees a list of free Frames. Called when their Context is deleted.
+void freeFrames(Frame* frame) {
+    while (frame) {
+        Frame* next = frame->caller;
+        stdfree(frame->slots);
+        stdfree(frame);
+        frame = next;
+    }
+}
+
+/// Binds a value to a parameter or local variable of a Frame. The Frame takes over the value's
+/// reference to its String.
+void assignValueToFrame(Frame* frame, int slot, PValue pvalue) {
+    clearPValue(&frame->slots[slot]);
+    frame->slots[slot] = pvalue;
 }
 
 /// Shows a Fame of the run time stack.
@@ -48,35 +77,16 @@ void showFrame(Frame* frame) {
     int callline = frame->call->lineNumber;
     int defnline = frame->defn->lineNumber;
     printf("Frame: %s: defined: %d called: %d\n", name, defnline, callline);
+    int numParams = 0;
+    for (PNode* param = frame->defn->parameters; param; param = param->next) numParams++;
     printf("  parameters:\n");
-    StringSet* params = getParameterSet(frame->defn);
-    SymbolTable* table = frame->table;
-    FORSET(params, element)
-        String param = (String) element;
-        PValue pvalue = getValueFromSymbolTable(table, param);
-        String type = typeOfPValue(pvalue);
-        String value = valueOfPValue(pvalue);
-        printf("    %s: %s: %s\n", param, type, value);
-    ENDSET
-    printf("  automatics:\n");
-    FORHASHTABLE(table, element)
-        Symbol* symbol = (Symbol*) element;
-        String ident = symbol->ident;
-        if (!isInSet(params, ident)) {
-            PValue pvalue = getValueFromSymbolTable(table, ident);
-            String type = typeOfPValue(pvalue);
-            String value = valueOfPValue(pvalue);
-            printf("    %s: %s: %s\n", ident, type, value);
-        }
-    ENDHASHTABLE
-    deleteStringSet(params, false);
-}
-
-/// Gets the set of parameter names used by a procedure or user function.
-static StringSet* getParameterSet(PNode* pnode) {
-    StringSet* set = createStringSet();
-    for (PNode* param = pnode->parameters; param; param = param->next) {
-        addToSet(set, param->identifier);
+    for (int i = 0; i < frame->defn->numSlots; i++) {
+        if (i == numParams) printf("  automatics:\n");
+        if (i >= numParams && frame->slots[i].type == PVNull) continue; // Not yet assigned.
+        String type = typeOfPValue(frame->slots[i]);
+        String value = valueOfPValue(frame->slots[i]);
+        printf("    %s: %s: %s\n", frame->defn->slotNames[i], type, value);
+        stdfree(value);
     }
-    return set;
+    if (numParams == frame->defn->numSlots) printf("  automatics:\n");
 }
@@ -4,7 +4,7 @@
 //  functable.c has the table of built-in functions in the DeadEnds scripting language.
 //
 //  Created by Thomas Wetmore on 10 January 2023.
-//  Last changed on 17 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "standard.h"
@@ -65,9 +65,12 @@ extern PValue __female(PNode*, Context*, bool*);
 extern PValue __firstchild(PNode*, Context*, bool*);
 extern PValue __firstfam(PNode*, Context*, bool*);
 extern PValue __firstindi(PNode*, Context*, bool*);
+extern PValue __firstindibyname(PNode*, Context*, bool*);
 extern PValue __fnode(PNode*, Context*, bool*);
 extern PValue __fullname(PNode*, Context*, bool*);
 extern PValue __ge(PNode*, Context*, bool*);
+extern PValue __generation(PNode*, Context*, bool*);
+extern PValue __generationset(PNode*, Context*, bool*);
 extern PValue __gengedcom(PNode*, Context*, bool*);
 extern PValue __genindiset(PNode*, Context*, bool*);
 extern PValue __getel(PNode*, Context*, bool*);
@@ -82,6 +85,7 @@ extern PValue __givens(PNode*, Context*, bool*);
 extern PValue __gt(PNode*, Context*, bool*);
 extern PValue __husband(PNode*, Context*, bool*);
 extern PValue __incr(PNode*, Context*, bool*);
+extern PValue __inbreeding(PNode*, Context*, bool*);
 extern PValue __index(PNode*, Context*, bool*);
 extern PValue __indi(PNode*, Context*, bool*);
 extern PValue __indiset(PNode*, Context*, bool*);
@@ -93,8 +97,10 @@ extern PValue __isnull(PNode*, Context*, bool*);
 extern PValue __intersect(PNode*, Context*, bool*);
 extern PValue __key(PNode*, Context*, bool*);
 extern PValue __keysort(PNode*, Context*, bool*);
+extern PValue __kinship(PNode*, Context*, bool*);
 extern PValue __lastchild(PNode*, Context*, bool*);
 extern PValue __lastindi(PNode*, Context*, bool*);
+extern PValue __lastindibyname(PNode*, Context*, bool*);
 extern PValue __lastfam(PNode*, Context*, bool*);
 extern PValue __le(PNode*, Context*, bool*);
 extern PValue __length(PNode*, Context*, bool*);
@@ -109,11 +115,13 @@ extern PValue __lt(PNode*, Context*, bool*);
 extern PValue __male(PNode*, Context*, bool*);
 extern PValue __marriage(PNode*, Context*, bool*);
 extern PValue __menuchoose(PNode*, Context*, bool*);
+extern PValue __mingeneration(PNode*, Context*, bool*);
 extern PValue __mod(PNode*, Context*, bool*);
 extern PValue __monthformat(PNode*, Context*, bool*);
 extern PValue __mother(PNode*, Context*, bool*);
 extern PValue __mul(PNode*, Context*, bool*);
 extern PValue __name(PNode*, Context*, bool*);
+extern PValue __namesearch(PNode*, Context*, bool*);
 extern PValue __namesort(PNode*, Context*, bool*);
 extern PValue __nchildren(PNode*, Context*, bool*);
 extern PValue __ne(PNode*, Context*, bool*);
@@ -121,11 +129,13 @@ extern PValue __neg(PNode*, Context*, bool*);
 extern PValue __newfile(PNode*, Context*, bool*);
 extern PValue __nextfam(PNode*, Context*, bool*);
 extern PValue __nextindi(PNode*, Context*, bool*);
+extern PValue __nextindibyname(PNode*, Context*, bool*);
 extern PValue __nextsib(PNode*, Context*, bool*);
 extern PValue __nfamilies(PNode*, Context*, bool*);
 extern PValue __nl(PNode*, Context*, bool*);
 extern PValue __not(PNode*, Context*, bool*);
 extern PValue __nspouses(PNode*, Context*, bool*);
+extern PValue __numgenerations(PNode*, Context*, bool*);
 extern PValue __or(PNode*, Context*, bool*);
 extern PValue __ord(PNode*, Context*, bool*);
 extern PValue __outfile(PNode*, Context*, bool*);
@@ -135,17 +145,21 @@ extern PValue __parent(PNode*, Context*, bool*);
 extern PValue __parents(PNode*, Context*, bool*);
 extern PValue __parentset(PNode*, Context*, bool*);
 extern PValue __place(PNode*, Context*, bool*);
+extern PValue __placecount(PNode*, Context*, bool*);
+extern PValue __placeset(PNode*, Context*, bool*);
 extern PValue __pn(PNode*, Context*, bool*);
 //extern PValue __pop(PNode*, Context*, bool*);
 extern PValue __pos(PNode*, Context*, bool*);
 extern PValue __prepend(PNode*, Context*, bool*);
 extern PValue __prevfam(PNode*, Context*, bool*);
 extern PValue __previndi(PNode*, Context*, bool*);
+extern PValue __previndibyname(PNode*, Context*, bool*);
 extern PValue __prevsib(PNode*, Context*, bool*);
 extern PValue __print(PNode*, Context*, bool*);
 //extern PValue __push(PNode*, Context*, bool*);
 extern PValue __qt(PNode*, Context*, bool*);
 extern PValue __reference(PNode*, Context*, bool*);
+extern PValue __relationship(PNode*, Context*, bool*);
 extern PValue __removeFirst(PNode*, Context*, bool*);
 extern PValue __removeLast(PNode*, Context*, bool*);
 //extern PValue __requeue(PNode*, Context*, bool*);
@@ -177,7 +191,9 @@ extern PValue __surname(PNode*, Context*, bool*);
 extern PValue __system(PNode*, Context*, bool*);
 extern PValue __table(PNode*, Context*, bool*);
 extern PValue __tag(PNode*, Context*, bool*);
+extern PValue __textsearch(PNode*, Context*, bool*);
 extern PValue __title(PNode*, Context*, bool*);
+extern PValue __topplaces(PNode*, Context*, bool*);
 extern PValue __trim(PNode*, Context*, bool*);
 extern PValue __trimname(PNode*, Context*, bool*);
 extern PValue __TYPEOF(PNode*, Context*, bool*);
@@ -189,6 +205,8 @@ extern PValue __value(PNode*, Context*, bool*);
 extern PValue __VALUEOF(PNode*, Context*, bool*);
 extern PValue __valuesort(PNode*, Context*, bool*);
 extern PValue __version(PNode*, Context*, bool*);
+extern PValue __vitalset(PNode*, Context*, bool*);
+extern PValue __vitalyear(PNode*, Context*, bool*);
 extern PValue __wife(PNode*, Context*, bool*);
 extern PValue __xref(PNode*, Context*, bool*);
 extern PValue __year(PNode*, Context*, bool*);
@@ -253,9 +271,12 @@ BuiltIn builtIns[] = {
     "firstchild",   1,    1,    __firstchild,
 	"firstfam",     0,    0,    __firstfam,
     "firstindi",    0,    0,    __firstindi,
+    "firstindibyname", 0,    0,    __firstindibyname,
 	"fnode",        1,    1,    __fnode,
     "fullname",     4,    4,    __fullname,
     "ge",           2,    2,    __ge,
+    "generation",   1,    1,    __generation,
+    "generationset",1,    1,    __generationset,
     "gengedcom",    1,    1,    __gengedcom,
 //  "genindiset",   2,    2,    __genindiset,
     "getel",        2,    2,    __getel,
@@ -272,6 +293,7 @@ BuiltIn builtIns[] = {
     "givens",       1,    1,    __givens,
     "gt",           2,    2,    __gt,
     "husband",      1,    1,    __husband,
+    "inbreeding",   1,    1,    __inbreeding,
     "incr",         1,    1,    __incr,
     "index",        3,    3,    __index,
     "indi",         1,    1,    __indi,
@@ -284,9 +306,11 @@ BuiltIn builtIns[] = {
     "isnull",       1,    1,    __isnull,
     "key",          1,    2,    __key,
     "keysort",      1,    1,    __keysort,
+    "kinship",      2,    2,    __kinship,
     "lastchild",    1,    1,    __lastchild,
 	"lastfam",      0,    0,    __lastfam,
 	"lastindi",     0,    0,    __lastindi,
+	"lastindibyname", 0,    0,    __lastindibyname,
     "le",           2,    2,    __le,
     "length",       1,    1,    __length,
     "lengthset",    1,    1,    __lengthset, // DEPRECATED
@@ -300,11 +324,13 @@ BuiltIn builtIns[] = {
     "male",         1,    1,    __male,
     "marriage",     1,    1,    __marriage,
 //  "menuchoose",   1,    2,    __menuchoose,
+    "mingeneration",1,    1,    __mingeneration,
     "mod",          2,    2,    __mod,
     "monthformat",  1,    1,    __monthformat,
     "mother",       1,    1,    __mother,
     "mul",          2,   CC,    __mul,
     "name",         1,    2,    __name,
+    "namesearch",   1,    2,    __namesearch,
     "namesort",     1,    1,    __namesort,
     "nchildren",    1,    1,    __nchildren,
     "ne",           2,    2,    __ne,
@@ -313,11 +339,13 @@ BuiltIn builtIns[] = {
 	"newfile",      0,    2,    __newfile,
 	"nextfam",      1,    1,    __nextfam,
     "nextindi",     1,    1,    __nextindi,
+    "nextindibyname", 1,    1,    __nextindibyname,
     "nextsib",      1,    1,    __nextsib,
 	"nfamilies",    1,    1,    __nfamilies,
     "nl",           0,    0,    __nl,
     "not",          1,    1,    __not,
     "nspouses",     1,    1,    __nspouses,
+    "numgenerations",0,   0,    __numgenerations,
     "or",           2,   CC,    __or,
     "ord",          1,    1,    __ord,
     "outfile",      0,    0,    __outfile,
@@ -327,17 +355,21 @@ BuiltIn builtIns[] = {
 	"parents",      1,    1,    __parents,
     "parentset",    1,    1,    __parentset,
     "place",        1,    1,    __place,
+    "placecount",   1,    1,    __placecount,
+    "placeset",     1,    1,    __placeset,
     "pn",           2,    2,    __pn,  // Outputs pronouns
     "pop",          1,    1,    __removeFirst,
 	"pos",          2,    2,    __pos,
     "prepend",      2,    2,    __prepend,
 	"prevfam",      1,    1,    __prevfam,
 	"previndi",     1,    1,    __previndi,
+	"previndibyname", 1,    1,    __previndibyname,
 	"prevsib",      1,    1,    __prevsib,
     "print",        1,   CC,    __print,
     "push",         2,    2,    __prepend,
     "qt",           0,    0,    __qt,
 	"reference",    1,    1,    __reference,
+	"relationship", 2,    3,    __relationship,
     "removeFirst",  1,    1,    __removeFirst,
     "removeLast",   1,    1,    __removeLast,
 	"requeue",      2,    2,    __append,
@@ -372,7 +404,9 @@ BuiltIn builtIns[] = {
 //  "system",       1,    1,    __system,
     "table",        1,    1,    __table,
     "tag",          1,    1,    __tag,
+    "textsearch",   1,    1,    __textsearch,
     "title",        1,    1,    __title,
+    "topplaces",    2,    3,    __topplaces,
 	"trim",         2,    2,    __trim,
     "trimname",     2,    2,    __trimname,
     "typeof",       1,    1,    __TYPEOF,
@@ -384,6 +418,8 @@ BuiltIn builtIns[] = {
     "valueof",      1,    1,    __VALUEOF,
 	"valuesort",    1,    1,    __valuesort,
     "version",      0,    0,    __version,
+    "vitalset",     3,    3,    __vitalset,
+    "vitalyear",    2,    2,    __vitalyear,
     "wife",         1,    1,    __wife,
     "xref",         1,    1,    __xref,
     "year",         1,    1,    __year,
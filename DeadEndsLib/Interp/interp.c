@@ -6,10 +6,13 @@
 //  or call a more specific function.
 //
 //  Created by Thomas Wetmore on 9 December 2022.
-//  Last changed on 10 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include <stdarg.h>
+#include <stdatomic.h>
+#include "collect.h"
+#include "compile.h"
 #include "context.h"
 #include "database.h"
 #include "evaluate.h"
@@ -23,6 +26,7 @@
 #include "lineage.h"
 #include "list.h"
 #include "pnode.h"
+#include "profile.h"
 #include "pvalue.h"
 #include "sequence.h"
 #include "set.h"
@@ -55,8 +59,10 @@ InterpType runProgram(Program* program, Database* database, File* outfile) {
     // Create the Context.
     Context* context = createContext(program, database, outfile);
 
-    // Call the main function.
+    // Call the main function, profiling it if asked.
+    if (profileScripts) beginProfile(context);
     InterpType itype = interpScript(context, outfile);
+    if (profiling) endProfile(stderr);
 
     // Free the Context.
     deleteContext(context);
@@ -71,6 +77,7 @@ InterpType interpScript(Context* context, File* outfile) {
     curFileName = "deadends";
     curLine = 1;
     PNode* pnode = procCallPNode("main", null);
+    pnode->routine = searchFunctionTable(context->program->procedures, "main");
 
     // If there is an output file use it.
     if (outfile && context->file != outfile) {
@@ -95,6 +102,7 @@ InterpType interpret(PNode* pnode, Context* context, PValue* returnValue) {
             printf("interpret:%d: ", pnode->lineNumber);
             showPNode(pnode);
         }
+        if (profiling) profileLine(pnode);
         switch (pnode->type) {
         case PNSCons: // Strings are written.
             poutput(pnode->stringCons, context);
@@ -106,7 +114,7 @@ InterpType interpret(PNode* pnode, Context* context, PValue* returnValue) {
             pvalue = evaluateIdent(pnode, context);
             if (pvalue.type == PVString && pvalue.value.uString) {
                 poutput(pvalue.value.uString, context);
-                stdfree(pvalue.value.uString);
+                releasePString(pvalue.value.uString);
             }
             break;
         case PNBltinCall: // Call builtin and write return value if a String.
@@ -117,7 +125,7 @@ InterpType interpret(PNode* pnode, Context* context, PValue* returnValue) {
             }
             if (pvalue.type == PVString && pvalue.value.uString) {
                 poutput(pvalue.value.uString, context);
-                stdfree(pvalue.value.uString);
+                releasePString(pvalue.value.uString);
             }
             break;
         case PNProcCall: { // Call a builtin procedure. If for some reason it returns a String write it.
@@ -125,7 +133,7 @@ InterpType interpret(PNode* pnode, Context* context, PValue* returnValue) {
             case InterpOkay:
                 if (returnValue && returnValue->type == PVString && returnValue->value.uString) {
                     poutput(returnValue->value.uString, context);
-                    stdfree(returnValue->value.uString);
+                    releasePString(returnValue->value.uString);
                 }
                 break;
             case InterpError: return InterpError;
@@ -138,7 +146,7 @@ InterpType interpret(PNode* pnode, Context* context, PValue* returnValue) {
             if (errorFlag) return InterpError;
             if (pvalue.type == PVString && pvalue.value.uString) {
                 poutput(pvalue.value.uString, context);
-                stdfree(pvalue.value.uString);  // The pvalue's string is in the heap.
+                releasePString(pvalue.value.uString);
             }
             break;
         case PNNotes: // Iterate NOTEs.
@@ -292,6 +300,10 @@ InterpType interpret(PNode* pnode, Context* context, PValue* returnValue) {
                 *returnValue = evaluate(pnode->returnExpr, context, &errorFlag);
             return InterpReturn;
         }
+        // Collect when enough Aggregates have been created and no expression holds one.
+        Aggregates* aggregates = context->aggregates;
+        if (aggregates->length >= aggregates->nextCollection && !aggregates->numHolding)
+            collectAggregates(context);
         pnode = pnode->next; // Move to next statement.
     }
     return InterpOkay;
@@ -303,13 +315,13 @@ InterpType interpret(PNode* pnode, Context* context, PValue* returnValue) {
 InterpType interpChildren (PNode* pnode, Context* context, PValue* pval) {
     bool eflg = false;
     GNode *fam =  evaluateFamily(pnode->familyExpr, context, &eflg);
-    if (eflg || !fam || nestr(fam->tag, "FAM")) {
+    if (eflg || !fam || fam->tagId != tagFAM) {
         scriptError(pnode, "the first argument to children must be a family");
         return InterpError;
     }
     FORCHILDREN(fam, chil, key, nchil, context->database->recordIndex) {
-        assignValueToSymbol(context, pnode->childIden, PVALUE(PVPerson, uGNode, chil));
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, nchil));
+        assignValueToSlot(context, pnode->childSlot, PVALUE(PVPerson, uGNode, chil));
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, nchil));
         InterpType irc = interpret(pnode->loopState, context, pval);
         switch (irc) {
         case InterpContinue:
@@ -328,14 +340,14 @@ InterpType interpChildren (PNode* pnode, Context* context, PValue* pval) {
 InterpType interpSpouses(PNode* pnode, Context* context, PValue *pval) {
     bool eflg = false;
     GNode *indi = evaluatePerson(pnode->personExpr, context, &eflg);
-    if (eflg || !indi || nestr(indi->tag, "INDI")) {
+    if (eflg || !indi || indi->tagId != tagINDI) {
         scriptError(pnode, "the first argument to spouses must be a person");
         return InterpError;
     }
     FORSPOUSES(indi, spouse, fam, nspouses, context->database->recordIndex) {
-        assignValueToSymbol(context, pnode->spouseIden, PVALUE(PVPerson, uGNode, spouse));
-        assignValueToSymbol(context, pnode->familyIden, PVALUE(PVFamily, uGNode, fam));
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, nspouses));
+        assignValueToSlot(context, pnode->spouseSlot, PVALUE(PVPerson, uGNode, spouse));
+        assignValueToSlot(context, pnode->familySlot, PVALUE(PVFamily, uGNode, fam));
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, nspouses));
 
         InterpType irc = interpret(pnode->loopState, context, pval);
         switch (irc) {
@@ -355,7 +367,7 @@ InterpType interpSpouses(PNode* pnode, Context* context, PValue *pval) {
 InterpType interpFamilies(PNode* pnode, Context* context, PValue *pval) {
     bool eflg = false;
     GNode *indi = evaluatePerson(pnode->personExpr, context, &eflg);
-    if (eflg || !indi || nestr(indi->tag, "INDI")) {
+    if (eflg || !indi || indi->tagId != tagINDI) {
         scriptError(pnode, "the first argument to families must be a person");
         return InterpError;
     }
@@ -363,13 +375,13 @@ InterpType interpFamilies(PNode* pnode, Context* context, PValue *pval) {
     int count = 0;
     RecordIndex* index = context->database->recordIndex;
     FORFAMSS(indi, fam, key, index) {
-        assignValueToSymbol(context, pnode->familyIden, PVALUE(PVFamily, uGNode, fam));
+        assignValueToSlot(context, pnode->familySlot, PVALUE(PVFamily, uGNode, fam));
         SexType sex = SEXV(indi);
         if (sex == sexMale) spouse = familyToWife(fam, index);
         else if (sex == sexFemale) spouse = familyToHusband(fam, index);
         else spouse = null;
-        assignValueToSymbol(context, pnode->spouseIden, spouse ? PVALUE(PVPerson, uGNode, spouse) : nullPValue);
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, ++count));
+        assignValueToSlot(context, pnode->spouseSlot, spouse ? PVALUE(PVPerson, uGNode, spouse) : nullPValue);
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, ++count));
         InterpType irc = interpret(pnode->loopState, context, pval);
         switch (irc) {
         case InterpContinue:
@@ -388,7 +400,7 @@ InterpType interpFamilies(PNode* pnode, Context* context, PValue *pval) {
 InterpType interpFathers(PNode* pnode, Context* context, PValue *pval) {
     bool eflg = false;
     GNode *indi = evaluatePerson(pnode->personExpr, context, &eflg);
-    if (eflg || !indi || nestr(indi->tag, "INDI")) {
+    if (eflg || !indi || indi->tagId != tagINDI) {
         scriptError(pnode, "the first argument to fathers must be a person");
         return InterpError;
     }
@@ -396,9 +408,9 @@ InterpType interpFathers(PNode* pnode, Context* context, PValue *pval) {
     FORFAMCS(indi, fam, key, context->database->recordIndex)
     GNode *husb = familyToHusband(fam, context->database->recordIndex);
     if (husb == null) goto d;
-    assignValueToSymbol(context, pnode->familyIden, PVALUE(PVFamily, uGNode, fam));
-    assignValueToSymbol(context, pnode->fatherIden, PVALUE(PVFamily, uGNode, husb));
-    assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, ++nfams));
+    assignValueToSlot(context, pnode->familySlot, PVALUE(PVFamily, uGNode, fam));
+    assignValueToSlot(context, pnode->fatherSlot, PVALUE(PVFamily, uGNode, husb));
+    assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, ++nfams));
     InterpType irc = interpret(pnode->loopState, context, pval);
     switch (irc) {
     case InterpContinue:
@@ -416,7 +428,7 @@ InterpType interpFathers(PNode* pnode, Context* context, PValue *pval) {
 InterpType interpMothers (PNode* pnode, Context* context, PValue *pval) {
     bool eflg = false;
     GNode *indi = evaluatePerson(pnode->personExpr, context, &eflg);
-    if (eflg || !indi || nestr(indi->tag, "INDI")) {
+    if (eflg || !indi || indi->tagId != tagINDI) {
         scriptError(pnode, "the first argument to mothers must be a person");
         return InterpError;;
     }
@@ -425,9 +437,9 @@ InterpType interpMothers (PNode* pnode, Context* context, PValue *pval) {
         GNode *wife = familyToWife(fam, context->database->recordIndex);
         if (wife == null) goto d;
         //  Assign the current loop identifier valujes to the symbol table.
-        assignValueToSymbol(context, pnode->familyIden, PVALUE(PVFamily, uGNode, fam));
-        assignValueToSymbol(context, pnode->motherIden, PVALUE(PVFamily, uGNode, wife));
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, ++nfams));
+        assignValueToSlot(context, pnode->familySlot, PVALUE(PVFamily, uGNode, fam));
+        assignValueToSlot(context, pnode->motherSlot, PVALUE(PVFamily, uGNode, wife));
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, ++nfams));
 
         // Intepret the body of the loop.
         InterpType irc = interpret(pnode->loopState, context, pval);
@@ -448,14 +460,14 @@ InterpType interpParents(PNode* pnode, Context* context, PValue *pval) {
     bool eflg = false;
     InterpType irc;
     GNode *indi = evaluatePerson(pnode->personExpr, context, &eflg);
-    if (eflg || !indi || nestr(indi->tag, "INDI")) {
+    if (eflg || !indi || indi->tagId != tagINDI) {
         scriptError(pnode, "the first argument to parents must be a person");
         return InterpError;
     }
     int nfams = 0;
     FORFAMCS(indi, fam, key, context->database->recordIndex) {
-        assignValueToSymbol(context, pnode->familyIden, PVALUE(PVFamily, uGNode, fam));
-        assignValueToSymbol(context, pnode->countIden,  PVALUE(PVInt, uInt, ++nfams));
+        assignValueToSlot(context, pnode->familySlot, PVALUE(PVFamily, uGNode, fam));
+        assignValueToSlot(context, pnode->countSlot,  PVALUE(PVInt, uInt, ++nfams));
         irc = interpret(pnode->loopState, context, pval);
         switch (irc) {
         case InterpContinue:
@@ -481,7 +493,7 @@ InterpType interpFornotes(PNode* pnode, Context* context, PValue *pval) {
     }
     if (!root) return InterpOkay;
     FORTAGVALUES(root, "NOTE", sub, vstring) {
-        assignValueToSymbol(context, pnode->noteIden, createStringPValue(vstring));
+        assignValueToSlot(context, pnode->noteSlot, createStringPValue(vstring));
         irc = interpret(pnode->loopState, context, pval);
         switch (irc) {
         case InterpContinue:
@@ -508,7 +520,7 @@ InterpType interp_fornodes(PNode* pnode, Context* context, PValue *pval) {
     }
     GNode *sub = root->child;
     while (sub) {
-        assignValueToSymbol(context, pnode->gnodeIden, PVALUE(PVGNode, uGNode, sub));
+        assignValueToSlot(context, pnode->gnodeSlot, PVALUE(PVGNode, uGNode, sub));
         InterpType irc = interpret(pnode->loopState, context, pval);
         switch (irc) {
         case InterpContinue:
@@ -527,12 +539,10 @@ InterpType interp_fornodes(PNode* pnode, Context* context, PValue *pval) {
 // Usage: forindi(INDI_V, INT_V) {...}; Fields: personIden, countIden, loopState.
 InterpType interpForindi (PNode* pnode, Context* context, PValue* pvalue) {
     RootList *roots = context->database->personRoots;
-    sortList(roots);
-    SymbolTable* table = context->frame->table;
     for (int i = 0; i < lengthList(roots); i++) {
         GNode* person = getListElement(roots, i);
-        assignValueToSymbol(context, pnode->personIden, PVALUE(PVPerson, uGNode, person));
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, i));
+        assignValueToSlot(context, pnode->personSlot, PVALUE(PVPerson, uGNode, person));
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, i));
         InterpType irc = interpret(pnode->loopState, context, pvalue);
         switch (irc) {
         case InterpContinue:
@@ -542,8 +552,8 @@ InterpType interpForindi (PNode* pnode, Context* context, PValue* pvalue) {
         case InterpError: return InterpError;
         }
     }
-    e:  removeFromHashTable(table, pnode->personIden);
-    removeFromHashTable(table, pnode->countIden);
+    e:  clearLocalSlot(context, pnode->personSlot);
+    clearLocalSlot(context, pnode->countSlot);
     return InterpOkay;
 }
 
@@ -551,12 +561,10 @@ InterpType interpForindi (PNode* pnode, Context* context, PValue* pvalue) {
 // usage: forfam(FAM_V,INT_V) {...}
 InterpType interpForfam(PNode* pnode, Context* context, PValue* pvalue) {
     RootList *roots = context->database->familyRoots;
-    sortList(roots);
-    SymbolTable* table = context->frame->table;
     for (int i = 0; i < lengthList(roots); i++) {
         GNode* family = getListElement(roots, i);
-        assignValueToSymbol(context, pnode->familyIden, PVALUE(PVFamily, uGNode, family));
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, i));
+        assignValueToSlot(context, pnode->familySlot, PVALUE(PVFamily, uGNode, family));
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, i));
         InterpType irc = interpret(pnode->loopState, context, pvalue);
         switch (irc) {
         case InterpContinue:
@@ -566,8 +574,8 @@ InterpType interpForfam(PNode* pnode, Context* context, PValue* pvalue) {
         case InterpError: return InterpError;
         }
     }
-    e:  removeFromHashTable(table, pnode->familyIden);
-    removeFromHashTable(table, pnode->countIden);
+    e:  clearLocalSlot(context, pnode->familySlot);
+    clearLocalSlot(context, pnode->countSlot);
     return InterpOkay;
 }
 
@@ -575,12 +583,10 @@ InterpType interpForfam(PNode* pnode, Context* context, PValue* pvalue) {
 // usage: forsour(SOUR_V, INT_V) {...}
 InterpType interpForsour(PNode *pnode, Context *context, PValue *pvalue) {
     RootList *roots = context->database->sourceRoots;
-    sortList(roots);
-    SymbolTable* table = context->frame->table;
     for (int i = 0; i < lengthList(roots); i++) {
         GNode* source = getListElement(roots, i);
-        assignValueToSymbol(context, pnode->familyIden, PVALUE(PVFamily, uGNode, source));
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, i));
+        assignValueToSlot(context, pnode->familySlot, PVALUE(PVFamily, uGNode, source));
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, i));
         InterpType irc = interpret(pnode->loopState, context, pvalue);
         switch (irc) {
         case InterpContinue:
@@ -590,8 +596,8 @@ InterpType interpForsour(PNode *pnode, Context *context, PValue *pvalue) {
         case InterpError: return InterpError;
         }
     }
-    e:  removeFromHashTable(table, pnode->familyIden);
-    removeFromHashTable(table, pnode->countIden);
+    e:  clearLocalSlot(context, pnode->familySlot);
+    clearLocalSlot(context, pnode->countSlot);
     return InterpOkay;
 }
 
@@ -599,12 +605,10 @@ InterpType interpForsour(PNode *pnode, Context *context, PValue *pvalue) {
 // usage: foreven(EVEN_V,INT_V) {...}
 InterpType interpForeven (PNode* node, Context* context, PValue *pvalue) {
     RootList* roots = context->database->eventRoots;
-    sortList(roots);
-    SymbolTable* table = context->frame->table;
     for (int i = 0; i < lengthList(roots); i++) {
         GNode *event = getListElement(roots, i);
-        assignValueToSymbol(context, node->eventIden, PVALUE(PVEvent, uGNode, event));
-        assignValueToSymbol(context, node->countIden, PVALUE(PVInt, uInt, i));
+        assignValueToSlot(context, node->eventSlot, PVALUE(PVEvent, uGNode, event));
+        assignValueToSlot(context, node->countSlot, PVALUE(PVInt, uInt, i));
         InterpType irc = interpret(node->loopState, context, pvalue);
         switch (irc) {
         case InterpContinue:
@@ -614,20 +618,19 @@ InterpType interpForeven (PNode* node, Context* context, PValue *pvalue) {
         case InterpError: return InterpError;
         }
     }
-    e:  removeFromHashTable(table, node->personIden);
-    removeFromHashTable(table, node->countIden);
+    e:  clearLocalSlot(context, node->personSlot);
+    clearLocalSlot(context, node->countSlot);
     return InterpOkay;
 }
 
 // interpForothr Interprets the forothr statement looping through all events in the Database.
 // usage: forothr(OTHR_V,INT_V) {...}
 InterpType interpForothr(PNode *node, Context *context, PValue *pval) {
-    SymbolTable* table = context->frame->table;
     RootList* roots = context->database->otherRoots;
     for (int i = 0; i < lengthList(roots); i++) {
         GNode* othr = getListElement(roots, i);
-        assignValueToSymbol(context, node->otherIden, PVALUE(PVEvent, uGNode, othr));
-        assignValueToSymbol(context, node->countIden, PVALUE(PVInt, uInt, i));
+        assignValueToSlot(context, node->otherSlot, PVALUE(PVEvent, uGNode, othr));
+        assignValueToSlot(context, node->countSlot, PVALUE(PVInt, uInt, i));
         InterpType irc = interpret(node->loopState, context, pval);
         switch (irc) {
         case InterpContinue:
@@ -637,8 +640,8 @@ InterpType interpForothr(PNode *node, Context *context, PValue *pval) {
         case InterpError: return InterpError;
         }
     }
-    e:  removeFromHashTable(table, node->personIden);
-    removeFromHashTable(table, node->countIden);
+    e:  clearLocalSlot(context, node->personSlot);
+    clearLocalSlot(context, node->countSlot);
     return InterpOkay;
     return InterpOkay;
 }
@@ -656,24 +659,27 @@ InterpType interpretSequenceLoop(PNode* pnode, Context* context, PValue* pval) {
     }
     Sequence *seq = val.value.uSequence;
     RecordIndex* index = context->database->recordIndex;
+    pushRoot(context, val); // No variable need hold the Sequence.
     FORSEQUENCE(seq, el, ncount) {
         GNode *indi = keyToPerson(el->root->key, index); // Update person in symbol table.
-        assignValueToSymbol(context, pnode->elementIden, PVALUE(PVPerson, uGNode, indi));
+        assignValueToSlot(context, pnode->elementSlot, PVALUE(PVPerson, uGNode, indi));
         //PValue pvalue = (PValue) {PVInt, el->value}; // Update person's value in symbol table.
         //PValue pvalue = (PValue) {el->value->type, el->value->value};
-        PValue pvalue = *(el->value);
-        assignValueToSymbol(context, pnode->valueIden, pvalue);
-        assignValueToSymbol(context, pnode->countIden, PVALUE(PVInt, uInt, ncount));
+        PValue pvalue = el->value ? retainPValue(*(el->value)) : nullPValue; // Most builders leave values null.
+        assignValueToSlot(context, pnode->valueSlot, pvalue);
+        assignValueToSlot(context, pnode->countSlot, PVALUE(PVInt, uInt, ncount));
         switch (irc = interpret(pnode->loopState, context, pval)) {
         case InterpContinue:
         case InterpOkay: goto h;
-        case InterpBreak: return InterpOkay;
-        default: return irc;
+        case InterpBreak: irc = InterpOkay; goto e;
+        default: goto e;
         }
         h:	;
     }
     ENDSEQUENCE
-    return InterpOkay;
+    irc = InterpOkay;
+    e:  popRoot(context);
+    return irc;
 }
 
 // interpIfStatement interprets an if statement.
@@ -711,51 +717,42 @@ InterpType interpWhileStatement (PNode* pnode, Context* context, PValue* pval) {
 }
 
 // interpProcCall interprets a user-defined procedure call.
-extern void showFrame(Frame*);
 InterpType interpProcCall(PNode* pnode, Context* context, PValue* pval) {
-    // Get the procedure from the procedure table.
+    // Get the procedure linked to the call.
     String name = pnode->procName;
     if (callTracing) printf("calling: %s (line %d)\n", name, pnode->lineNumber);
-    PNode* proc = searchFunctionTable(context->program->procedures, name);
+    PNode* proc = pnode->routine;
     if (!proc) {
         scriptError(pnode, "procedure %s is undefined", name);
         return InterpError;
     }
+    if (pnode->numArgs != proc->numParams) { // Check for argument and parameter mismatch.
+        scriptError(pnode, "different numbers of arguments and parameters to %s", name);
+        return InterpError;
+    }
 
-    // Create the symbol table for the called procedure.
-    SymbolTable* table = createSymbolTable();
+    // Create the frame for the called procedure.
+    Frame* frame = createFrame(context, pnode, proc);
 
-    // Bind the arguments to the parameters. Important: the arguments are evaluated using the caller's symbol
-    // table, while the parameters and their values are put in the called procedure's symbol table.
-    PNode* arg = pnode->arguments;
+    // Bind the arguments to the parameters. Important: the arguments are evaluated using the caller's frame,
+    // while the parameters and their values are put in the called procedure's frame.
     PNode* parm = proc->parameters;
     int argcount = 1;
-    while (arg && parm) {
+    for (PNode* arg = pnode->arguments; arg; arg = arg->next, parm = parm->next, argcount++) {
         bool errflg = false;
         // Evaluate the argument values in the caller's context.
         PValue value = evaluate(arg, context, &errflg);
         if (errflg) {
-            scriptError(pnode, "could not evaluate argument %d of %s", argcount++, name);
+            scriptError(pnode, "could not evaluate argument %d of %s", argcount, name);
+            deleteFrame(context, frame);
             return InterpError;
         }
-        // Assign values to the parameters in the called procedure's symbol table.
-        assignValueToSymbolTable(table, parm->identifier, value);
-        arg = arg->next;
-        parm = parm->next;
-    }
-    if (arg || parm) { // Check for argument and parameter mismatch.
-        scriptError(pnode, "different numbers of arguments and parameters to %s", name);
-        return InterpError;
+        // Assign values to the parameters in the called procedure's frame.
+        assignValueToFrame(frame, parm->slot, value);
     }
 
-    // Create the frame for the called procedure. Add the frame to the context. Call the procedure.
-    // Remove the frame from the context. Delete the frame which deletes the symbol table.
-    Frame* frame = createFrame(pnode, proc, table, context->frame);
-    context->frame = frame;
-    InterpType returnCode = interpret(proc->procBody, context, pval);
-    context->frame = frame->caller;
-    deleteFrame(frame);
-
+    // Call the procedure; runRoutine deletes the frame.
+    InterpType returnCode = runRoutine(proc, frame, context, pval);
     switch (returnCode) {
     case InterpReturn:
     case InterpOkay: return InterpOkay;
@@ -767,10 +764,31 @@ InterpType interpProcCall(PNode* pnode, Context* context, PValue* pval) {
     return InterpError;
 }
 
+// runRoutine runs the body of a procedure or function in a Frame that holds its arguments. It adds
+// the Frame to the Context, runs the body's Code if it was compiled and the interpreter isn't
+// profiling, or else interprets the body, then removes the Frame and deletes it. The fences keep
+// the profiler's signal handler from seeing a Frame before it is complete or after it is reused.
+InterpType runRoutine(PNode* defn, Frame* frame, Context* context, PValue* returnValue) {
+    atomic_signal_fence(memory_order_seq_cst);
+    context->frame = frame;
+    InterpType returnCode;
+    if (profiling) {
+        enterRoutine(defn);
+        returnCode = interpret(defn->procBody, context, returnValue);
+        leaveRoutine();
+    } else if (defn->code)
+        returnCode = runCode(defn->code, context, returnValue);
+    else
+        returnCode = interpret(defn->procBody, context, returnValue);
+    context->frame = frame->caller;
+    atomic_signal_fence(memory_order_seq_cst);
+    deleteFrame(context, frame);
+    return returnCode;
+}
+
 // interpTraverse interprets the traverse statement. It adds two entries to the symbol table.
 // Usage: traverse(GNode expr, GNode ident, int ident) {...}.
 // Fields: gnodeExpr, levelIden, gNodeIden.
-#define MAXTRAVERSEDEPTH 100
 InterpType interpTraverse(PNode* pnode, Context* context, PValue* returnValue) {
     ASSERT(pnode && context);
     bool errorFlag = false;
@@ -786,11 +804,10 @@ InterpType interpTraverse(PNode* pnode, Context* context, PValue* returnValue) {
     nodeStack[lev] = root;
     // Traverse the tree doing something.
     InterpType returnIrc = InterpOkay;
-    SymbolTable* table = context->frame->table;
     while (true) {
         // Assign loop variables.
-        assignValueToSymbol(context, pnode->levelIden, PVALUE(PVInt, uInt, lev));
-        assignValueToSymbol(context, pnode->gnodeIden, PVALUE(PVGNode, uGNode, nodeStack[lev]));
+        assignValueToSlot(context, pnode->levelSlot, PVALUE(PVInt, uInt, lev));
+        assignValueToSlot(context, pnode->gnodeSlot, PVALUE(PVGNode, uGNode, nodeStack[lev]));
         // Interpret loop body
         InterpType irc = interpret(pnode->loopState, context, returnValue);
         switch (irc) {
@@ -827,14 +844,15 @@ InterpType interpTraverse(PNode* pnode, Context* context, PValue* returnValue) {
     }
 
 cleanup:
-    removeFromHashTable(table, pnode->levelIden);
-    removeFromHashTable(table, pnode->gnodeIden);
+    clearLocalSlot(context, pnode->levelSlot);
+    clearLocalSlot(context, pnode->gnodeSlot);
     return returnIrc;
 }
 
 // scriptError reports a run time script error.
 void scriptError(PNode* pnode, String fmt, ...) {
     va_list args;
+    flushStdout(); // Keep the error after the output before it.
     printf("\nError in \"%s\" at line %d: ", pnode->fileName, pnode->lineNumber);
     va_start(args, fmt);
     vprintf(fmt, args);
@@ -843,8 +861,6 @@ void scriptError(PNode* pnode, String fmt, ...) {
 }
 
 // showRuntimeStack shows the contents of the run time stack. If pnode is not null its line number is shown;
-static StringSet* getParameterSet(PNode*);
-void showFrame(Frame*);
 void showRuntimeStack(Context* context, PNode* pnode) {
     // Get the bottom frame.
     Frame* frame = context->frame;
@@ -858,13 +874,13 @@ void showRuntimeStack(Context* context, PNode* pnode) {
         showFrame(frame);
     }
     printf("Global symbols:\n");
-    FORHASHTABLE(context->globals, element)
-        Symbol* symbol = (Symbol*) element;
-        String svalue = valueOfPValue(*(symbol->value));
-        String type = typeOfPValue(*(symbol->value));
-        printf("    %s: %s: %s\n", symbol->ident, svalue, type);
+    for (int i = 0; i < context->numGlobals; i++) {
+        String ident = (String) getListElement(context->program->globalIdents, i);
+        String svalue = valueOfPValue(context->globals[i]);
+        String type = typeOfPValue(context->globals[i]);
+        printf("    %s: %s: %s\n", ident, svalue, type);
         stdfree(svalue);
-    ENDHASHTABLE
+    }
 }
 
 
@@ -4,7 +4,7 @@
 //  intrpevent.c has the built-in functions for events, dates and places.
 //
 //  Created by Thomas Wetmore on 17 March 2023.
-//  Last changed on 3 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "gnode.h"
@@ -13,6 +13,11 @@
 #include "pnode.h"
 #include "pvalue.h"
 #include "evaluate.h"
+#include "context.h"
+#include "database.h"
+#include "list.h"
+#include "placeindex.h"
+#include "vitalindex.h"
 
 static int daycode = 0;
 static int monthcode = 3;
@@ -46,6 +51,81 @@ PValue __year(PNode *pnode, Context *context, bool* errflg) {
     return createStringPValue(eventToDate(evnt.value.uGNode, true));
 }
 
+// __placecount returns the number of events in a place or in places within it.
+// usage: placecount(STRING) -> INT
+PValue __placecount(PNode *pnode, Context *context, bool* errflg) {
+    PValue pvalue = evaluate(pnode->arguments, context, errflg);
+    if (*errflg || pvalue.type != PVString || !pvalue.value.uString) {
+        *errflg = true;
+        scriptError(pnode, "the argument to placecount must be a string");
+        return nullPValue;
+    }
+    PlaceNode* node = searchPlaceIndex(context->database->placeIndex, pvalue.value.uString);
+    return PVALUE(PVInt, uInt, node ? node->totalEvents : 0);
+}
+
+// __topplaces fills a list with the places that have the most events, most first. With no level,
+// or level 0, places are ranked by the events that name them exactly; with level 1 only the last
+// segments of places, usually countries, are ranked, with level 2 the places one segment longer,
+// and so on, by the events in them and the places within them.
+// usage: topplaces(LIST, INT [,INT]) -> VOID
+PValue __topplaces(PNode *pnode, Context *context, bool* errflg) {
+    PNode* arg = pnode->arguments;
+    PValue lvalue = evaluate(arg, context, errflg);
+    if (*errflg || lvalue.type != PVList) {
+        *errflg = true;
+        scriptError(pnode, "the first argument to topplaces must be a list");
+        return nullPValue;
+    }
+    PValue cvalue = evaluate(arg = arg->next, context, errflg);
+    if (*errflg || cvalue.type != PVInt) {
+        *errflg = true;
+        scriptError(pnode, "the second argument to topplaces must be an integer");
+        return nullPValue;
+    }
+    int level = 0;
+    if ((arg = arg->next)) {
+        PValue pvalue = evaluate(arg, context, errflg);
+        if (*errflg || pvalue.type != PVInt) {
+            *errflg = true;
+            scriptError(pnode, "the third argument to topplaces must be an integer");
+            return nullPValue;
+        }
+        level = (int) pvalue.value.uInt;
+    }
+    List* list = lvalue.value.uList;
+    emptyList(list);
+    List* places = topPlaces(context->database->placeIndex, (int) cvalue.value.uInt, level);
+    FORLIST(places, element)
+        appendToList(list, allocPValue(PVString,
+                     (VUnion) { .uString = createPString(((PlaceNode*) element)->place) }));
+    ENDLIST
+    deleteList(places);
+    return nullPValue;
+}
+
+// __vitalyear returns the year of the first birth, christening, death, burial or marriage of a
+// person or family, from the dates parsed when the database was built; 0 if the year is unknown.
+// usage: vitalyear(INDI|FAM, STRING) -> INT
+PValue __vitalyear(PNode *pnode, Context *context, bool* errflg) {
+    PValue record = evaluate(pnode->arguments, context, errflg);
+    if (*errflg || !isRecordType(record.type)) {
+        *errflg = true;
+        scriptError(pnode, "the first argument to vitalyear must be a person or family");
+        return nullPValue;
+    }
+    PValue tag = evaluate(pnode->arguments->next, context, errflg);
+    VitalEvent event = numVitalEvents;
+    if (!*errflg && tag.type == PVString) event = tagToVitalEvent(tag.value.uString);
+    if (event == numVitalEvents) {
+        *errflg = true;
+        scriptError(pnode, "the second argument to vitalyear must be BIRT, CHR, DEAT, BURI or MARR");
+        return nullPValue;
+    }
+    int year = vitalYear(context->database->vitalIndex, record.value.uGNode, event);
+    return PVALUE(PVInt, uInt, year);
+}
+
 //  __long return the long form of an event as a string.
 //  usage: long(EVENT) -> STRING
 PValue __long(PNode *pnode, Context *context, bool* errflg) {
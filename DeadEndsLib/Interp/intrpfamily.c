@@ -4,7 +4,7 @@
 //  intrpfamily.c
 //
 //  Created by Thomas Wetmore on 17 March 2023.
-//  Last changed on 4 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "context.h"
@@ -59,7 +59,7 @@ PValue __nchildren (PNode* pnode, Context* context, bool* errflg) {
 	if (*errflg || !fam) return nullPValue;
 	int count = 0;
 	GNode* this = CHIL(fam);
-	while (this && eqstr("CHIL", this->tag)) {
+	while (this && this->tagId == tagCHIL) {
 		count++;
 		this = this->sibling;
 	}
@@ -92,7 +92,7 @@ PValue __lastchild(PNode* pnode, Context* context, bool* errflg) {
 // usage: fnode(FAM) -> NODE
 PValue __fnode(PNode* pnode, Context* context, bool* errflg) {
 	GNode *gnode = evaluateFamily(pnode->arguments, context, errflg);
-	if (*errflg || !gnode || nestr("FAM", gnode->tag)) {
+	if (*errflg || !gnode || gnode->tagId != tagFAM) {
 		*errflg = true;
 		scriptError(pnode, "the argument to fnode must be a family.");
 		return nullPValue;
@@ -4,7 +4,7 @@
 //  intrpmath.c has the built-in script functions for math and logic.
 //
 //  Created by Thomas Wetmore on 17 March 2023.
-//  Last changed on 13 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "context.h"
@@ -122,13 +122,11 @@ PValue __incr(PNode* pnode, Context* context, bool* errflg) {
     pnode = pnode->arguments; // Get ident.
     *errflg = true;
     if (pnode->type != PNIdent) return nullPValue;
-    String ident = pnode->identifier;
-    if (!ident)  return nullPValue;
-    PValue pvalue = getValueOfSymbol(context, ident);
+    PValue pvalue = getValueOfSlot(context, pnode->slot);
     if (pvalue.type != PVInt) return nullPValue;
     *errflg = false;
     pvalue.value.uInt += 1;
-    assignValueToSymbol(context, ident, pvalue);
+    assignValueToSlot(context, pnode->slot, pvalue);
     return nullPValue;
 }
 
@@ -138,13 +136,11 @@ PValue __decr(PNode* pnode, Context* context, bool* errflg) {
     pnode = pnode->arguments; // Get ident.
     *errflg = true;
     if (pnode->type != PNIdent) return nullPValue;
-    String ident = pnode->identifier;
-    if (!ident) return nullPValue;
-    PValue pvalue = getValueOfSymbol(context, ident);
+    PValue pvalue = getValueOfSlot(context, pnode->slot);
     if (pvalue.type != PVInt) return nullPValue;
     *errflg = false;
     pvalue.value.uInt -= 1;
-    assignValueToSymbol(context, ident, pvalue);
+    assignValueToSlot(context, pnode->slot, pvalue);
     return nullPValue;
 }
 
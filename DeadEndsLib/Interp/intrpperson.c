@@ -4,21 +4,25 @@
 //  intrpperson.c has the built-in script functions that deal with persons.
 //
 //  Created by Thomas Wetmore on 17 March 2023.
-//  Last changed on 4 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "context.h"
 #include "database.h"
 #include "evaluate.h"
 #include "gedcom.h"
+#include "generationindex.h"
 #include "gnode.h"
 #include "interp.h"
+#include "kinship.h"
 #include "lineage.h"
 #include "list.h"
 #include "name.h"
+#include "nameorder.h"
 #include "pnode.h"
 #include "pvalue.h"
 #include "recordindex.h"
+#include "relationship.h"
 #include "standard.h"
 
 // __name gets a person's name.
@@ -332,7 +336,7 @@ PValue __parents(PNode* pnode, Context* context, bool* eflg) {
 PValue __title(PNode* pnode, Context* context, bool* errflg) {
     GNode* gnode = evaluatePerson(pnode->arguments, context, errflg);
     if (*errflg || !gnode) return nullPValue;
-    gnode = findTag(gnode->child, "TITL");
+    gnode = findTagId(gnode->child, tagTITL);
     if (gnode && gnode->value) return createStringPValue(gnode->value);
     return nullPValue;
 }
@@ -341,7 +345,7 @@ PValue __title(PNode* pnode, Context* context, bool* errflg) {
 // usage: soundex(INDI) -> STRING
 PValue __soundex (PNode* pnode, Context* context, bool* eflg) {
     GNode* gnode = evaluatePerson(pnode->arguments, context, eflg);
-    if (*eflg || !gnode || nestr(gnode->tag, "INDI")) return nullPValue;
+    if (*eflg || !gnode || gnode->tagId != tagINDI) return nullPValue;
     if (!(gnode = NAME(gnode)) || !gnode->value) {
         *eflg = true;
         return nullPValue;
@@ -353,7 +357,7 @@ PValue __soundex (PNode* pnode, Context* context, bool* eflg) {
 // usage: inode(INDI) -> NODE
 PValue __inode(PNode* pnode, Context* context, bool* eflg) {
     GNode *gnode = evaluatePerson(pnode->arguments, context, eflg);
-    if (*eflg || !gnode || nestr("INDI", gnode->tag)) {
+    if (*eflg || !gnode || gnode->tagId != tagINDI) {
         *eflg = true;
         scriptError(pnode, "the argument to inode must be a person");
         return nullPValue;
@@ -457,3 +461,166 @@ PValue __lastindi(PNode* pnode, Context* context, bool* eflg) {
 	sortList(personRoots);
 	return PVALUE(PVPerson, uGNode, (GNode*) getListElement(personRoots, lengthList(personRoots) - 1));
 }
+
+// endIndiByName returns the first or last person in the database in name order.
+static PValue endIndiByName(PNode* pnode, Context* context, bool* eflg, bool first) {
+    NameOrder* order = context->database->nameOrder;
+    if (!order || order->numPersons == 0) {
+        *eflg = true;
+        scriptError(pnode, "There must be persons in the database to call %s.", pnode->funcName);
+        return nullPValue;
+    }
+    return PVALUE(PVPerson, uGNode, nameRankToPerson(order, first ? 0 : order->numPersons - 1));
+}
+
+// stepIndiByName returns the person that follows or precedes a person in name order.
+static PValue stepIndiByName(PNode* pnode, Context* context, bool* eflg, int step) {
+    GNode* indi = evaluatePerson(pnode->arguments, context, eflg);
+    if (*eflg || !indi) {
+        *eflg = true;
+        scriptError(pnode, "The argument to %s must be a person.", pnode->funcName);
+        return nullPValue;
+    }
+    NameOrder* order = context->database->nameOrder;
+    int rank = personToNameRank(order, indi);
+    if (rank < 0) {
+        *eflg = true;
+        scriptError(pnode, "The argument person isn't in the name order of the database.");
+        return nullPValue;
+    }
+    GNode* person = nameRankToPerson(order, rank + step);
+    if (!person) return nullPValue;
+    return PVALUE(PVPerson, uGNode, person);
+}
+
+// firstindibyname returns the first person in the database in name order.
+// usage: firstindibyname() -> INDI
+PValue __firstindibyname(PNode* pnode, Context* context, bool* eflg) {
+    return endIndiByName(pnode, context, eflg, true);
+}
+
+// nextindibyname returns the next person in the database in name order.
+// usage: nextindibyname(INDI) -> INDI
+PValue __nextindibyname(PNode* pnode, Context* context, bool* eflg) {
+    return stepIndiByName(pnode, context, eflg, 1);
+}
+
+// previndibyname returns the previous person in the database in name order.
+// usage: previndibyname(INDI) -> INDI
+PValue __previndibyname(PNode* pnode, Context* context, bool* eflg) {
+    return stepIndiByName(pnode, context, eflg, -1);
+}
+
+// lastindibyname returns the last person in the database in name order.
+// usage: lastindibyname() -> INDI
+PValue __lastindibyname(PNode* pnode, Context* context, bool* eflg) {
+    return endIndiByName(pnode, context, eflg, false);
+}
+
+// __relationship returns the relationship of the first person to the second, for example
+// "second cousin once removed". If a list is given the persons on the path from the first person
+// through the nearest common ancestor to the second are appended to it.
+// usage: relationship(INDI, INDI [,LIST]) -> STRING
+PValue __relationship(PNode* pnode, Context* context, bool* errflg) {
+    PNode* arg = pnode->arguments;
+    GNode* one = evaluatePerson(arg, context, errflg);
+    if (*errflg || !one) {
+        *errflg = true;
+        scriptError(pnode, "the first argument to relationship must be a person");
+        return nullPValue;
+    }
+    GNode* two = evaluatePerson(arg = arg->next, context, errflg);
+    if (*errflg || !two) {
+        *errflg = true;
+        scriptError(pnode, "the second argument to relationship must be a person");
+        return nullPValue;
+    }
+    List* list = null;
+    if ((arg = arg->next)) {
+        PValue pvalue = evaluate(arg, context, errflg);
+        if (*errflg || pvalue.type != PVList) {
+            *errflg = true;
+            scriptError(pnode, "the third argument to relationship must be a list");
+            return nullPValue;
+        }
+        list = pvalue.value.uList;
+    }
+    Relationship* relation = relatePersons(one, two, context->database->recordIndex);
+    if (list) {
+        FORLIST(relation->path, element)
+            PValue pvalue = PVALUE(PVPerson, uGNode, (GNode*) element);
+            appendToList(list, clonePValue(&pvalue));
+        ENDLIST
+    }
+    String string = relationshipToString(relation, one);
+    PValue result = createStringPValue(string);
+    stdfree(string);
+    deleteRelationship(relation);
+    return result;
+}
+
+// __kinship returns the kinship coefficient of two persons.
+// usage: kinship(INDI, INDI) -> FLOAT
+PValue __kinship(PNode* pnode, Context* context, bool* errflg) {
+    PNode* arg = pnode->arguments;
+    GNode* one = evaluatePerson(arg, context, errflg);
+    if (*errflg || !one) {
+        *errflg = true;
+        scriptError(pnode, "the first argument to kinship must be a person");
+        return nullPValue;
+    }
+    GNode* two = evaluatePerson(arg->next, context, errflg);
+    if (*errflg || !two) {
+        *errflg = true;
+        scriptError(pnode, "the second argument to kinship must be a person");
+        return nullPValue;
+    }
+    KinshipTable* table = getKinshipTable(context->database);
+    return PVALUE(PVFloat, uFloat, kinshipCoefficient(table, one, two));
+}
+
+// __inbreeding returns the inbreeding coefficient of a person.
+// usage: inbreeding(INDI) -> FLOAT
+PValue __inbreeding(PNode* pnode, Context* context, bool* errflg) {
+    GNode* indi = evaluatePerson(pnode->arguments, context, errflg);
+    if (*errflg || !indi) {
+        *errflg = true;
+        scriptError(pnode, "the argument to inbreeding must be a person");
+        return nullPValue;
+    }
+    KinshipTable* table = getKinshipTable(context->database);
+    return PVALUE(PVFloat, uFloat, inbreedingCoefficient(table, indi));
+}
+
+// __generation returns the generation of a person, the greatest number of generations from the
+// person back to a person with no parents.
+// usage: generation(INDI) -> INT
+PValue __generation(PNode* pnode, Context* context, bool* errflg) {
+    GNode* indi = evaluatePerson(pnode->arguments, context, errflg);
+    if (*errflg || !indi) {
+        *errflg = true;
+        scriptError(pnode, "the argument to generation must be a person");
+        return nullPValue;
+    }
+    return PVALUE(PVInt, uInt, personToGeneration(getGenerationIndex(context->database), indi));
+}
+
+// __mingeneration returns the fewest number of generations from a person back to a person with
+// no parents.
+// usage: mingeneration(INDI) -> INT
+PValue __mingeneration(PNode* pnode, Context* context, bool* errflg) {
+    GNode* indi = evaluatePerson(pnode->arguments, context, errflg);
+    if (*errflg || !indi) {
+        *errflg = true;
+        scriptError(pnode, "the argument to mingeneration must be a person");
+        return nullPValue;
+    }
+    return PVALUE(PVInt, uInt, personToMinGeneration(getGenerationIndex(context->database), indi));
+}
+
+// __numgenerations returns the number of generations in the database.
+// usage: numgenerations() -> INT
+PValue __numgenerations(PNode* pnode, Context* context, bool* errflg) {
+    GenerationIndex* index = getGenerationIndex(context->database);
+    return PVALUE(PVInt, uInt, index ? index->numGenerations : 0);
+}
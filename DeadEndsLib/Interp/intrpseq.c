@@ -5,20 +5,28 @@
 //  language this datatype is called an indiset. Each builtin calls one of the Sequence functions.
 //
 //  Created by Thomas Wetmore on 4 March 2023.
-//  Last changed on 15 August 2025.
+//  Last changed on 19 October 2026.
 //
 
+#include "collect.h"
 #include "context.h"
 #include "database.h"
 #include "evaluate.h"
+#include "file.h"
 #include "gedcom.h"
+#include "generationindex.h"
 #include "gnode.h"
+#include "list.h"
+#include "namesearch.h"
+#include "placeindex.h"
 #include "interp.h"
 #include "pnode.h"
 #include "pvalue.h"
 #include "sequence.h"
 #include "standard.h"
 #include "symboltable.h"
+#include "textindex.h"
+#include "vitalindex.h"
 
 // __indiset creates a sequence and assigns it to an identifier in a symbol table.
 // usage: indiset(IDEN) -> VOID
@@ -31,8 +39,9 @@ PValue __indiset(PNode* pnode, Context* context, bool* errorFlag) {
         return nullPValue;
     }
     *errorFlag = false;
-    assignValueToSymbol(context, arg->identifier,
-                        PVALUE(PVSequence, uSequence, createSequence(context->database->recordIndex)));
+    assignValueToSlot(context, arg->slot,
+                        trackAggregate(context,
+                        PVALUE(PVSequence, uSequence, createSequence(context->database->recordIndex))));
     return nullPValue;
 }
 
@@ -68,7 +77,6 @@ PValue __addtoset(PNode *pnode, Context *context, bool *errflg) {
         return nullPValue;
     }
     PValue *ppvalue = allocPValue(value.type, value.value); // Sequence PValues are in the heap.
-    if (ppvalue->type == PVString) ppvalue->value.uString = strsave(value.value.uString);
     appendToSequence(sequence, key, ppvalue);
     return nullPValue;
 }
@@ -157,7 +165,7 @@ PValue __namesort(PNode* pnode, Context* context, bool* errflg) {
         return nullPValue;
     }
     Sequence *sequence = value.value.uSequence;
-    nameSortSequence(sequence);
+    nameSortSequenceWithOrder(sequence, context->database->nameOrder);
     return nullPValue;
 }
 
@@ -199,7 +207,7 @@ PValue __uniqueset(PNode* pnode, Context* context, bool* eflg) {
         return nullPValue;
     }
     Sequence *sequence = value.value.uSequence;
-    return PVALUE(PVSequence, uSequence, uniqueSequence(sequence));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, uniqueSequence(sequence)));
 }
 
 // __union creates the union of two sequences.
@@ -218,7 +226,7 @@ PValue __union(PNode* pnode, Context* context, bool* eflg) {
         return nullPValue;
     }
     Sequence *op2 = val.value.uSequence;
-    return PVALUE(PVSequence, uSequence, unionSequence(op1, op2));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, unionSequence(op1, op2)));
 }
 
 // __intersect creates the intersection of two sequences.
@@ -237,7 +245,7 @@ PValue __intersect(PNode* pnode, Context* context, bool* eflg) {
         return nullPValue;
     }
     Sequence *op2 = val.value.uSequence;
-    return PVALUE(PVSequence, uSequence, intersectSequence(op1, op2));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, intersectSequence(op1, op2)));
 }
 
 // __difference create the difference of two sequences.
@@ -256,7 +264,7 @@ PValue __difference(PNode* pnode, Context* context, bool* eflg) {
         return nullPValue;
     }
     Sequence* op2 = val.value.uSequence;
-    return PVALUE(PVSequence, uSequence, differenceSequence(op1, op2));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, differenceSequence(op1, op2)));
 }
 
 // __parentset creates the parent sequence of a sequence.
@@ -268,7 +276,7 @@ PValue __parentset(PNode* pnode, Context* context, bool* eflg) {
         return nullPValue;
     }
     Sequence* seq = val.value.uSequence;
-    return PVALUE(PVSequence, uSequence, parentSequence(seq));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, parentSequence(seq)));
 }
 
 // __childset create the children sequence of a sequence.
@@ -280,7 +288,7 @@ PValue __childset(PNode* pnode, Context* context, bool* eflg) {
         return nullPValue;
     }
     Sequence *seq = val.value.uSequence;
-    return PVALUE(PVSequence, uSequence, childSequence(seq));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, childSequence(seq)));
 }
 
 // __siblingset creates the sibling sequence of a sequence.
@@ -292,7 +300,7 @@ PValue __siblingset(PNode *node, Context *context, bool *eflg) {
         return nullPValue;
     }
     Sequence *seq = val.value.uSequence;
-    return PVALUE(PVSequence, uSequence, siblingSequence(seq, false));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, siblingSequence(seq, false)));
 }
 
 // __spouseset create spouse sequence of a sequence.
@@ -304,7 +312,7 @@ PValue __spouseset(PNode* pnode, Context* context, bool* eflg) {
         return nullPValue;
     }
     Sequence *seq = val.value.uSequence;
-    return PVALUE(PVSequence, uSequence, spouseSequence(seq));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, spouseSequence(seq)));
 }
 
 // __ancestorset creates the ancestor sequence of a sequence.
@@ -316,7 +324,7 @@ PValue __ancestorset(PNode* pnode, Context* context, bool* errflag) {
         scriptError(pnode, "the argument to ancestorset must be a set.");
         return nullPValue;
     }
-    return PVALUE(PVSequence, uSequence, ancestorSequence(programValue.value.uSequence, false));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, ancestorSequence(programValue.value.uSequence, false)));
 }
 
 // __descendentset creates the descendent sequence of a sequence; two spellings allowed.
@@ -328,11 +336,12 @@ PValue __descendentset(PNode* pnode, Context* context, bool* eflg) {
         scriptError(pnode, "the arg to descendentset must be a set.");
         return nullPValue;
     }
-    return PVALUE(PVSequence, uSequence, descendentSequence(val.value.uSequence, false));
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, descendentSequence(val.value.uSequence, false)));
 }
 // __gengedcom -- Generate Gedcom output from a sequence.
 // usage: gengedcom(SET) -> VOID
 PValue __gengedcom(PNode *pnode, Context *context, bool *eflg) {
+    flushStdout();
     printf("Inside __gengedcom\n");
     ASSERT(pnode && pnode->arguments && !pnode->arguments->next && context);
 
@@ -347,3 +356,134 @@ PValue __gengedcom(PNode *pnode, Context *context, bool *eflg) {
     sequenceToGedcom(val.value.uSequence, null);  // Null sends to stdout.
     return nullPValue;
 }
+
+// __generationset returns the set of persons in a generation, in ancestor first order. Looping
+// over the generations from 0 to numgenerations() - 1 visits every person after their parents.
+// usage: generationset(INT) -> SET
+PValue __generationset(PNode* pnode, Context* context, bool* errflg) {
+    PValue pvalue = evaluate(pnode->arguments, context, errflg);
+    if (*errflg || pvalue.type != PVInt) {
+        *errflg = true;
+        scriptError(pnode, "the argument to generationset must be an integer");
+        return nullPValue;
+    }
+    Sequence* sequence = createSequence(context->database->recordIndex);
+    FORGENERATION(getGenerationIndex(context->database), (int) pvalue.value.uInt, person)
+        appendToSequence(sequence, person->key, null);
+    ENDGENERATION
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, sequence));
+}
+
+// __placeset returns the set of records with events in a place or in places within it, in key
+// order. The place is matched by its segments, so "Ohio, USA" matches every place in Ohio.
+// usage: placeset(STRING) -> SET
+PValue __placeset(PNode* pnode, Context* context, bool* errflg) {
+    PValue pvalue = evaluate(pnode->arguments, context, errflg);
+    if (*errflg || pvalue.type != PVString || !pvalue.value.uString) {
+        *errflg = true;
+        scriptError(pnode, "the argument to placeset must be a string");
+        return nullPValue;
+    }
+    Sequence* sequence = createSequence(context->database->recordIndex);
+    PlaceNode* node = searchPlaceIndex(context->database->placeIndex, pvalue.value.uString);
+    List* events = placeNodeToEvents(node);
+    FORLIST(events, element)
+        GNode* root = (GNode*) element;
+        while (root->parent) root = root->parent;
+        appendToSequence(sequence, root->key, null);
+    ENDLIST
+    deleteList(events);
+    uniqueSequenceInPlace(sequence);
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, sequence));
+}
+
+// __textsearch returns the set of records whose notes, texts, sources or places match a query, in
+// the order persons, families, sources, events, others. All the words and quoted phrases of the
+// query must match; OR separates alternatives, as in: textsearch("\"county clerk\" OR sheriff").
+// usage: textsearch(STRING) -> SET
+PValue __textsearch(PNode* pnode, Context* context, bool* errflg) {
+    PValue pvalue = evaluate(pnode->arguments, context, errflg);
+    if (*errflg || pvalue.type != PVString || !pvalue.value.uString) {
+        *errflg = true;
+        scriptError(pnode, "the argument to textsearch must be a string");
+        return nullPValue;
+    }
+    List* keys = searchText(getTextIndex(context->database), pvalue.value.uString);
+    if (!keys) {
+        *errflg = true;
+        scriptError(pnode, "a phrase in a textsearch query can have at most %d words", MAXPHRASEWORDS);
+        return nullPValue;
+    }
+    Sequence* sequence = createSequence(context->database->recordIndex);
+    FORLIST(keys, key)
+        appendToSequence(sequence, (String) key, null);
+    ENDLIST
+    deleteList(keys);
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, sequence));
+}
+
+// __vitalset returns the set of persons whose first births, christenings, deaths or burials, or
+// the families whose first marriages, are in a range of years, in year order. The value of each
+// element is its year. The tag is BIRT, CHR, DEAT, BURI or MARR.
+// usage: vitalset(STRING, INT, INT) -> SET
+PValue __vitalset(PNode* pnode, Context* context, bool* errflg) {
+    PNode* arg = pnode->arguments;
+    PValue tag = evaluate(arg, context, errflg);
+    VitalEvent event = numVitalEvents;
+    if (!*errflg && tag.type == PVString) event = tagToVitalEvent(tag.value.uString);
+    if (event == numVitalEvents) {
+        *errflg = true;
+        scriptError(pnode, "the first argument to vitalset must be BIRT, CHR, DEAT, BURI or MARR");
+        return nullPValue;
+    }
+    PValue first = evaluate(arg = arg->next, context, errflg);
+    if (*errflg || first.type != PVInt) {
+        *errflg = true;
+        scriptError(pnode, "the second argument to vitalset must be an integer");
+        return nullPValue;
+    }
+    PValue last = evaluate(arg->next, context, errflg);
+    if (*errflg || last.type != PVInt) {
+        *errflg = true;
+        scriptError(pnode, "the third argument to vitalset must be an integer");
+        return nullPValue;
+    }
+    Sequence* sequence = createSequence(context->database->recordIndex);
+    FORVITALYEARS(context->database->vitalIndex, event, (int) first.value.uInt,
+                  (int) last.value.uInt, record, year)
+        appendToSequence(sequence, record->key, allocPValue(PVInt, (VUnion) { .uInt = year }));
+    ENDVITALYEARS
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, sequence));
+}
+
+// __namesearch returns the set of persons whose surnames or given names match all the words of a
+// string, best matches first. The optional integer chooses the kinds of matches: 1 for prefix,
+// 2 for substring, 4 for one typing error, or a sum of them; the default is all three.
+// usage: namesearch(STRING [,INT]) -> SET
+PValue __namesearch(PNode* pnode, Context* context, bool* errflg) {
+    PNode* arg = pnode->arguments;
+    PValue pvalue = evaluate(arg, context, errflg);
+    if (*errflg || pvalue.type != PVString || !pvalue.value.uString) {
+        *errflg = true;
+        scriptError(pnode, "the first argument to namesearch must be a string");
+        return nullPValue;
+    }
+    String query = pvalue.value.uString;
+    int types = nameSearchAll;
+    if ((arg = arg->next)) {
+        PValue tvalue = evaluate(arg, context, errflg);
+        if (*errflg || tvalue.type != PVInt) {
+            *errflg = true;
+            scriptError(pnode, "the second argument to namesearch must be an integer");
+            return nullPValue;
+        }
+        types = (int) tvalue.value.uInt;
+    }
+    List* keys = searchNames(getNameSearchIndex(context->database), query, types);
+    Sequence* sequence = createSequence(context->database->recordIndex);
+    FORLIST(keys, key)
+        appendToSequence(sequence, (String) key, null);
+    ENDLIST
+    deleteList(keys);
+    return trackAggregate(context, PVALUE(PVSequence, uSequence, sequence));
+}
@@ -0,0 +1,251 @@
+//
+//  DeadEnds Library
+//
+//  optimize.c has the optimizer, which simplifies the PNode trees of a Program after it is
+//  parsed. Calls of pure builtins with constant arguments, such as nl(), d(1) and concat of
+//  literals, are replaced by their values. If and while statements with constant conditions
+//  lose their dead branches. Adjacent String statements are merged, so "Hello" sp() name nl()
+//  writes two Strings instead of four.
+//
+//  Pure builtins with other arguments are left alone. Any statement, including a call to a
+//  procedure that sets a global, can change a variable, so their values can't be moved out of
+//  loops.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "context.h"
+#include "evaluate.h"
+#include "functiontable.h"
+#include "hashtable.h"
+#include "interp.h"
+#include "optimize.h"
+#include "pnode.h"
+#include "pvalue.h"
+#include "standard.h"
+
+static bool debugging = false;
+bool optimizing = true;
+
+// ArgType is the type of constant arguments a pure builtin is folded with.
+typedef enum ArgType {
+	AnyArgs,   // The builtin never reports an error.
+	StringArgs // The builtin reports arguments that are not Strings.
+} ArgType;
+
+// PureBuiltin is a builtin whose value depends only on its arguments.
+typedef struct PureBuiltin {
+	String name;
+	ArgType argType;
+} PureBuiltin;
+
+static PureBuiltin pureBuiltins[] = {
+	{"add", AnyArgs}, {"alpha", AnyArgs}, {"and", AnyArgs}, {"capitalize", AnyArgs},
+	{"card", AnyArgs}, {"concat", AnyArgs}, {"d", AnyArgs}, {"div", AnyArgs}, {"eq", AnyArgs},
+	{"eqstr", StringArgs}, {"ge", AnyArgs}, {"gt", AnyArgs}, {"le", AnyArgs}, {"lower", AnyArgs},
+	{"lt", AnyArgs}, {"mod", AnyArgs}, {"mul", AnyArgs}, {"ne", AnyArgs}, {"neg", AnyArgs},
+	{"nestr", StringArgs}, {"nl", AnyArgs}, {"not", AnyArgs}, {"or", AnyArgs}, {"ord", AnyArgs},
+	{"qt", AnyArgs}, {"roman", AnyArgs}, {"save", StringArgs}, {"sp", AnyArgs},
+	{"strcmp", StringArgs}, {"strconcat", AnyArgs}, {"strlen", StringArgs},
+	{"strsave", StringArgs}, {"sub", AnyArgs}, {"upper", AnyArgs}
+};
+static int numPureBuiltins = sizeof(pureBuiltins)/sizeof(pureBuiltins[0]);
+
+// Optimizer holds the state of the optimizer while it optimizes a Program.
+typedef struct Optimizer {
+	Context* context; // Context the folded builtins are called in; it has no Frames.
+	int numFolded;    // Builtin calls replaced by their values.
+	int numDropped;   // Dead if and while statements.
+	int numMerged;    // String statements merged into the one before.
+} Optimizer;
+
+// findPureBuiltin returns the PureBuiltin with a name; null if the builtin is not pure.
+static PureBuiltin* findPureBuiltin(String name) {
+	for (int i = 0; i < numPureBuiltins; i++) {
+		if (eqstr(pureBuiltins[i].name, name)) return &pureBuiltins[i];
+	}
+	return null;
+}
+
+// isConstant returns true if a PNode is an integer, float or String constant.
+static bool isConstant(PNode* pnode) {
+	return pnode->type == PNICons || pnode->type == PNFCons || pnode->type == PNSCons;
+}
+
+// isFoldable returns true if a PNode is a call of a pure builtin with constant arguments.
+static bool isFoldable(PNode* pnode) {
+	if (pnode->type != PNBltinCall) return false;
+	PureBuiltin* builtin = findPureBuiltin(pnode->funcName);
+	if (!builtin) return false;
+	for (PNode* arg = pnode->arguments; arg; arg = arg->next) {
+		if (!isConstant(arg)) return false;
+		if (builtin->argType == StringArgs && arg->type != PNSCons) return false;
+	}
+	return true;
+}
+
+// foldBuiltin replaces a call of a pure builtin with constant arguments by a constant PNode
+// holding its value. Calls with boolean and null values, and calls that fail, are left alone.
+static void foldBuiltin(Optimizer* optimizer, PNode* pnode) {
+	if (!isFoldable(pnode)) return;
+	bool errflg = false;
+	PValue pvalue = evaluateBuiltin(pnode, optimizer->context, &errflg);
+	bool folds = !errflg && (pvalue.type == PVInt || pvalue.type == PVFloat ||
+							 (pvalue.type == PVString && pvalue.value.uString));
+	if (!folds) {
+		clearPValue(&pvalue);
+		return;
+	}
+	if (debugging) printf("foldBuiltin: %s at line %d.\n", pnode->funcName, pnode->lineNumber);
+	stdfree(pnode->funcName);
+	freePNodes(pnode->arguments);
+	pnode->arguments = null;
+	pnode->builtinFunc = null;
+	switch (pvalue.type) {
+	case PVInt:
+		pnode->type = PNICons;
+		pnode->intCons = pvalue.value.uInt;
+		pnode->stringCons = null;
+		break;
+	case PVFloat:
+		pnode->type = PNFCons;
+		pnode->floatCons = pvalue.value.uFloat;
+		pnode->stringCons = null;
+		break;
+	default:
+		pnode->type = PNSCons;
+		pnode->stringCons = pvalue.value.uString; // Takes the reference.
+		break;
+	}
+	optimizer->numFolded++;
+}
+
+// optimizeExpressions folds the builtin calls in a list of expressions and the expressions
+// below them.
+static void optimizeExpressions(Optimizer* optimizer, PNode* pnode) {
+	for (; pnode; pnode = pnode->next) {
+		if (pnode->type != PNBltinCall && pnode->type != PNFuncCall && pnode->type != PNProcCall)
+			continue;
+		optimizeExpressions(optimizer, pnode->arguments);
+		if (pnode->type == PNBltinCall) foldBuiltin(optimizer, pnode);
+	}
+}
+
+// constantCondition returns true if the condition of an if or while statement is constant, and
+// returns its value through the last parameter. Conditions that assign a variable are not.
+static bool constantCondition(Optimizer* optimizer, PNode* cond, bool* value) {
+	if (!cond || cond->next) return false;
+	if (!isConstant(cond) && !isFoldable(cond)) return false;
+	bool errflg = false;
+	*value = evaluateConditional(cond, optimizer->context, &errflg);
+	return !errflg;
+}
+
+// removeStatement replaces the statement at a link with the statements of one of its branches,
+// which may be null, and frees it. Returns the link that follows the branch.
+static PNode** removeStatement(PNode** link, PNode* branch, PNode* parent) {
+	PNode* pnode = *link;
+	*link = pnode->next;
+	pnode->next = null;
+	freePNodes(pnode);
+	if (!branch) return link;
+	PNode* last = branch;
+	for (PNode* state = branch; state; state = state->next) {
+		state->parent = parent;
+		last = state;
+	}
+	last->next = *link;
+	*link = branch;
+	return &(last->next);
+}
+
+// mergeStrings merges adjacent String statements in a list of statements.
+static void mergeStrings(Optimizer* optimizer, PNode* pnode) {
+	for (; pnode; pnode = pnode->next) {
+		while (pnode->type == PNSCons && pnode->next && pnode->next->type == PNSCons) {
+			PNode* second = pnode->next;
+			int length = (int) strlen(pnode->stringCons);
+			String string = (String) stdalloc(length + strlen(second->stringCons) + 1);
+			strcpy(string, pnode->stringCons);
+			strcpy(string + length, second->stringCons);
+			releasePString(pnode->stringCons);
+			pnode->stringCons = createPString(string);
+			stdfree(string);
+			pnode->next = second->next;
+			second->next = null;
+			freePNodes(second);
+			optimizer->numMerged++;
+		}
+	}
+}
+
+// optimizeStatements optimizes a list of statements and the statements below them. The parent
+// is the PNode that holds the list. A list left empty gets a 0, which interpret ignores, since
+// lists of statements may not be empty.
+static void optimizeStatements(Optimizer* optimizer, PNode** list, PNode* parent) {
+	PNode** link = list;
+	while (*link) {
+		PNode* pnode = *link;
+		bool cond;
+		optimizeExpressions(optimizer, pnode->expression);
+		switch (pnode->type) {
+		case PNBltinCall:
+			optimizeExpressions(optimizer, pnode->arguments);
+			foldBuiltin(optimizer, pnode);
+			break;
+		case PNProcCall:
+		case PNFuncCall:
+			optimizeExpressions(optimizer, pnode->arguments);
+			break;
+		case PNIf:
+			optimizeStatements(optimizer, &(pnode->thenState), pnode);
+			if (pnode->elseState) optimizeStatements(optimizer, &(pnode->elseState), pnode);
+			if (constantCondition(optimizer, pnode->condExpr, &cond)) {
+				PNode* branch = cond ? pnode->thenState : pnode->elseState;
+				if (cond) pnode->thenState = null;
+				else pnode->elseState = null;
+				link = removeStatement(link, branch, parent); // The branch is optimized.
+				optimizer->numDropped++;
+				continue;
+			}
+			break;
+		case PNWhile:
+			optimizeStatements(optimizer, &(pnode->loopState), pnode);
+			if (constantCondition(optimizer, pnode->condExpr, &cond) && !cond) {
+				link = removeStatement(link, null, parent);
+				optimizer->numDropped++;
+				continue;
+			}
+			break;
+		default: // Loops have statements; other statements don't.
+			if (pnode->loopState) optimizeStatements(optimizer, &(pnode->loopState), pnode);
+			break;
+		}
+		link = &(pnode->next);
+	}
+	if (!*list) {
+		*list = iconsPNode(0);
+		(*list)->parent = parent;
+		(*list)->fileName = parent->fileName;
+		(*list)->lineNumber = parent->lineNumber;
+	}
+	mergeStrings(optimizer, *list);
+}
+
+// optimizeProgram optimizes the procedures and functions of a Program.
+void optimizeProgram(Program* program) {
+	if (!optimizing) return;
+	Optimizer optimizer = { createContext(program, null, null), 0, 0, 0 };
+	FORHASHTABLE(program->procedures, element)
+		PNode* proc = ((FunctionElement*) element)->function;
+		optimizeStatements(&optimizer, &(proc->procBody), proc);
+	ENDHASHTABLE
+	FORHASHTABLE(program->functions, element)
+		PNode* func = ((FunctionElement*) element)->function;
+		optimizeStatements(&optimizer, &(func->funcBody), func);
+	ENDHASHTABLE
+	deleteContext(optimizer.context);
+	if (debugging) printf("optimizeProgram: %d folded, %d dropped, %d merged.\n",
+						  optimizer.numFolded, optimizer.numDropped, optimizer.numMerged);
+}
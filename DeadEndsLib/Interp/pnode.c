@@ -4,16 +4,18 @@
 //  pnode.c holds the functions that manage PNodes (program nodes).
 //
 //  Created by Thomas Wetmore on 14 December 2022.
-//  Last changed on 3 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "pnode.h"
 #include "standard.h"
+#include "compile.h"
 #include "hashtable.h"
 #include "functiontable.h"
 #include "gedcom.h"
 #include "interp.h"
 #include "pvalue.h"
+#include "resolver.h"
 
 static bool debugging = false;
 
@@ -72,6 +74,7 @@ static void setParents(PNode* list, PNode* parent); // Set the parents of a PNod
 // allocPNode allocates a PNode and sets the type, fileName and lineNum fields.
 static PNode* allocPNode(int type) {
     PNode* node = (PNode*) stdalloc(sizeof(*node));
+    memset(node, 0, sizeof(*node)); // Fields a node type does not use must be null.
     if (debugging) {
         printf("allocPNode(%d) %s, %d\n", type, curFileName, curLine);
     }
@@ -79,6 +82,9 @@ static PNode* allocPNode(int type) {
     // Warning: curFileName may be freed in a later version of DeadEnds.
     node->fileName = curFileName;
     node->lineNumber = curLine; // Overwritten by the yacc m production?
+    node->slot = node->slotOne = node->slotTwo = node->slotThree = NOSLOT;
+    node->numSlots = 0;
+    node->slotNames = null;
     return node;
 }
 
@@ -99,7 +105,8 @@ PNode* fconsPNode(double floatConstant) {
 // sconsPNode creates a String PNode.
 PNode* sconsPNode(String string) {
     PNode *pnode = allocPNode(PNSCons);
-    pnode->stringCons = string;
+    pnode->stringCons = createPString(string); // Evaluations share it.
+    stdfree(string);
     return pnode;
 }
 
@@ -417,8 +424,10 @@ void freePNodes(PNode *pnode) {
         case PNICons: break;
         case PNFCons: break;
         case PNSCons:
+            releasePString(pnode->stringCons);
+            break;
         case PNIdent:
-            stdfree(pnode->stringCons);
+            stdfree(pnode->identifier);
             break;
         case PNIf:
             freePNodes(pnode->condExpr);
@@ -437,18 +446,22 @@ void freePNodes(PNode *pnode) {
                 freePNodes(pnode->returnExpr);
             break;
         case PNProcDef:
+            if (pnode->slotNames) stdfree(pnode->slotNames);
             stdfree(pnode->procName);
             freePNodes(pnode->parameters);
             freePNodes(pnode->procBody);
+            if (pnode->code) deleteCode(pnode->code);
             break;
         case PNProcCall:
             stdfree(pnode->procName);
             freePNodes(pnode->arguments);
             break;
         case PNFuncDef:
+            if (pnode->slotNames) stdfree(pnode->slotNames);
             stdfree(pnode->funcName);
             freePNodes(pnode->parameters);
             freePNodes(pnode->funcBody);
+            if (pnode->code) deleteCode(pnode->code);
             break;
         case PNFuncCall:
         case PNBltinCall:
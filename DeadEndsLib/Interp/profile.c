@@ -0,0 +1,406 @@
+//
+//  DeadEnds Library
+//
+//  profile.c has the script profiler. When profileScripts is set runProgram profiles the script
+//  it runs. Each line of the script gets the number of times its statements ran and the time
+//  spent in them, including the builtins they called but not the procedures and functions they
+//  called. Each procedure and function gets its number of calls, and its inclusive and exclusive
+//  times; the inclusive time of a recursive routine is counted only for its outermost call. Each
+//  builtin gets its number of calls, and its inclusive and exclusive times.
+//
+//  A line is timed from the start of one of its statements to the start of the next statement,
+//  so the work a loop does between iterations is given to the last line of its body.
+//
+//  If profileStacksFile is set the run time stack is also sampled. A profiling timer signal
+//  copies the definitions on the stack, and the line being run, into a buffer allocated when the
+//  profile begins; no thread is used and the handler doesn't allocate. At the end the samples are
+//  written in the folded format that flame graph tools read, one stack and its count per line.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include <signal.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <time.h>
+#include "context.h"
+#include "frame.h"
+#include "hashtable.h"
+#include "integertable.h"
+#include "path.h"
+#include "pnode.h"
+#include "profile.h"
+#include "standard.h"
+
+bool profileScripts = false;
+String profileStacksFile = null;
+bool profiling = false;
+
+#define MAXSAMPLES (1 << 20) // PNodes the sample buffer holds.
+#define SAMPLEMICROS 1000 // Microseconds of run time between samples.
+#define MAXREPORTLINES 40 // Lines in the report.
+#define MAXSTACKLENGTH 4096 // Length of a folded stack.
+
+// ProfileEntry holds the counts and times of a line, routine or builtin. Times are nanoseconds.
+typedef struct ProfileEntry {
+	void* key; // Statement, definition or builtin function.
+	PNode* pnode; // Statement, definition or first call.
+	long count; // Statements run or calls.
+	int64_t inclusive; // Time in the routine or builtin and all it called.
+	int64_t exclusive; // Time in the line, routine or builtin itself.
+	int active; // Calls on the profile stack.
+} ProfileEntry;
+
+// ProfileTable is a hash table that maps keys to ProfileEntries.
+typedef struct ProfileTable {
+	ProfileEntry** entries;
+	int size; // A power of two.
+	int length;
+} ProfileTable;
+
+// Activation is a call of a routine or builtin on the profile stack.
+typedef struct Activation {
+	ProfileEntry* entry;
+	int64_t start;
+	int64_t childTime; // Time in the routines and builtins it called.
+	ProfileEntry* line; // Line of the caller of a routine.
+} Activation;
+
+static ProfileTable lines;
+static ProfileTable routines;
+static ProfileTable builtins;
+static Activation* stack = null;
+static int depth = 0;
+static int maxDepth = 0;
+static ProfileEntry* volatile curLine = null; // Line being run.
+static int64_t lineStart; // When the line being run was last started or resumed.
+static int64_t profileStart;
+
+// Samples are definitions and statements from the top of the stack down, ended by null.
+static Context* sampledContext = null;
+static PNode** samples = null;
+static volatile sig_atomic_t numSamples = 0;
+static volatile sig_atomic_t droppedSamples = 0;
+static struct sigaction oldAction; // SIGPROF action before sampling.
+
+// now returns the time in nanoseconds.
+static int64_t now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (int64_t) time.tv_sec*1000000000 + time.tv_nsec;
+}
+
+// hashKey returns the hash of a key.
+static unsigned hashKey(void* key) {
+	return (unsigned) (((uintptr_t) key >> 4)*2654435761u);
+}
+
+// growTable doubles the size of a ProfileTable.
+static void growTable(ProfileTable* table) {
+	int size = table->size ? 2*table->size : 256;
+	ProfileEntry** entries = (ProfileEntry**) stdalloc(size*sizeof(ProfileEntry*));
+	memset(entries, 0, size*sizeof(ProfileEntry*));
+	for (int i = 0; i < table->size; i++) {
+		ProfileEntry* entry = table->entries[i];
+		if (!entry) continue;
+		unsigned j = hashKey(entry->key) & (size - 1);
+		while (entries[j]) j = (j + 1) & (size - 1);
+		entries[j] = entry;
+	}
+	if (table->entries) stdfree(table->entries);
+	table->entries = entries;
+	table->size = size;
+}
+
+// findEntry returns the ProfileEntry of a key, creating it if needed.
+static ProfileEntry* findEntry(ProfileTable* table, void* key, PNode* pnode) {
+	if (2*(table->length + 1) > table->size) growTable(table);
+	unsigned mask = table->size - 1;
+	unsigned i = hashKey(key) & mask;
+	ProfileEntry* entry;
+	while ((entry = table->entries[i])) {
+		if (entry->key == key) return entry;
+		i = (i + 1) & mask;
+	}
+	entry = (ProfileEntry*) stdalloc(sizeof(ProfileEntry));
+	memset(entry, 0, sizeof(ProfileEntry));
+	entry->key = key;
+	entry->pnode = pnode;
+	table->entries[i] = entry;
+	table->length++;
+	return entry;
+}
+
+// freeTable frees the ProfileEntries of a ProfileTable.
+static void freeTable(ProfileTable* table) {
+	for (int i = 0; i < table->size; i++) {
+		if (table->entries[i]) stdfree(table->entries[i]);
+	}
+	if (table->entries) stdfree(table->entries);
+	*table = (ProfileTable) { null, 0, 0 };
+}
+
+// chargeLine gives the time since the line being run was started or resumed to the line.
+static void chargeLine(int64_t time) {
+	if (curLine) curLine->exclusive += time - lineStart;
+	lineStart = time;
+}
+
+// pushActivation pushes a call of a routine or builtin on the profile stack.
+static void pushActivation(ProfileEntry* entry, int64_t time) {
+	if (depth >= maxDepth) {
+		maxDepth = maxDepth ? 2*maxDepth : 64;
+		Activation* activations = (Activation*) stdalloc(maxDepth*sizeof(Activation));
+		if (stack) {
+			memcpy(activations, stack, depth*sizeof(Activation));
+			stdfree(stack);
+		}
+		stack = activations;
+	}
+	entry->count++;
+	entry->active++;
+	stack[depth++] = (Activation) { entry, time, 0, curLine };
+}
+
+// popActivation pops a call of a routine or builtin from the profile stack and adds its times.
+static Activation* popActivation(int64_t time) {
+	Activation* activation = &stack[--depth];
+	ProfileEntry* entry = activation->entry;
+	int64_t elapsed = time - activation->start;
+	entry->exclusive += elapsed - activation->childTime;
+	if (--entry->active == 0) entry->inclusive += elapsed;
+	if (depth) stack[depth - 1].childTime += elapsed;
+	return activation;
+}
+
+// takeSample is the profiling timer's signal handler. It copies the line being run and the
+// definitions of the Frames on the run time stack into the samples.
+static void takeSample(int number) {
+	int length = numSamples;
+	ProfileEntry* line = curLine;
+	int needed = line ? 2 : 1;
+	for (Frame* frame = sampledContext->frame; frame; frame = frame->caller) needed++;
+	if (length + needed > MAXSAMPLES) {
+		droppedSamples++;
+		return;
+	}
+	if (line) samples[length++] = line->pnode;
+	for (Frame* frame = sampledContext->frame; frame; frame = frame->caller)
+		samples[length++] = frame->defn;
+	samples[length++] = null;
+	numSamples = length;
+}
+
+// startSampling starts the profiling timer that samples the run time stack of a Context.
+static void startSampling(Context* context) {
+	sampledContext = context;
+	samples = (PNode**) stdalloc(MAXSAMPLES*sizeof(PNode*));
+	numSamples = droppedSamples = 0;
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = takeSample;
+	action.sa_flags = SA_RESTART; // Reads and writes of the script are not interrupted.
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGPROF, &action, &oldAction);
+	struct itimerval timer = { { 0, SAMPLEMICROS }, { 0, SAMPLEMICROS } };
+	setitimer(ITIMER_PROF, &timer, null);
+}
+
+// stopSampling stops the profiling timer and restores the SIGPROF action. A SIGPROF still
+// pending is discarded by ignoring it first; the default action would end the process.
+static void stopSampling(void) {
+	struct itimerval timer = { { 0, 0 }, { 0, 0 } };
+	setitimer(ITIMER_PROF, &timer, null);
+	struct sigaction ignore;
+	memset(&ignore, 0, sizeof(ignore));
+	ignore.sa_handler = SIG_IGN;
+	sigemptyset(&ignore.sa_mask);
+	sigaction(SIGPROF, &ignore, null);
+	sigaction(SIGPROF, &oldAction, null);
+	sampledContext = null;
+}
+
+// beginProfile begins the profile of the script a Context runs.
+void beginProfile(Context* context) {
+	depth = 0;
+	curLine = null;
+	profileStart = lineStart = now();
+	if (profileStacksFile) startSampling(context);
+	profiling = true;
+}
+
+// profileLine is called before a statement is run.
+void profileLine(PNode* pnode) {
+	chargeLine(now());
+	ProfileEntry* entry = findEntry(&lines, pnode, pnode);
+	entry->count++;
+	curLine = entry;
+}
+
+// enterRoutine is called with the definition of a procedure or function before its body is run.
+void enterRoutine(PNode* defn) {
+	int64_t time = now();
+	chargeLine(time);
+	pushActivation(findEntry(&routines, defn, defn), time);
+	curLine = null;
+}
+
+// leaveRoutine is called after the body of a procedure or function is run.
+void leaveRoutine(void) {
+	int64_t time = now();
+	chargeLine(time);
+	curLine = popActivation(time)->line;
+}
+
+// profileBuiltin calls a builtin and times it.
+PValue profileBuiltin(PNode* pnode, Context* context, bool* errflg) {
+	pushActivation(findEntry(&builtins, pnode->builtinFunc, pnode), now());
+	PValue pvalue = (*(BIFunc) pnode->builtinFunc)(pnode, context, errflg);
+	popActivation(now());
+	return pvalue;
+}
+
+// msecs converts nanoseconds to milliseconds.
+static double msecs(int64_t time) {
+	return (double) time/1000000.0;
+}
+
+// tableEntries returns the ProfileEntries of a ProfileTable in an array.
+static ProfileEntry** tableEntries(ProfileTable* table) {
+	ProfileEntry** entries = (ProfileEntry**) stdalloc((table->length + 1)*sizeof(ProfileEntry*));
+	int length = 0;
+	for (int i = 0; i < table->size; i++) {
+		if (table->entries[i]) entries[length++] = table->entries[i];
+	}
+	return entries;
+}
+
+// compareInclusive orders ProfileEntries by decreasing inclusive time.
+static int compareInclusive(const void* a, const void* b) {
+	int64_t one = (*(ProfileEntry**) a)->inclusive, two = (*(ProfileEntry**) b)->inclusive;
+	return one > two ? -1 : one < two;
+}
+
+// compareExclusive orders ProfileEntries by decreasing exclusive time.
+static int compareExclusive(const void* a, const void* b) {
+	int64_t one = (*(ProfileEntry**) a)->exclusive, two = (*(ProfileEntry**) b)->exclusive;
+	return one > two ? -1 : one < two;
+}
+
+// compareLines orders ProfileEntries by the file names and line numbers of their statements.
+static int compareLines(const void* a, const void* b) {
+	PNode* one = (*(ProfileEntry**) a)->pnode;
+	PNode* two = (*(ProfileEntry**) b)->pnode;
+	int rc = strcmp(one->fileName ? one->fileName : "", two->fileName ? two->fileName : "");
+	if (rc) return rc;
+	return one->lineNumber < two->lineNumber ? -1 : one->lineNumber > two->lineNumber;
+}
+
+// lineName returns the file name and line number of a statement.
+static String lineName(PNode* pnode, char* buffer, int length) {
+	snprintf(buffer, length, "%s:%d", pnode->fileName ? lastPathSegment(pnode->fileName) : "",
+			 pnode->lineNumber);
+	return buffer;
+}
+
+// writeCalls writes the counts and times of the routines or builtins of a ProfileTable.
+static void writeCalls(FILE* file, String title, ProfileTable* table,
+					   int (*compare)(const void*, const void*)) {
+	ProfileEntry** entries = tableEntries(table);
+	qsort(entries, table->length, sizeof(ProfileEntry*), compare);
+	fprintf(file, "\n%-32s %10s %12s %12s\n", title, "calls", "inclusive", "exclusive");
+	for (int i = 0; i < table->length; i++) {
+		ProfileEntry* entry = entries[i];
+		fprintf(file, "  %-30s %10ld %12.3f %12.3f\n", entry->pnode->funcName, entry->count,
+				msecs(entry->inclusive), msecs(entry->exclusive));
+	}
+	stdfree(entries);
+}
+
+// writeLines writes the counts and times of the lines that took the most time. Statements on
+// the same line are merged.
+static void writeLines(FILE* file) {
+	ProfileEntry** entries = tableEntries(&lines);
+	qsort(entries, lines.length, sizeof(ProfileEntry*), compareLines);
+	int length = 0;
+	for (int i = 0; i < lines.length; i++) {
+		if (length && !compareLines(&entries[length - 1], &entries[i])) {
+			entries[length - 1]->count += entries[i]->count;
+			entries[length - 1]->exclusive += entries[i]->exclusive;
+			continue;
+		}
+		entries[length++] = entries[i];
+	}
+	qsort(entries, length, sizeof(ProfileEntry*), compareExclusive);
+	fprintf(file, "\n%-32s %10s %12s\n", "line", "count", "time");
+	char buffer[MAXSTACKLENGTH];
+	for (int i = 0; i < length && i < MAXREPORTLINES; i++) {
+		fprintf(file, "  %-30s %10ld %12.3f\n", lineName(entries[i]->pnode, buffer, MAXSTACKLENGTH),
+				entries[i]->count, msecs(entries[i]->exclusive));
+	}
+	stdfree(entries);
+}
+
+// writeStacks folds the samples into stacks, from main down, with their counts and writes them.
+static void writeStacks(void) {
+	FILE* file = fopen(profileStacksFile, "w");
+	if (!file) {
+		fprintf(stderr, "could not write the profile stacks to %s\n", profileStacksFile);
+		return;
+	}
+	IntegerTable* table = createIntegerTable(1024);
+	char stackString[MAXSTACKLENGTH];
+	char buffer[MAXSTACKLENGTH];
+	int first = 0;
+	for (int last = 0; last < numSamples; last++) {
+		if (samples[last]) continue;
+		stackString[0] = 0;
+		int length = 0;
+		for (int i = last - 1; i >= first; i--) {
+			PNode* pnode = samples[i];
+			String name = pnode->type == PNProcDef || pnode->type == PNFuncDef ? pnode->procName
+				: lineName(pnode, buffer, MAXSTACKLENGTH);
+			length += snprintf(stackString + length, MAXSTACKLENGTH - length, "%s%s",
+							   length ? ";" : "", name);
+			if (length >= MAXSTACKLENGTH) break; // Very deep stacks are cut short.
+		}
+		IntegerElement* stack = (IntegerElement*) searchHashTable(table, stackString);
+		if (stack) stack->value++;
+		else insertInIntegerTable(table, strsave(stackString), 1);
+		first = last + 1;
+	}
+	FORHASHTABLE(table, element)
+		IntegerElement* stack = (IntegerElement*) element;
+		fprintf(file, "%s %d\n", stack->key, stack->value);
+		stdfree(stack->key);
+	ENDHASHTABLE
+	deleteHashTable(table);
+	fclose(file);
+	if (droppedSamples) fprintf(stderr, "profile: %d samples did not fit\n", (int) droppedSamples);
+}
+
+// endProfile ends the profile of a script, writes its report to a file, and writes the folded
+// stacks if the run time stack was sampled.
+void endProfile(FILE* file) {
+	if (samples) stopSampling();
+	int64_t time = now();
+	chargeLine(time);
+	profiling = false;
+	fprintf(file, "\nprofile: %.3f ms run time; times are in ms.\n", msecs(time - profileStart));
+	writeCalls(file, "routine", &routines, compareInclusive);
+	writeCalls(file, "builtin", &builtins, compareExclusive);
+	writeLines(file);
+	if (samples) {
+		writeStacks();
+		stdfree(samples);
+		samples = null;
+	}
+	freeTable(&lines);
+	freeTable(&routines);
+	freeTable(&builtins);
+	if (stack) stdfree(stack);
+	stack = null;
+	depth = maxDepth = 0;
+	curLine = null;
+}
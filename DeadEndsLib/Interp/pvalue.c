@@ -5,7 +5,7 @@
 //  DeadEnds scripts.
 //
 //  Created by Thomas Wetmore on 15 December 2022.
-//  Last changed on 17 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "gedcom.h"
@@ -39,37 +39,61 @@ PValue *allocPValue(PVType type, VUnion value) {
     return ppvalue;
 }
 
-/// Creates a String PValue with the String in the heap.
+/// PStringHeader is in front of the characters of a PString.
+typedef struct PStringHeader {
+    int count; // Number of references.
+} PStringHeader;
+
+#define pstringHeader(string) (((PStringHeader*) (string)) - 1)
+
+/// Creates a PString with a copy of a String. The header and characters are one allocation.
+String createPString(String string) {
+    size_t length = strlen(string);
+    PStringHeader* header = (PStringHeader*) stdalloc(sizeof(PStringHeader) + length + 1);
+    header->count = 1;
+    String pstring = (String) (header + 1);
+    memcpy(pstring, string, length + 1);
+    return pstring;
+}
+
+/// Adds a reference to a PString and returns it.
+String retainPString(String pstring) {
+    if (pstring) pstringHeader(pstring)->count++;
+    return pstring;
+}
+
+/// Removes a reference to a PString and frees it if there are no others.
+void releasePString(String pstring) {
+    if (!pstring) return;
+    PStringHeader* header = pstringHeader(pstring);
+    if (--header->count == 0) stdfree(header);
+}
+
+/// Creates a String PValue with a PString copy of a String.
 PValue createStringPValue(String string) {
     PValue pvalue;
     pvalue.type = PVString;
-    // Save the String in the heap.
-    pvalue.value.uString = string ? strsave(string) : null;
+    pvalue.value.uString = string ? createPString(string) : null;
     return pvalue; // Returned on stack.
 }
 
+/// Returns a PValue after adding a reference to its String if it has one.
+PValue retainPValue(PValue pvalue) {
+    if (pvalue.type == PVString) retainPString(pvalue.value.uString);
+    return pvalue;
+}
+
 // In case we need it
 PValue copyPValue(PValue orig) {
-    if (orig.type == PVString && orig.value.uString) {
-        return createStringPValue(orig.value.uString);
-    }
-    return orig;
+    return retainPValue(orig);
 }
 
 // clonePValue returns a heap-allocated copy of the given PValue.
-// If the value is a PVString, the underlying string is duplicated.
+// If the value is a PVString, the copy holds another reference to its String.
 PValue* clonePValue(const PValue* original) {
     if (!original) return NULL;
     PValue* copy = stdalloc(sizeof(PValue));
-    copy->type = original->type;
-    switch (original->type) {
-    case PVString:
-        copy->value.uString = original->value.uString ? strsave(original->value.uString) : NULL;
-        break;
-    default:
-        copy->value = original->value;
-        break;
-    }
+    *copy = retainPValue(*original);
     return copy;
 }
 
@@ -186,15 +210,11 @@ String valueOfPValue(PValue pvalue) {
 void freePValue(PValue* ppvalue) {
     switch (ppvalue->type) {
     case PVString:
-        if (ppvalue->value.uString) stdfree(ppvalue->value.uString);
-        break;
-    case PVSequence: // Cannot delete Sequences until more memory management added.
-        //deleteSequence(ppvalue->value.uSequence);
+        releasePString(ppvalue->value.uString);
         break;
-    case PVList: // Cannot delete lists until more memory management added.
-        //deleteList(ppvalue->value.uList);
-        break;
-    case PVTable: // Cannot delete tables until more memory management added.
+    case PVSequence: // Sequences, Lists and Tables are shared; the collector frees them.
+    case PVList:
+    case PVTable:
         break;
     default:
         break;
@@ -202,6 +222,12 @@ void freePValue(PValue* ppvalue) {
     stdfree(ppvalue);
 }
 
+// clearPValue releases the String of a PValue that is not in the heap and makes it null.
+void clearPValue(PValue* ppvalue) {
+    if (ppvalue->type == PVString) releasePString(ppvalue->value.uString);
+    *ppvalue = nullPValue;
+}
+
 /// Checks if a PValue has numeric type.
 bool numericPValue(PValue value) {
     return value.type == PVInt || value.type == PVFloat;
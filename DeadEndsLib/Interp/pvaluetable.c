@@ -4,7 +4,7 @@
 //  pvaluetable.c holds the functions that operate on PValueTables.
 //
 //  Created by Thomas Wetmore on 21 April 2023.
-//  Last changed on 2 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "standard.h"
@@ -24,7 +24,7 @@ static void delete(void* a) {
     PValueElement *element = (PValueElement*) a;
     free(element->key);
     PValue* pvalue = element->value;
-    if (pvalue->type == PVString) free(pvalue->value.uString);
+    if (pvalue->type == PVString) releasePString(pvalue->value.uString);
     free(pvalue);
 }
 
@@ -3,7 +3,7 @@
 //  rassa.c handles the page mode builtins for DeadEnds script programs.
 //
 //  Created by Thomas Wetmore on 10 February 2024.
-//  Last changed on 23 July 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include <string.h>
@@ -22,6 +22,7 @@
 #define MAXCOLS 512
 
 extern Page* createPage(int, int);
+extern PageRow* pageRow(Page*, int);
 extern void deletePage(Page*);
 static int unicodeToUtf8(int32_t, char*);
 static int utf8ToUnicode(const char*, int32_t*);
@@ -204,10 +205,10 @@ PValue __col (PNode *pnode, Context *context, bool *errflg) {
     if (file->mode == lineMode) {
         int diff = col - file->curcol;
         if (diff > 0) {
-            for (int i = 0; i < diff; i++) putc(' ', file->fp);
+            for (int i = 0; i < diff; i++) writeFileBytes(file, " ", 1);
         } else if (diff < 0) {
-            putc('\n', file->fp);
-            for (int i = 0; i < col; i++) putc(' ', file->fp);
+            writeFileBytes(file, "\n", 1);
+            for (int i = 0; i < col; i++) writeFileBytes(file, " ", 1);
         }
     }
     file->curcol = col;
@@ -239,6 +240,7 @@ PValue __VALUEOF(PNode* pnode, Context* context, bool *errflg) {
 // usage: showstack()
 extern void showRuntimeStack(Context*, PNode*);
 PValue __SHOWSTACK(PNode* pnode, Context* context, bool *errflg) {
+    flushStdout();
     showRuntimeStack(context, pnode);
     return nullPValue;
 }
@@ -247,11 +249,13 @@ PValue __SHOWSTACK(PNode* pnode, Context* context, bool *errflg) {
 // usage: showframe()
 extern void showFrame(Frame*);
 PValue __SHOWFRAME(PNode* pnode, Context* context, bool* errflg) {
+    flushStdout();
     showFrame(context->frame);
     return nullPValue;
 }
 
-/// Writes the page grid of Unicode codepoints to the script output file in UTF-8 format.
+/// Writes the page of Unicode codepoints to the script output file in UTF-8 format. Only the
+// written spans of the rows are encoded; the rest of each row is spaces.
 // usage: pageout() -> VOID
 PValue __pageout(PNode* pnode, Context* context, bool* errflg) {
     // Make sure the output file is in page mode.
@@ -262,43 +266,43 @@ PValue __pageout(PNode* pnode, Context* context, bool* errflg) {
         return nullPValue;
     }
     Page* page = file->page;
-    char utf8[5]; // Buffer for UTF-8 encoding including an unused safety byte.
-    // Convert every codepoint to a sequence of UTF-8 bytes and write them to the current output file.
+    int ncols = page->ncols;
+    char line[4*MAXCOLS + 1]; // A row in UTF-8 and its newline.
     for (int row = 0; row < page->nrows; row++) {
-        for (int col = 0; col < page->ncols; col++) {
-            int32_t codepoint = page->grid[row * page->ncols + col];
-            int len = unicodeToUtf8(codepoint, utf8); // Convert codepoint to UTF-8.
-            if (len > 0) fwrite(utf8, 1, len, file->fp);
+        PageRow* prow = &(page->rows[row]);
+        int length = 0;
+        if (prow->last < prow->first) { // Blank row.
+            memset(line, ' ', ncols);
+            length = ncols;
+        } else {
+            // Convert the written codepoints to UTF-8 and fill the cells with spaces again.
+            memset(line, ' ', prow->first);
+            length = prow->first;
+            for (int col = prow->first; col <= prow->last; col++) {
+                int32_t codepoint = prow->cells[col];
+                if (codepoint < 0x80) line[length++] = (char) codepoint;
+                else length += unicodeToUtf8(codepoint, line + length);
+                prow->cells[col] = 0x20;
+            }
+            memset(line + length, ' ', ncols - 1 - prow->last);
+            length += ncols - 1 - prow->last;
+            prow->first = ncols;
+            prow->last = -1;
         }
-        fputc('\n', file->fp);
-    }
-    // After writing the page fill the grid with spaces.
-    for (int i = 0; i < page->nrows * page->ncols; i++) {
-        page->grid[i] = 0x20;
+        line[length++] = '\n';
+        writeFileBytes(file, line, length);
     }
     return nullPValue;
 }
 
-/// Adjusts the current column after printing a string.
-void adjustCols(String string, File* file) {
-	int c;
-	while ((c = *string++)) {
-		if (c == '\n')
-			file->curcol = 1;
-		else
-			file->curcol++;
-	}
-}
-
-/// Outputs a string to the program output file in the current mode,
-// decoding UTF-8 into Unicode codepoints stored in the page grid.
+/// Outputs a string to the program output file in the current mode. In page mode the UTF-8 is
+// decoded into Unicode codepoints stored in the rows of the page.
 void poutput(String string, Context* context) {
     File* file = context->file;
 
     // Handle line mode
     if (file->mode == lineMode) {
-        fprintf(file->fp, "%s", string);
-        adjustCols(string, file);
+        writeFile(file, string);
         return;
     }
 
@@ -308,12 +312,12 @@ void poutput(String string, Context* context) {
     Page* page = file->page;
     int row = page->currow;
     int col = file->curcol;
+    PageRow* prow = null; // Row being written; found when its first codepoint is stored.
 
     while (*string) {
-        int32_t codepoint = 0;
-        int bytes = utf8ToUnicode(string, &codepoint);
-
-        if (bytes == 0) {
+        int32_t codepoint = (unsigned char) *string;
+        int bytes = 1;
+        if (codepoint >= 0x80 && !(bytes = utf8ToUnicode(string, &codepoint))) {
             // Invalid UTF-8; skip one byte and continue
             string++;
             continue;
@@ -321,16 +325,20 @@ void poutput(String string, Context* context) {
         if (codepoint == '\n') {
             row++;
             col = 1;
+            prow = null;
             if (row > page->nrows) break; // No room for more lines
         } else {
             if (row >= 1 && row <= page->nrows && col >= 1 && col <= page->ncols) {
-                int offset = (row - 1) * page->ncols + (col - 1);
-                page->grid[offset] = codepoint;
+                if (!prow) prow = pageRow(page, row);
+                prow->cells[col - 1] = codepoint;
+                if (col - 1 < prow->first) prow->first = col - 1;
+                if (col - 1 > prow->last) prow->last = col - 1;
             }
             col++;
             if (col > page->ncols) {
                 col = 1;
                 row++;
+                prow = null;
                 if (row > page->nrows) break; // No room for wrapping
             }
         }
@@ -0,0 +1,96 @@
+//
+//  DeadEnds Library
+//
+//  resolver.c has the resolver, which gives each identifier in a Program its variable slot. In
+//  a procedure or function an identifier is local if it is a parameter or is not a global, which
+//  is the rule the interpreter used when it looked identifiers up by name at run time.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "context.h"
+#include "functiontable.h"
+#include "hashtable.h"
+#include "integertable.h"
+#include "list.h"
+#include "pnode.h"
+#include "resolver.h"
+#include "standard.h"
+
+static bool debugging = false;
+
+// Resolver holds the state of the resolver while it resolves a procedure or function.
+typedef struct Resolver {
+	IntegerTable* globals; // Global identifiers to global indexes.
+	IntegerTable* locals;  // Local identifiers to slots.
+	List* names;           // Local identifiers in slot order.
+} Resolver;
+
+// addLocal gives an identifier the next local slot.
+static int addLocal(Resolver* resolver, String name) {
+	int slot = lengthList(resolver->names);
+	appendToList(resolver->names, name);
+	insertInIntegerTable(resolver->locals, name, slot);
+	return slot;
+}
+
+// resolveName returns the slot of an identifier, giving it a local slot if it is new.
+static int resolveName(Resolver* resolver, String name) {
+	if (!name) return NOSLOT;
+	int slot = searchIntegerTable(resolver->locals, name);
+	if (slot != NAN) return slot;
+	int index = searchIntegerTable(resolver->globals, name);
+	if (index != NAN) return globalSlot(index);
+	return addLocal(resolver, name);
+}
+
+// resolvePNodes resolves the identifiers in a list of PNodes and the PNodes below them.
+static void resolvePNodes(Resolver* resolver, PNode* pnode) {
+	for (; pnode; pnode = pnode->next) {
+		if (pnode->type == PNIdent || pnode->type == PNNotes)
+			pnode->slot = resolveName(resolver, pnode->stringOne);
+		pnode->slotOne = resolveName(resolver, pnode->idenOne);
+		pnode->slotTwo = resolveName(resolver, pnode->idenTwo);
+		pnode->slotThree = resolveName(resolver, pnode->idenThree);
+		resolvePNodes(resolver, pnode->expression);
+		resolvePNodes(resolver, pnode->pnodeOne);
+		resolvePNodes(resolver, pnode->pnodeTwo);
+	}
+}
+
+// resolveRoutine resolves a procedure or function definition. The parameters get the first
+// slots, even those with the names of globals.
+static void resolveRoutine(IntegerTable* globals, PNode* routine) {
+	Resolver resolver = { globals, createIntegerTable(37), createList(null, null, null, false) };
+	for (PNode* param = routine->parameters; param; param = param->next) {
+		int slot = searchIntegerTable(resolver.locals, param->identifier);
+		param->slot = slot != NAN ? slot : addLocal(&resolver, param->identifier);
+	}
+	resolvePNodes(&resolver, routine->procBody); // Also funcBody.
+	int numSlots = lengthList(resolver.names);
+	routine->numSlots = numSlots;
+	routine->slotNames = (String*) stdalloc(max(numSlots, 1)*sizeof(String));
+	for (int i = 0; i < numSlots; i++) routine->slotNames[i] = getListElement(resolver.names, i);
+	if (debugging) printf("resolveRoutine: %s: %d slots.\n", routine->procName, numSlots);
+	deleteHashTable(resolver.locals);
+	deleteList(resolver.names);
+}
+
+// resolveProgram resolves the procedures and functions of a Program.
+void resolveProgram(Program* program) {
+	IntegerTable* globals = createIntegerTable(37);
+	int index = 0;
+	FORLIST(program->globalIdents, ident)
+		if (searchIntegerTable(globals, (String) ident) == NAN)
+			insertInIntegerTable(globals, (String) ident, index);
+		index++;
+	ENDLIST
+	FORHASHTABLE(program->procedures, element)
+		resolveRoutine(globals, ((FunctionElement*) element)->function);
+	ENDHASHTABLE
+	FORHASHTABLE(program->functions, element)
+		resolveRoutine(globals, ((FunctionElement*) element)->function);
+	ENDHASHTABLE
+	deleteHashTable(globals);
+}
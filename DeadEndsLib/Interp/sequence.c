@@ -5,7 +5,7 @@
 //  persons and other record types. It underlies the indiseq data type of DeadEnds Script.
 //
 //  Created by Thomas Wetmore on 1 March 2023.
-//  Last changed on 25 July 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "database.h"
@@ -16,6 +16,8 @@
 #include "lineage.h"
 #include "list.h"
 #include "name.h"
+#include "nameorder.h"
+#include "pvalue.h"
 #include "refnindex.h"
 #include "sequence.h"
 #include "splitjoin.h"
@@ -49,9 +51,16 @@ static int nameCompare(String a, String b) {
 	return compareNames(a, b);
 }
 
-// delete is the function that deletes a SequenceEl.
+// delete is the function that deletes a SequenceEl and its value.
 static void delete(void* element) {
-	stdfree(element);
+	SequenceEl* el = (SequenceEl*) element;
+	if (el->value) freePValue(el->value);
+	stdfree(el);
+}
+
+// copyValue returns a copy of the value of a SequenceEl for a Sequence derived from its own.
+static PValue* copyValue(SequenceEl* element) {
+	return element->value ? clonePValue(element->value) : null;
 }
 
 void baseFree(void *word) { free(word); }
@@ -63,7 +72,7 @@ static SequenceEl** sequenceElements(Sequence *sequence) {
 	return (SequenceEl**) (&(sequence->block))->elements;
 }
 
-// createSequenceEl creates a SequenceEl.
+// createSequenceEl creates a SequenceEl. The SequenceEl owns the value, a PValue in the heap.
 //SequenceEl* createSequenceEl(Database* database, String key, void* value) {
 SequenceEl* createSequenceEl(RecordIndex* index, String key, void* value) {
 	SequenceEl* element = (SequenceEl*) stdalloc(sizeof(SequenceEl));
@@ -118,7 +127,7 @@ void appendToSequence(Sequence* sequence, String key, void* value) {
 // destination changes; source does not.
 void appendSequenceToSequence(Sequence* destination, Sequence* source) {
 	FORSEQUENCE(source, element, count)
-		appendToSequence(destination, element->root->key, element->value);
+		appendToSequence(destination, element->root->key, copyValue(element));
 	ENDSEQUENCE
     destination->sortType = SequenceNotSorted;
 }
@@ -177,13 +186,97 @@ bool elementFromSequence (Sequence* sequence, int index, String* pkey, String* p
 	return true;
 }
 
-// nameSortSequence sorts a sequence by the names of the persons. Assumes person Sequence.
-void nameSortSequence(Sequence* sequence) {
+// Collated is a SequenceEl and its collation key while a Sequence is sorted by name.
+typedef struct Collated {
+	String key;
+	SequenceEl* element;
+} Collated;
+
+// collatedGetKey is the getKey function that returns the collation key of a Collated.
+static String collatedGetKey(void* element) {
+	return ((Collated*) element)->key;
+}
+
+// collatedCompare compares two collation keys.
+static int collatedCompare(String a, String b) {
+	return strcmp(a, b);
+}
+
+// hasOrderName returns true if the name of a SequenceEl is the first name of its person, the
+// name the person is in a NameOrder by.
+static bool hasOrderName(SequenceEl* element) {
+	GNode* name = NAME(element->root);
+	String first = name ? name->value : null;
+	if (!first || !element->name) return first == element->name;
+	return eqstr(first, element->name);
+}
+
+// rankSortSequence sorts the elements of a Sequence by their positions in a NameOrder with a
+// counting sort. Returns false, leaving the Sequence alone, if an element is not in the order
+// or has a name other than its person's first.
+static bool rankSortSequence(Sequence* sequence, NameOrder* order) {
+	Block* block = &(sequence->block);
+	int length = block->length;
+	int* ranks = (int*) stdalloc(max(length, 1)*sizeof(int));
+	for (int i = 0; i < length; i++) {
+		SequenceEl* element = (SequenceEl*) block->elements[i];
+		ranks[i] = hasOrderName(element) ? personToNameRank(order, element->root) : -1;
+		if (ranks[i] < 0) {
+			stdfree(ranks);
+			return false;
+		}
+	}
+	int* starts = (int*) stdalloc((order->numPersons + 1)*sizeof(int));
+	memset(starts, 0, (order->numPersons + 1)*sizeof(int));
+	for (int i = 0; i < length; i++) starts[ranks[i] + 1]++;
+	for (int r = 0; r < order->numPersons; r++) starts[r + 1] += starts[r];
+	void** sorted = (void**) stdalloc(max(length, 1)*sizeof(void*));
+	for (int i = 0; i < length; i++) sorted[starts[ranks[i]]++] = block->elements[i];
+	memcpy(block->elements, sorted, length*sizeof(void*));
+	stdfree(sorted);
+	stdfree(starts);
+	stdfree(ranks);
+	return true;
+}
+
+// nameSortSequenceWithOrder sorts a Sequence by the names of its elements, then by key. Assumes
+// person Sequence. Each element gets its collation key once, from the NameOrder if there is one
+// and the element has its person's first name, so the sort compares Strings and does not parse
+// names. Large Sequences are sorted by their positions in the NameOrder without comparisons.
+void nameSortSequenceWithOrder(Sequence* sequence, NameOrder* order) {
 	if (sequence->sortType == SequenceNameSorted) return;
-	sortBlock(&(sequence->block), nameGetKey, nameCompare);
+	Block* block = &(sequence->block);
+	int length = block->length;
+	if (order && length >= order->numPersons/16 && rankSortSequence(sequence, order)) {
+		sequence->sortType = SequenceNameSorted;
+		return;
+	}
+	Collated* collated = (Collated*) stdalloc(max(length, 1)*sizeof(Collated));
+	void** elements = (void**) stdalloc(max(length, 1)*sizeof(void*));
+	bool* computed = (bool*) stdalloc(max(length, 1)*sizeof(bool));
+	for (int i = 0; i < length; i++) {
+		SequenceEl* element = (SequenceEl*) block->elements[i];
+		String key = null;
+		if (order && hasOrderName(element)) key = personToCollationKey(order, element->root);
+		computed[i] = !key;
+		collated[i].key = key ? key : nameToCollationKey(element->name, element->root->key);
+		collated[i].element = element;
+		elements[i] = &collated[i];
+	}
+	sortElements(elements, length, collatedGetKey, collatedCompare);
+	for (int i = 0; i < length; i++) block->elements[i] = ((Collated*) elements[i])->element;
+	for (int i = 0; i < length; i++) if (computed[i]) stdfree(collated[i].key);
+	stdfree(computed);
+	stdfree(elements);
+	stdfree(collated);
 	sequence->sortType = SequenceNameSorted;
 }
 
+// nameSortSequence sorts a sequence by the names of the persons. Assumes person Sequence.
+void nameSortSequence(Sequence* sequence) {
+	nameSortSequenceWithOrder(sequence, null);
+}
+
 // keySortSequence sorts a Sequence by key.
 void keySortSequence(Sequence* sequence) {
 	if (sequence->sortType == SequenceKeySorted) return;
@@ -195,7 +288,7 @@ void keySortSequence(Sequence* sequence) {
 Sequence* copySequence(Sequence* sequence) {
 	Sequence* copy = createSequence(sequence->index);
 	FORSEQUENCE(sequence, element, count)
-		appendToSequence(copy, element->root->key, element->value);
+		appendToSequence(copy, element->root->key, copyValue(element));
 	ENDSEQUENCE
 	return copy;
 }
@@ -213,11 +306,11 @@ Sequence* uniqueSequence(Sequence* sequence) {
 	SequenceEl** els = (SequenceEl**) block->elements;
 	SequenceEl* el = els[0];
 	RecordIndex* index = sequence->index;
-	appendToBlock(uBlock, createSequenceEl(index, el->root->key, el->value));
+	appendToBlock(uBlock, createSequenceEl(index, el->root->key, copyValue(el)));
 	int i, j;
 	for (j = 0, i = 1; i < n; i++) {
 		if (nestr(els[i]->root->key, els[j]->root->key)) {
-			appendToBlock(uBlock, createSequenceEl(index, els[i]->root->key, els[i]->value));
+			appendToBlock(uBlock, createSequenceEl(index, els[i]->root->key, copyValue(els[i])));
 			j = i;
 		}
 	}
@@ -233,8 +326,10 @@ void uniqueSequenceInPlace(Sequence* sequence) {
 	if (sequence->sortType != SequenceKeySorted) keySortSequence(sequence);
 	SequenceEl** els = (SequenceEl**) block->elements;
 	int i, j;
-	for (j = 0, i = 1; i < n; i++)
+	for (j = 0, i = 1; i < n; i++) {
 		if (nestr(els[i]->root->key, els[j]->root->key)) els[++j] = els[i];
+		else delete(els[i]);
+	}
 	block->length = j + 1;
 }
 
@@ -253,22 +348,22 @@ Sequence* unionSequence(Sequence* one, Sequence* two) {
 	int i = 0, j = 0, rel;
 	while (i < n && j < m) {
 		if ((rel = keyCompare(u[i]->root->key, v[j]->root->key)) < 0) {
-			appendToSequence(three, u[i]->root->key, u[i]->value);
+			appendToSequence(three, u[i]->root->key, copyValue(u[i]));
 			i++;
 		} else if (rel > 0) {
-			appendToSequence(three, v[j]->root->key, v[j]->value);
+			appendToSequence(three, v[j]->root->key, copyValue(v[j]));
 			j++;
 		} else {
-			appendToSequence(three, u[i]->root->key, u[i]->value);
+			appendToSequence(three, u[i]->root->key, copyValue(u[i]));
 			i++; j++;
 		}
 	}
 	while (i < n) {
-		appendToSequence(three, u[i]->root->key, u[i]->value);
+		appendToSequence(three, u[i]->root->key, copyValue(u[i]));
 		i++;
 	}
 	while (j < m) {
-		appendToSequence(three, v[j]->root->key, v[j]->value);
+		appendToSequence(three, v[j]->root->key, copyValue(v[j]));
 		j++;
 	}
 	three->sortType = SequenceKeySorted;
@@ -298,7 +393,7 @@ Sequence* intersectSequence(Sequence* one, Sequence* two) {
 		} else if (rel > 0) {
 			j++;
 		} else {
-			appendToSequence(three, (u[i])->root->key, u[i]->value);
+			appendToSequence(three, (u[i])->root->key, copyValue(u[i]));
 			i++; j++;
 		}
 	}
@@ -325,7 +420,7 @@ Sequence* differenceSequence(Sequence* one, Sequence* two) {
 	int rel;
 	while (i < n && j < m) {
 		if ((rel = compareRecordKeys(u[i]->root->key, v[j]->root->key)) < 0) {
-			appendToSequence(three, u[i]->root->key, u[i]->value);
+			appendToSequence(three, u[i]->root->key, copyValue(u[i]));
 			i++;
 		} else if (rel > 0) {
 			j++;
@@ -334,7 +429,7 @@ Sequence* differenceSequence(Sequence* one, Sequence* two) {
 		}
 	}
 	while (i < n) {
-		appendToSequence(three, u[i]->root->key, u[i]->value);
+		appendToSequence(three, u[i]->root->key, copyValue(u[i]));
 		i++;
 	}
 	three->sortType = SequenceKeySorted;
@@ -355,11 +450,11 @@ Sequence* parentSequence(Sequence* sequence) {
 		GNode* fath = personToFather(indi, index);
 		GNode* moth = personToMother(indi, index);
 		if (fath && !isInHashTable(table, key = personToKey(fath))) {
-			appendToSequence(parents, key, el->value);
+			appendToSequence(parents, key, copyValue(el));
 			addToStringTable(table, key, null);
 		}
 		if (moth && !isInHashTable(table, key = personToKey(moth))) {
-			appendToSequence(parents, key, el->value);
+			appendToSequence(parents, key, copyValue(el));
 			addToStringTable(table, key, null);
 		}
 	ENDSEQUENCE
@@ -564,12 +659,12 @@ Sequence* ancestorSequence(Sequence* startSequence, bool close) {
 		GNode* mother = personToMother(person, index);
 		if (father && !isInHashTable(ancestorKeys, parentKey = father->key)) {
 			appendToSequence(ancestorSequence, parentKey, 0);
-			enqueueList(ancestorQueue, strsave(parentKey));
+			enqueueList(ancestorQueue, parentKey);
 			addToStringTable(ancestorKeys, parentKey, null);
 		}
 		if (mother && !isInHashTable(ancestorKeys, parentKey = mother->key)) {
 			appendToSequence(ancestorSequence, parentKey, 0);
-			enqueueList(ancestorQueue, strsave(parentKey));
+			enqueueList(ancestorQueue, parentKey);
 			addToStringTable(ancestorKeys, parentKey, null);
 		}
 	}
@@ -602,11 +697,11 @@ Sequence* descendentSequence(Sequence* startSequence, bool close) {
 		GNode* person = keyToPerson(key, index);
 		FORFAMSS(person, family, key, index) {
 			if (isInHashTable(familyKeys, key)) goto a;
-			addToStringTable(familyKeys, strsave(key), null);
+			addToStringTable(familyKeys, key, null);
 			FORCHILDREN(family, child, chilKey, num, index)
 				if (!isInHashTable(descendentKeys, descendentKey = personToKey(child))) {
 					appendToSequence(descendentSequence, descendentKey, 0);
-					enqueueList(descendentQueue, strsave(descendentKey));
+					enqueueList(descendentQueue, descendentKey);
 					addToStringTable(descendentKeys, descendentKey, null);
 				}
 			ENDCHILDREN
@@ -630,7 +725,7 @@ Sequence* spouseSequence(Sequence *sequence) {
 		FORSPOUSES(person, spouse, fam, num1, index)
 			String key = personToKey(spouse);
 			if (!isInHashTable(table, key)) {
-				appendToSequence(spouses, key, el->value);
+				appendToSequence(spouses, key, copyValue(el));
 				addToStringTable(table, key, null);
 			}
 		ENDSPOUSES
@@ -717,7 +812,7 @@ void sequenceToGedcom(Sequence *sequence, FILE *fp) {
 // Still needed?
 bool limitPersonNode(GNode* node, int level) {
 	//  FOR TESTING. WE SHOULD SEE NO BIRTH EVENTS IN THE OUTPUT.
-	if (level == 1 && eqstr(node->tag, "BIRT")) return false;
+	if (level == 1 && node->tagId == tagBIRT) return false;
 	writeGNode(stdout, level, node, false);
 	return true;
 }
@@ -743,35 +838,44 @@ Sequence* nameToSequence(String name, RecordIndex* rindex, NameIndex* nindex) {
 	if (!name || *name == 0 || !rindex || !nindex) return null;
 	int num;
 	Sequence *seq = null;
+	Block block;
+	initBlock(&block);
+	String* keys;
 	if (*name != '*') { // Name does not start with '*'.
-		String *keys = personKeysFromName(name, rindex, nindex, &num); // MNOTE: keys is static.
-		if (num == 0) return null;
-		seq = createSequence(rindex);
-		for (int i = 0; i < num; i++)
-			appendToSequence(seq, keys[i], 0);
-		nameSortSequence(seq);
+		num = personKeysFromNameInto(name, rindex, nindex, &block);
+		keys = (String*) block.elements;
+		if (num) {
+			seq = createSequence(rindex);
+			for (int i = 0; i < num; i++)
+				appendToSequence(seq, keys[i], 0);
+			nameSortSequence(seq);
+		}
+		deleteBlock(&block, null);
 		return seq;
 	}
 	// Name starts with a '*'.
-	char scratch[MAXLINELEN+1];
-	sprintf(scratch, "a/%s/", getSurname(name));
+	char scratch[MAXLINELEN+1], surname[MAXLINELEN+1];
+	snprintf(scratch, sizeof(scratch), "a/%s/", getSurnameInto(name, surname));
 	for (int c = 'a'; c <= 'z'; c++) {
 		scratch[0] = c;
-		String *keys = personKeysFromName(scratch, rindex, nindex, &num/*, true*/);
+		num = personKeysFromNameInto(scratch, rindex, nindex, &block);
 		if (num == 0) continue;
+		keys = (String*) block.elements;
 		if (!seq) seq = createSequence(rindex);
 		for (int i = 0; i < num; i++) {
 			appendToSequence(seq, keys[i], 0);
 		}
 	}
 	scratch[0] = '$';
-	String *keys = personKeysFromName(scratch, rindex, nindex, &num/*, true*/);
+	num = personKeysFromNameInto(scratch, rindex, nindex, &block);
+	keys = (String*) block.elements;
 	if (num) {
 		if (!seq) seq = createSequence(rindex);
 		for (int i = 0; i < num; i++) {
 			appendToSequence(seq, keys[i], 0);
 		}
 	}
+	deleteBlock(&block, null);
 	if (seq) {
 		Sequence* useq = uniqueSequence(seq);
 		deleteSequence(seq);
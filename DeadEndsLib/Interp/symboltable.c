@@ -9,11 +9,11 @@
 //  are to be retained they should be copied. This is not done, so in consequence they are not freed when
 //  replaced in SymbolTables. For the most part this is reasonable, but pathological scripts could cause problems.
 //
-//  There are two versions of the assign and get functions, one that takes a SymbolTable, and one that takes
-//  a Context.
+//  Script variables are not kept in SymbolTables; the resolver gives each a slot in its Frame or in the
+//  Context's globals, and the slot functions here get and assign their values.
 //
 //  Created by Thomas Wetmore on 23 March 2023.
-//  Last changed on 25 July 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "block.h"
@@ -23,6 +23,7 @@
 #include "pvalue.h"
 #include "context.h"
 #include "frame.h"
+#include "resolver.h"
 
 #undef LISTBUG
 
@@ -78,32 +79,6 @@ void assignValueToSymbolTable(SymbolTable* table, String ident, PValue pvalue) {
     }
 }
 
-// assignValueToSymbol assigns a PValue to a Symbol in a Context. If the Symbol isn't in the current Frame's
-// table, check the global table.
-void assignValueToSymbol(Context* context, String ident, PValue pvalue) {
-    // Determine symbol table to use.
-    SymbolTable* table = context->frame->table;
-    if (!isInHashTable(table, ident) && isInHashTable(context->globals, ident)) {
-        table = context->globals;
-    }
-    // Prepare the value to put in the symbol table.
-    PValue* copy = clonePValue(&pvalue);
-    // If the symbol exists free its old value.
-#ifdef LISTBUG
-    if (pvalue.type == PVList) {
-        printf("Assigning to list %s: %s\n", ident, valueOfPValue(pvalue));
-    }
-#endif
-    Symbol* symbol = searchHashTable(table, ident);
-    if (symbol) {
-        freePValue(symbol->value);
-        symbol->value = copy;
-    // Else add a new symbol with the new value.
-    } else {
-        addToHashTable(table, createSymbol(strsave(ident), copy), true);
-    }
-}
-
 // getValueFromSymbolTable gets the value of a Symbol from a SymbolTable; PValue is returned on stack.
 PValue getValueFromSymbolTable(SymbolTable* symtab, String ident) {
     Symbol *symbol = searchHashTable(symtab, ident);
@@ -116,13 +91,38 @@ PValue getValueFromSymbolTable(SymbolTable* symtab, String ident) {
     return cloneAndReturnPValue(symbol->value);
 }
 
-// getValueOfSymbol gets the value of a symbol from a Context; the PValue is returned on the stack.
-PValue getValueOfSymbol(Context* context, String ident) {
-    SymbolTable* locals = context->frame->table;
-    Symbol* symbol = searchHashTable(locals, ident);
-    if (!symbol) symbol = searchHashTable(context->globals, ident);
-    if (!symbol || !symbol->value) return nullPValue;
-    return cloneAndReturnPValue(symbol->value);
+// slotToPValue returns the address of the value of a variable slot in a Context; null if the
+// slot was not resolved.
+static PValue* slotToPValue(Context* context, int slot) {
+    if (slot >= 0) return &(context->frame->slots[slot]);
+    if (isGlobalSlot(slot)) return &(context->globals[globalSlotIndex(slot)]);
+    return null;
+}
+
+// assignValueToSlot assigns a PValue to a variable slot in a Context. The variable takes over
+// the value's reference to its String.
+void assignValueToSlot(Context* context, int slot, PValue pvalue) {
+    PValue* variable = slotToPValue(context, slot);
+    if (!variable) {
+        clearPValue(&pvalue);
+        return;
+    }
+    clearPValue(variable);
+    *variable = pvalue;
+}
+
+// getValueOfSlot gets the value of a variable slot in a Context; the PValue is returned on the
+// stack with its own reference to its String.
+PValue getValueOfSlot(Context* context, int slot) {
+    PValue* variable = slotToPValue(context, slot);
+    if (!variable) return nullPValue;
+    return retainPValue(*variable);
+}
+
+// clearLocalSlot makes a local variable null; loops use it to remove their variables when they
+// end. Globals are left alone.
+void clearLocalSlot(Context* context, int slot) {
+    if (slot >= 0) clearPValue(&(context->frame->slots[slot]));
 }
 
 // showSymbolTable shows the contents of a SymbolTable. For debugging.
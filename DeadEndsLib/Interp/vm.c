@@ -0,0 +1,810 @@
+//
+//  DeadEnds Library
+//
+//  vm.c has the virtual machine that runs the Code of compiled procedures and functions. It keeps
+//  a stack of PValues, an error flag, and the states of the loops being run. The instructions are
+//  dispatched with computed gotos when the compiler has them, or else with a switch.
+//
+//  Each instruction does what the tree walker does for the PNode it was compiled from, writing
+//  the same output and reporting the same errors. The builtins compiled to their own instructions
+//  set and test the error flag as their functions do. runCode returns the InterpType interpret
+//  would return for the body.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "collect.h"
+#include "compile.h"
+#include "context.h"
+#include "database.h"
+#include "evaluate.h"
+#include "frame.h"
+#include "gedcom.h"
+#include "gnode.h"
+#include "interp.h"
+#include "lineage.h"
+#include "list.h"
+#include "pnode.h"
+#include "pvalue.h"
+#include "sequence.h"
+#include "standard.h"
+#include "symboltable.h"
+
+extern void poutput(String, Context*);
+
+// Loop is the state of a loop while it runs.
+typedef struct Loop {
+	GNode* root;    // Person, family or node the loop is over.
+	GNode* node;    // Node of the current iteration; null before the first.
+	GNode** nodes;  // Traverse loops: the nodes from the root to the current node.
+	List* records;  // Record loops: the roots of the records.
+	PVType type;    // Record loops: the type of the records.
+	PValue value;   // Sequence and list loops: the Sequence or List.
+	String note;    // Note loops: the value of the current NOTE.
+	int index;      // Index of the current record or element; level of the current node.
+	int count;      // Value of the loop's counter.
+	SexType sex;    // Spouse loops: the sex of the person.
+} Loop;
+
+// nextTagged returns the next sibling of a GNode if it has the same tag; null otherwise.
+static GNode* nextTagged(GNode* gnode, int tagId) {
+	gnode = gnode->sibling;
+	return gnode && gnode->tagId == tagId ? gnode : null;
+}
+
+// bindArguments moves the arguments of a call from the stack to the parameters of a Frame.
+static void bindArguments(Frame* frame, PNode* defn, PValue* args) {
+	for (PNode* parm = defn->parameters; parm; parm = parm->next)
+		assignValueToFrame(frame, parm->slot, *args++);
+}
+
+// callFunction calls a function with the arguments on the stack. Returns its value and sets the
+// error flag as evaluateUserFunc does.
+static PValue callFunction(PNode* pnode, PValue* args, Context* context, bool* errflg) {
+	PNode* func = pnode->routine;
+	Frame* frame = createFrame(context, pnode, func);
+	bindArguments(frame, func, args);
+	PValue value = nullPValue;
+	switch (runRoutine(func, frame, context, &value)) {
+	case InterpReturn:
+	case InterpOkay:
+		*errflg = false;
+		return value;
+	default:
+		*errflg = true;
+		return nullPValue;
+	}
+}
+
+// collect collects the Aggregates if enough have been created and no expression holds one.
+static void collect(Context* context) {
+	Aggregates* aggregates = context->aggregates;
+	if (aggregates->length >= aggregates->nextCollection && !aggregates->numHolding)
+		collectAggregates(context);
+}
+
+// output writes a value if it is a String and releases it.
+static void output(PValue pvalue, Context* context) {
+	if (pvalue.type == PVString && pvalue.value.uString) {
+		poutput(pvalue.value.uString, context);
+		releasePString(pvalue.value.uString);
+	}
+}
+
+// numericOperands checks the operands of a binary builtin as evalBinary does; they must be
+// numbers of the same type. Operands that aren't are cleared.
+static bool numericOperands(PValue* a, PValue* b, bool* errflg) {
+	if (a->type == b->type && (a->type == PVInt || a->type == PVFloat)) return true;
+	clearPValue(a);
+	clearPValue(b);
+	*errflg = true;
+	return false;
+}
+
+// equalValues compares two values as __eq does.
+static bool equalValues(PValue a, PValue b) {
+	if (a.type == PVNull && b.type == PVNull) return true;
+	if (a.type == PVNull) {
+		if (b.type == PVInt) return b.value.uInt == 0;
+		if (b.type == PVString) return b.value.uString == NULL || b.value.uString[0] == '\0';
+		return false;
+	}
+	if (b.type == PVNull) {
+		if (a.type == PVInt) return a.value.uInt == 0;
+		if (a.type == PVString) return a.value.uString == NULL || a.value.uString[0] == '\0';
+		return false;
+	}
+	if (a.type == PVInt && b.type == PVInt) return a.value.uInt == b.value.uInt;
+	if (a.type == PVString && b.type == PVString)
+		return strcmp(a.value.uString, b.value.uString) == 0;
+	if (a.type == PVInt && b.type == PVString) return a.value.uInt == atoi(b.value.uString);
+	if (a.type == PVString && b.type == PVInt) return atoi(a.value.uString) == b.value.uInt;
+	return false;
+}
+
+#if defined(__GNUC__)
+#define DISPATCH() goto *labels[ip->op]
+#define OP(op) L##op
+#else
+#define DISPATCH() goto dispatch
+#define OP(op) case op
+#endif
+#define NEXT() { ip++; DISPATCH(); }
+#define JUMP(target) { ip = code->instructions + (target); DISPATCH(); }
+#define PUSH(pvalue) (*sp++ = (pvalue))
+#define POP() (*--sp)
+#define TOP (sp[-1])
+
+// runCode runs the Code of a procedure or function body in the Context's Frame.
+InterpType runCode(Code* code, Context* context, PValue* returnValue) {
+#if defined(__GNUC__)
+	static const void* labels[] = {
+		[OpInt] = &&LOpInt, [OpFloat] = &&LOpFloat, [OpString] = &&LOpString,
+		[OpSlot] = &&LOpSlot, [OpNewline] = &&LOpNewline, [OpSpace] = &&LOpSpace,
+		[OpTrue] = &&LOpTrue, [OpFalse] = &&LOpFalse, [OpAccumulate] = &&LOpAccumulate,
+		[OpBuiltin] = &&LOpBuiltin, [OpEvaluate] = &&LOpEvaluate, [OpCall] = &&LOpCall,
+		[OpCheckArgument] = &&LOpCheckArgument, [OpBail] = &&LOpBail, [OpAdd] = &&LOpAdd,
+		[OpMul] = &&LOpMul, [OpSub] = &&LOpSub, [OpDiv] = &&LOpDiv, [OpMod] = &&LOpMod,
+		[OpNeg] = &&LOpNeg, [OpNot] = &&LOpNot, [OpDecimal] = &&LOpDecimal, [OpEq] = &&LOpEq,
+		[OpNe] = &&LOpNe, [OpLt] = &&LOpLt, [OpLe] = &&LOpLe, [OpGt] = &&LOpGt, [OpGe] = &&LOpGe,
+		[OpAnd] = &&LOpAnd, [OpOr] = &&LOpOr, [OpOutput] = &&LOpOutput,
+		[OpOutputSlot] = &&LOpOutputSlot, [OpOutputValue] = &&LOpOutputValue,
+		[OpBuiltinStatement] = &&LOpBuiltinStatement,
+		[OpFunctionStatement] = &&LOpFunctionStatement, [OpProcedure] = &&LOpProcedure,
+		[OpSet] = &&LOpSet, [OpIncr] = &&LOpIncr, [OpDecr] = &&LOpDecr,
+		[OpCondition] = &&LOpCondition, [OpConditionSet] = &&LOpConditionSet,
+		[OpConditionError] = &&LOpConditionError, [OpJump] = &&LOpJump, [OpLoop] = &&LOpLoop,
+		[OpReturnValue] = &&LOpReturnValue, [OpEnd] = &&LOpEnd, [OpBreak] = &&LOpBreak,
+		[OpContinue] = &&LOpContinue, [OpReturn] = &&LOpReturn, [OpFatal] = &&LOpFatal,
+		[OpChildren] = &&LOpChildren, [OpNextChild] = &&LOpNextChild,
+		[OpSpouses] = &&LOpSpouses, [OpNextSpouse] = &&LOpNextSpouse,
+		[OpFamilies] = &&LOpFamilies, [OpNextFamily] = &&LOpNextFamily,
+		[OpFathers] = &&LOpFathers, [OpNextFather] = &&LOpNextFather,
+		[OpMothers] = &&LOpMothers, [OpNextMother] = &&LOpNextMother,
+		[OpParents] = &&LOpParents, [OpNextParent] = &&LOpNextParent,
+		[OpNotes] = &&LOpNotes, [OpNextNote] = &&LOpNextNote, [OpEndNotes] = &&LOpEndNotes,
+		[OpNodes] = &&LOpNodes, [OpNextNode] = &&LOpNextNode,
+		[OpRecords] = &&LOpRecords, [OpNextRecord] = &&LOpNextRecord,
+		[OpEndRecords] = &&LOpEndRecords,
+		[OpSequence] = &&LOpSequence, [OpNextElement] = &&LOpNextElement,
+		[OpEndSequence] = &&LOpEndSequence,
+		[OpList] = &&LOpList, [OpNextItem] = &&LOpNextItem, [OpEndList] = &&LOpEndList,
+		[OpTraverse] = &&LOpTraverse, [OpNextTraverse] = &&LOpNextTraverse,
+		[OpEndTraverse] = &&LOpEndTraverse
+	};
+#endif
+	PValue stack[code->maxStack + 1];
+	Loop loops[code->numLoops + 1];
+	GNode* nodes[code->numTraverses*MAXTRAVERSEDEPTH + 1];
+	PValue* sp = stack;
+	Instruction* ip = code->instructions;
+	RecordIndex* index = context->database->recordIndex;
+	int numRoots = context->aggregates->numRoots;
+	bool errflg = false;
+	InterpType returnCode;
+	PValue a, b;
+	Loop* loop;
+	GNode* gnode;
+
+	DISPATCH();
+#if !defined(__GNUC__)
+dispatch:
+	switch (ip->op) {
+#endif
+
+	// Expressions.
+	OP(OpInt):
+		errflg = false;
+		PUSH(PVALUE(PVInt, uInt, ip->pnode->intCons));
+		NEXT();
+	OP(OpFloat):
+		errflg = false;
+		PUSH(PVALUE(PVFloat, uFloat, ip->pnode->floatCons));
+		NEXT();
+	OP(OpString):
+		errflg = false;
+		PUSH(PVALUE(PVString, uString, retainPString(ip->pnode->stringCons)));
+		NEXT();
+	OP(OpSlot):
+		PUSH(getValueOfSlot(context, ip->a));
+		NEXT();
+	OP(OpNewline):
+		PUSH(createStringPValue("\n"));
+		NEXT();
+	OP(OpSpace):
+		PUSH(createStringPValue(" "));
+		NEXT();
+	OP(OpTrue):
+		PUSH(truePValue);
+		NEXT();
+	OP(OpFalse):
+		PUSH(falsePValue);
+		NEXT();
+	OP(OpAccumulate):
+		PUSH(PVALUE(PVInt, uInt, ip->a));
+		NEXT();
+	OP(OpBuiltin):
+		a = ip->pnode->builtinFunc(ip->pnode, context, &errflg);
+		PUSH(a);
+		NEXT();
+	OP(OpEvaluate):
+		a = evaluate(ip->pnode, context, &errflg);
+		PUSH(a);
+		NEXT();
+	OP(OpCall): // Builtins around the call may hold Aggregates no variable holds.
+		sp -= ip->a;
+		context->aggregates->numHolding++;
+		a = callFunction(ip->pnode, sp, context, &errflg);
+		context->aggregates->numHolding--;
+		PUSH(a);
+		NEXT();
+	OP(OpCheckArgument):
+		if (!errflg) NEXT();
+		for (int i = 0; i < ip->a; i++) clearPValue(--sp);
+		if (ip->pnode->type == PNProcCall)
+			scriptError(ip->pnode, "could not evaluate argument %d of %s", ip->a, ip->pnode->procName);
+		else
+			scriptError(ip->pnode, "could not evaluate an argument of %s", ip->pnode->funcName);
+		if (ip->b < 0) goto error;
+		PUSH(nullPValue);
+		JUMP(ip->b);
+	OP(OpBail):
+		if (!errflg) NEXT();
+		for (int i = 0; i < ip->a; i++) clearPValue(--sp);
+		PUSH(nullPValue);
+		JUMP(ip->b);
+	OP(OpAdd):
+		a = POP();
+		if (errflg || (a.type != PVInt && a.type != PVFloat)) {
+			clearPValue(&a);
+			TOP = nullPValue;
+			JUMP(ip->b);
+		}
+		if (TOP.type == PVInt && a.type == PVInt) TOP.value.uInt += a.value.uInt;
+		else if (TOP.type == PVFloat && a.type == PVFloat) TOP.value.uFloat += a.value.uFloat;
+		else if (TOP.type == PVFloat) TOP.value.uFloat += (double) a.value.uInt;
+		else TOP = PVALUE(PVFloat, uFloat, (double) TOP.value.uInt + a.value.uFloat);
+		NEXT();
+	OP(OpMul):
+		a = POP();
+		if (errflg || (a.type != PVInt && a.type != PVFloat)) {
+			clearPValue(&a);
+			TOP = nullPValue;
+			JUMP(ip->b);
+		}
+		if (TOP.type == PVInt && a.type == PVInt) TOP.value.uInt *= a.value.uInt;
+		else if (TOP.type == PVFloat && a.type == PVFloat) TOP.value.uFloat *= a.value.uFloat;
+		else if (TOP.type == PVFloat) TOP.value.uFloat *= (double) a.value.uInt;
+		else TOP = PVALUE(PVFloat, uFloat, (double) TOP.value.uInt * a.value.uFloat);
+		NEXT();
+	OP(OpSub):
+		b = POP();
+		a = POP();
+		if (!numericOperands(&a, &b, &errflg) || errflg) PUSH(nullPValue);
+		else PUSH(subPValues(a, b, &errflg));
+		NEXT();
+	OP(OpDiv):
+		b = POP();
+		a = POP();
+		if (!numericOperands(&a, &b, &errflg) || errflg) PUSH(nullPValue);
+		else PUSH(divPValues(a, b, &errflg));
+		NEXT();
+	OP(OpMod):
+		b = POP();
+		a = POP();
+		if (!numericOperands(&a, &b, &errflg) || errflg) PUSH(nullPValue);
+		else PUSH(modPValues(a, b, &errflg));
+		NEXT();
+	OP(OpNeg):
+		a = POP();
+		if (errflg) {
+			clearPValue(&a);
+			PUSH(nullPValue);
+		} else PUSH(negPValue(a, &errflg));
+		NEXT();
+	OP(OpNot):
+		a = POP();
+		if (errflg) PUSH(nullPValue);
+		else PUSH(pvalueToBoolean(a) ? falsePValue : truePValue);
+		clearPValue(&a);
+		NEXT();
+	OP(OpDecimal):
+		a = POP();
+		if (a.type == PVBool) PUSH(createStringPValue(a.value.uBool ? "1" : "0"));
+		else if (errflg || a.type != PVInt) {
+			clearPValue(&a);
+			PUSH(nullPValue);
+		} else {
+			char scratch[20];
+			sprintf(scratch, "%ld", a.value.uInt);
+			PUSH(createStringPValue(scratch));
+		}
+		NEXT();
+	OP(OpEq):
+		b = POP();
+		a = POP();
+		if (errflg) PUSH(nullPValue);
+		else PUSH(PVALUE(PVBool, uBool, equalValues(a, b)));
+		clearPValue(&a);
+		clearPValue(&b);
+		NEXT();
+	OP(OpNe):
+		b = POP();
+		a = POP();
+		if (errflg) PUSH(nullPValue);
+		else PUSH(PVALUE(PVBool, uBool, !equalValues(a, b)));
+		clearPValue(&a);
+		clearPValue(&b);
+		NEXT();
+	OP(OpLt):
+		b = POP();
+		a = POP();
+		if (!numericOperands(&a, &b, &errflg) || errflg) PUSH(nullPValue);
+		else if (a.type == PVInt) PUSH(PVALUE(PVBool, uBool, a.value.uInt < b.value.uInt));
+		else PUSH(PVALUE(PVBool, uBool, a.value.uFloat < b.value.uFloat));
+		NEXT();
+	OP(OpLe):
+		b = POP();
+		a = POP();
+		if (!numericOperands(&a, &b, &errflg) || errflg) PUSH(nullPValue);
+		else if (a.type == PVInt) PUSH(PVALUE(PVBool, uBool, a.value.uInt <= b.value.uInt));
+		else PUSH(PVALUE(PVBool, uBool, a.value.uFloat <= b.value.uFloat));
+		NEXT();
+	OP(OpGt):
+		b = POP();
+		a = POP();
+		if (!numericOperands(&a, &b, &errflg) || errflg) PUSH(nullPValue);
+		else if (a.type == PVInt) PUSH(PVALUE(PVBool, uBool, a.value.uInt > b.value.uInt));
+		else PUSH(PVALUE(PVBool, uBool, a.value.uFloat > b.value.uFloat));
+		NEXT();
+	OP(OpGe):
+		b = POP();
+		a = POP();
+		if (!numericOperands(&a, &b, &errflg) || errflg) PUSH(nullPValue);
+		else if (a.type == PVInt) PUSH(PVALUE(PVBool, uBool, a.value.uInt >= b.value.uInt));
+		else PUSH(PVALUE(PVBool, uBool, a.value.uFloat >= b.value.uFloat));
+		NEXT();
+	OP(OpAnd):
+		a = POP();
+		if (errflg) {
+			clearPValue(&a);
+			PUSH(nullPValue);
+			JUMP(ip->b);
+		}
+		if (!pvalueToBoolean(a)) {
+			clearPValue(&a);
+			PUSH(falsePValue);
+			JUMP(ip->b);
+		}
+		clearPValue(&a);
+		NEXT();
+	OP(OpOr):
+		a = POP();
+		if (errflg) {
+			clearPValue(&a);
+			PUSH(nullPValue);
+			JUMP(ip->b);
+		}
+		if (pvalueToBoolean(a)) {
+			clearPValue(&a);
+			PUSH(truePValue);
+			JUMP(ip->b);
+		}
+		clearPValue(&a);
+		NEXT();
+
+	// Statements.
+	OP(OpOutput):
+		poutput(ip->pnode->stringCons, context);
+		NEXT();
+	OP(OpOutputSlot):
+		output(getValueOfSlot(context, ip->a), context);
+		NEXT();
+	OP(OpOutputValue):
+		a = POP();
+		if (errflg) {
+			clearPValue(&a);
+			scriptError(ip->pnode, "error calling built-in function: %s", ip->pnode->funcName);
+			goto error;
+		}
+		output(a, context);
+		NEXT();
+	OP(OpBuiltinStatement):
+		a = ip->pnode->builtinFunc(ip->pnode, context, &errflg);
+		if (errflg) {
+			scriptError(ip->pnode, "error calling built-in function: %s", ip->pnode->funcName);
+			goto error;
+		}
+		output(a, context);
+		NEXT();
+	OP(OpFunctionStatement):
+		sp -= ip->a;
+		a = callFunction(ip->pnode, sp, context, &errflg);
+		if (errflg) goto error;
+		output(a, context);
+		collect(context);
+		NEXT();
+	OP(OpProcedure): {
+		PNode* proc = ip->pnode->routine;
+		if (callTracing) printf("calling: %s (line %d)\n", ip->pnode->procName, ip->pnode->lineNumber);
+		sp -= ip->a;
+		Frame* frame = createFrame(context, ip->pnode, proc);
+		bindArguments(frame, proc, sp);
+		switch (runRoutine(proc, frame, context, returnValue)) {
+		case InterpReturn:
+		case InterpOkay: break;
+		default: goto error;
+		}
+		if (returnValue && returnValue->type == PVString && returnValue->value.uString) {
+			poutput(returnValue->value.uString, context);
+			releasePString(returnValue->value.uString);
+		}
+		collect(context);
+		NEXT();
+	}
+	OP(OpSet):
+		a = POP();
+		if (errflg) {
+			scriptError(ip->pnode, "error calling built-in function: %s", ip->pnode->funcName);
+			goto error;
+		}
+		assignValueToSlot(context, ip->a, a);
+		NEXT();
+	OP(OpIncr):
+	OP(OpDecr):
+		a = getValueOfSlot(context, ip->a);
+		if (a.type != PVInt) {
+			clearPValue(&a);
+			scriptError(ip->pnode, "error calling built-in function: %s", ip->pnode->funcName);
+			goto error;
+		}
+		a.value.uInt += ip->op == OpIncr ? 1 : -1;
+		assignValueToSlot(context, ip->a, a);
+		NEXT();
+	OP(OpCondition):
+		a = POP();
+		if (errflg) {
+			scriptError(ip->pnode, "There was an error evaluating the conditional expression");
+			goto error;
+		}
+		if (pvalueToBoolean(a)) {
+			clearPValue(&a);
+			NEXT();
+		}
+		clearPValue(&a);
+		JUMP(ip->b);
+	OP(OpConditionSet):
+		a = POP();
+		if (errflg) {
+			scriptError(ip->pnode, "There was an error evaluating the conditional expression");
+			goto error;
+		}
+		assignValueToSlot(context, ip->a, a);
+		if (pvalueToBoolean(a)) NEXT();
+		JUMP(ip->b);
+	OP(OpConditionError):
+		scriptError(ip->pnode, "The first argument in a conditional expression must be an identifier.");
+		goto error;
+	OP(OpJump):
+		JUMP(ip->b);
+	OP(OpLoop):
+		collect(context);
+		JUMP(ip->b);
+	OP(OpReturnValue): // The flag is ignored, as in interpret.
+		a = POP();
+		if (returnValue) *returnValue = a;
+		else clearPValue(&a);
+		errflg = false;
+		NEXT();
+	OP(OpEnd):
+		returnCode = InterpOkay;
+		goto done;
+	OP(OpBreak):
+		returnCode = InterpBreak;
+		goto done;
+	OP(OpContinue):
+		returnCode = InterpContinue;
+		goto done;
+	OP(OpReturn):
+		returnCode = InterpReturn;
+		goto done;
+	OP(OpFatal):
+		FATAL();
+
+	// Loops over the children of a family.
+	OP(OpChildren):
+		a = POP();
+		gnode = pvalueToFamily(a, ip->pnode->familyExpr, &errflg);
+		if (errflg || !gnode || gnode->tagId != tagFAM) {
+			scriptError(ip->pnode, "the first argument to children must be a family");
+			goto error;
+		}
+		loops[ip->a] = (Loop){ .root = gnode };
+		NEXT();
+	OP(OpNextChild):
+		loop = &loops[ip->a];
+		gnode = loop->node ? nextTagged(loop->node, tagCHIL) : findTagId(loop->root->child, tagCHIL);
+		if (!gnode) JUMP(ip->b);
+		loop->node = gnode;
+		gnode = REFTOPERSON(gnode, index);
+		ASSERT(gnode);
+		assignValueToSlot(context, ip->pnode->childSlot, PVALUE(PVPerson, uGNode, gnode));
+		assignValueToSlot(context, ip->pnode->countSlot, PVALUE(PVInt, uInt, ++loop->count));
+		NEXT();
+
+	// Loops over the spouses of a person.
+	OP(OpSpouses):
+		a = POP();
+		gnode = pvalueToPerson(a, ip->pnode->personExpr, &errflg);
+		if (errflg || !gnode || gnode->tagId != tagINDI) {
+			scriptError(ip->pnode, "the first argument to spouses must be a person");
+			goto error;
+		}
+		loops[ip->a] = (Loop){ .root = gnode, .sex = SEXV(gnode) };
+		NEXT();
+	OP(OpNextSpouse): {
+		loop = &loops[ip->a];
+		GNode *fam = null, *spouse = null;
+		gnode = loop->node ? nextTagged(loop->node, tagFAMS) : FAMS(loop->root);
+		for (; gnode; gnode = nextTagged(gnode, tagFAMS)) {
+			fam = REFTOFAMILY(gnode, index);
+			spouse = loop->sex == sexMale ? familyToWife(fam, index) : familyToHusband(fam, index);
+			if (spouse) break;
+		}
+		if (!gnode) JUMP(ip->b);
+		loop->node = gnode;
+		assignValueToSlot(context, ip->pnode->spouseSlot, PVALUE(PVPerson, uGNode, spouse));
+		assignValueToSlot(context, ip->pnode->familySlot, PVALUE(PVFamily, uGNode, fam));
+		assignValueToSlot(context, ip->pnode->countSlot, PVALUE(PVInt, uInt, ++loop->count));
+		NEXT();
+	}
+
+	// Loops over the families of a person.
+	OP(OpFamilies):
+		a = POP();
+		gnode = pvalueToPerson(a, ip->pnode->personExpr, &errflg);
+		if (errflg || !gnode || gnode->tagId != tagINDI) {
+			scriptError(ip->pnode, "the first argument to families must be a person");
+			goto error;
+		}
+		loops[ip->a] = (Loop){ .root = gnode };
+		NEXT();
+	OP(OpNextFamily): {
+		loop = &loops[ip->a];
+		gnode = loop->node ? nextTagged(loop->node, tagFAMS) : FAMS(loop->root);
+		if (!gnode) JUMP(ip->b);
+		loop->node = gnode;
+		GNode* fam = REFTOFAMILY(gnode, index);
+		assignValueToSlot(context, ip->pnode->familySlot, PVALUE(PVFamily, uGNode, fam));
+		SexType sex = SEXV(loop->root);
+		GNode* spouse = null;
+		if (sex == sexMale) spouse = familyToWife(fam, index);
+		else if (sex == sexFemale) spouse = familyToHusband(fam, index);
+		assignValueToSlot(context, ip->pnode->spouseSlot,
+						  spouse ? PVALUE(PVPerson, uGNode, spouse) : nullPValue);
+		assignValueToSlot(context, ip->pnode->countSlot, PVALUE(PVInt, uInt, ++loop->count));
+		NEXT();
+	}
+
+	// Loops over the fathers, mothers and parents' families of a person.
+	OP(OpFathers):
+	OP(OpMothers):
+	OP(OpParents):
+		a = POP();
+		gnode = pvalueToPerson(a, ip->pnode->personExpr, &errflg);
+		if (errflg || !gnode || gnode->tagId != tagINDI) {
+			scriptError(ip->pnode, "the first argument to %s must be a person",
+						ip->op == OpFathers ? "fathers" : ip->op == OpMothers ? "mothers" : "parents");
+			goto error;
+		}
+		loops[ip->a] = (Loop){ .root = gnode };
+		NEXT();
+	OP(OpNextFather):
+	OP(OpNextMother): {
+		loop = &loops[ip->a];
+		GNode *fam = null, *parent = null;
+		gnode = loop->node ? nextTagged(loop->node, tagFAMC) : FAMC(loop->root);
+		for (; gnode; gnode = nextTagged(gnode, tagFAMC)) {
+			fam = REFTOFAMILY(gnode, index);
+			parent = ip->op == OpNextFather ? familyToHusband(fam, index) : familyToWife(fam, index);
+			if (parent) break;
+		}
+		if (!gnode) JUMP(ip->b);
+		loop->node = gnode;
+		assignValueToSlot(context, ip->pnode->familySlot, PVALUE(PVFamily, uGNode, fam));
+		assignValueToSlot(context, ip->pnode->fatherSlot, PVALUE(PVFamily, uGNode, parent)); // Also motherSlot.
+		assignValueToSlot(context, ip->pnode->countSlot, PVALUE(PVInt, uInt, ++loop->count));
+		NEXT();
+	}
+	OP(OpNextParent):
+		loop = &loops[ip->a];
+		gnode = loop->node ? nextTagged(loop->node, tagFAMC) : FAMC(loop->root);
+		if (!gnode) JUMP(ip->b);
+		loop->node = gnode;
+		assignValueToSlot(context, ip->pnode->familySlot,
+						  PVALUE(PVFamily, uGNode, REFTOFAMILY(gnode, index)));
+		assignValueToSlot(context, ip->pnode->countSlot, PVALUE(PVInt, uInt, ++loop->count));
+		NEXT();
+
+	// Loops over the NOTEs of a node.
+	OP(OpNotes):
+		a = POP();
+		gnode = pvalueToGNode(a, &errflg);
+		if (errflg) {
+			scriptError(ip->pnode, "first arg of fornotes() must evaluate to a gedcom node.");
+			goto error;
+		}
+		loops[ip->a] = (Loop){ .root = gnode };
+		if (!gnode) JUMP(ip->b);
+		NEXT();
+	OP(OpNextNote):
+		loop = &loops[ip->a];
+		if (loop->note) stdfree(loop->note);
+		loop->note = null;
+		gnode = loop->node ? loop->node->sibling : loop->root->child;
+		while (gnode && strcmp("NOTE", gnode->tag)) gnode = gnode->sibling;
+		if (!gnode) JUMP(ip->b);
+		loop->node = gnode;
+		loop->note = full_value(gnode);
+		assignValueToSlot(context, ip->pnode->noteSlot, createStringPValue(loop->note));
+		NEXT();
+	OP(OpEndNotes):
+		loop = &loops[ip->a];
+		if (loop->note) stdfree(loop->note);
+		loop->note = null;
+		NEXT();
+
+	// Loops over the children of a node.
+	OP(OpNodes):
+		a = POP();
+		gnode = pvalueToGNode(a, &errflg);
+		if (errflg || !gnode) {
+			scriptError(ip->pnode, "the first argument to fornodes must be a Gedcom node/line");
+			goto error;
+		}
+		loops[ip->a] = (Loop){ .root = gnode };
+		NEXT();
+	OP(OpNextNode):
+		loop = &loops[ip->a];
+		gnode = loop->node ? loop->node->sibling : loop->root->child;
+		if (!gnode) JUMP(ip->b);
+		loop->node = gnode;
+		assignValueToSlot(context, ip->pnode->gnodeSlot, PVALUE(PVGNode, uGNode, gnode));
+		NEXT();
+
+	// Loops over the records of the Database. The types of the source and other records are
+	// those the tree walker gives them.
+	OP(OpRecords): {
+		Database* database = context->database;
+		loop = &loops[ip->a];
+		*loop = (Loop){ .index = -1 };
+		switch (ip->pnode->type) {
+		case PNIndis: loop->records = database->personRoots; loop->type = PVPerson; break;
+		case PNFams: loop->records = database->familyRoots; loop->type = PVFamily; break;
+		case PNSources: loop->records = database->sourceRoots; loop->type = PVFamily; break;
+		case PNEvents: loop->records = database->eventRoots; loop->type = PVEvent; break;
+		default: loop->records = database->otherRoots; loop->type = PVEvent; break;
+		}
+		NEXT();
+	}
+	OP(OpNextRecord):
+		loop = &loops[ip->a];
+		if (++loop->index >= lengthList(loop->records)) JUMP(ip->b);
+		gnode = getListElement(loop->records, loop->index);
+		assignValueToSlot(context, ip->pnode->slotOne, (PValue){loop->type, PV(.uGNode = gnode)});
+		assignValueToSlot(context, ip->pnode->countSlot, PVALUE(PVInt, uInt, loop->index));
+		NEXT();
+	OP(OpEndRecords):
+		clearLocalSlot(context, ip->pnode->slotOne);
+		clearLocalSlot(context, ip->pnode->countSlot);
+		NEXT();
+
+	// Loops over the elements of a Sequence.
+	OP(OpSequence):
+		a = POP();
+		if (errflg || a.type != PVSequence) {
+			scriptError(ip->pnode, "the first argument to forindiset must be a set");
+			goto error;
+		}
+		pushRoot(context, a); // No variable need hold the Sequence.
+		loops[ip->a] = (Loop){ .value = a, .index = -1 };
+		NEXT();
+	OP(OpNextElement): {
+		loop = &loops[ip->a];
+		Block* block = &(loop->value.value.uSequence->block);
+		if (++loop->index >= block->length) JUMP(ip->b);
+		SequenceEl* element = (SequenceEl*) block->elements[loop->index];
+		gnode = keyToPerson(element->root->key, index);
+		assignValueToSlot(context, ip->pnode->elementSlot, PVALUE(PVPerson, uGNode, gnode));
+		assignValueToSlot(context, ip->pnode->valueSlot,
+						  element->value ? retainPValue(*(element->value)) : nullPValue);
+		assignValueToSlot(context, ip->pnode->countSlot, PVALUE(PVInt, uInt, loop->index + 1));
+		NEXT();
+	}
+	OP(OpEndSequence):
+		popRoot(context);
+		NEXT();
+
+	// Loops over the elements of a List.
+	OP(OpList):
+		a = POP();
+		if (errflg) {
+			scriptError(ip->pnode, "The first argument to forlist must be a list");
+			goto error;
+		}
+		if (!a.value.uList) {
+			scriptError(ip->pnode, "The first argument to forlist is in error");
+			goto error;
+		}
+		pushRoot(context, a); // No variable need hold the List.
+		loops[ip->a] = (Loop){ .value = a, .index = -1 };
+		NEXT();
+	OP(OpNextItem): {
+		loop = &loops[ip->a];
+		Block* block = &(loop->value.value.uList->block);
+		if (++loop->index >= block->length) JUMP(ip->b);
+		PValue* item = (PValue*) block->elements[loop->index];
+		assignValueToSlot(context, ip->pnode->elementSlot, retainPValue(*item));
+		assignValueToSlot(context, ip->pnode->countSlot, PVALUE(PVInt, uInt, loop->index));
+		NEXT();
+	}
+	OP(OpEndList):
+		popRoot(context);
+		NEXT();
+
+	// Loops over the nodes of a tree of GNodes, visiting each before its children.
+	OP(OpTraverse):
+		a = POP();
+		gnode = pvalueToGNode(a, &errflg);
+		if (errflg || !gnode) {
+			scriptError(ip->pnode, "the first argument to traverse must be a Gedcom line");
+			goto error;
+		}
+		loops[ip->a] = (Loop){ .nodes = nodes + ip->b*MAXTRAVERSEDEPTH };
+		loops[ip->a].nodes[0] = gnode;
+		NEXT();
+	OP(OpNextTraverse): {
+		loop = &loops[ip->a];
+		GNode** stack = loop->nodes;
+		int level = loop->index;
+		if (loop->node) { // Move to the first child, the next sibling, or an ancestor's sibling.
+			if (stack[level]->child) {
+				if (level + 1 >= MAXTRAVERSEDEPTH) {
+					scriptError(ip->pnode, "maximum traversal depth exceeded");
+					clearLocalSlot(context, ip->pnode->levelSlot);
+					clearLocalSlot(context, ip->pnode->gnodeSlot);
+					goto error;
+				}
+				stack[level + 1] = stack[level]->child;
+				level++;
+			} else if (stack[level]->sibling) {
+				stack[level] = stack[level]->sibling;
+			} else {
+				while (--level >= 0 && !(stack[level]->sibling)) { }
+				if (level < 0) JUMP(ip->b);
+				stack[level] = stack[level]->sibling;
+			}
+			loop->index = level;
+		}
+		loop->node = stack[level];
+		assignValueToSlot(context, ip->pnode->levelSlot, PVALUE(PVInt, uInt, level));
+		assignValueToSlot(context, ip->pnode->gnodeSlot, PVALUE(PVGNode, uGNode, stack[level]));
+		NEXT();
+	}
+	OP(OpEndTraverse):
+		clearLocalSlot(context, ip->pnode->levelSlot);
+		clearLocalSlot(context, ip->pnode->gnodeSlot);
+		NEXT();
+
+#if !defined(__GNUC__)
+	}
+#endif
+
+error:
+	returnCode = InterpError;
+done:
+	while (sp > stack) clearPValue(--sp);
+	context->aggregates->numRoots = numRoots; // Roots of the loops an error left.
+	return returnCode;
+}
@@ -3,9 +3,10 @@
 // addtofamily.c has functions to add an existing child or spouse to an existing family.
 //
 // Created by Thomas Wetmore on 30 May 2024.
-// Last changed on 18 May 2025.
+// Last changed on 19 October 2026.
 
 #include "stdlib.h"
+#include "database.h"
 #include "splitjoin.h"
 #include "gnode.h"
 #include "gedcom.h"
@@ -26,6 +27,7 @@ bool addChildToFamily (GNode *child, GNode *family, int index, Database *databas
 		node = node->sibling;
 	}
 	GNode* new = createGNode(null, "CHIL", child->key, family);
+	new->referent = child;
 	new->sibling = node;
 	if (prev)
 		prev->sibling = new;
@@ -36,6 +38,7 @@ bool addChildToFamily (GNode *child, GNode *family, int index, Database *databas
 	GNode *names, *irefns, *sex, *body, *famcs, *famss;
 	splitPerson(child, &names, &irefns, &sex, &body, &famcs, &famss);
 	GNode *nfmc = createGNode(null, "FAMC", family->key, child);
+	nfmc->referent = family;
 	prev = null;
 	GNode *this = famcs;
 	while (this) {
@@ -47,6 +50,7 @@ bool addChildToFamily (GNode *child, GNode *family, int index, Database *databas
 	else
 		prev->sibling = nfmc;
 	joinPerson(child, names, irefns, sex, body, famcs, famss);
+	noteDatabaseEdit(database);
 	return true;
 }
 
@@ -64,6 +68,7 @@ bool addSpouseToFamily (GNode* spouse, GNode* family, SexType sext, Database* da
 			this = this->sibling;
 		}
 		GNode *new = createGNode(NULL, "HUSB", spouse->key, family);
+		new->referent = spouse;
 		if (prev)
 			prev->sibling = new;
 		else
@@ -75,6 +80,7 @@ bool addSpouseToFamily (GNode* spouse, GNode* family, SexType sext, Database* da
 			this = this->sibling;
 		}
 		GNode *new = createGNode(NULL, "WIFE", spouse->key, family);
+		new->referent = spouse;
 		if (prev)
 			prev->sibling = new;
 		else
@@ -85,6 +91,7 @@ bool addSpouseToFamily (GNode* spouse, GNode* family, SexType sext, Database* da
 	GNode *names, *irefns, *sex, *body, *famcs, *famss;
 	splitPerson(spouse, &names, &irefns, &sex, &body, &famcs, &famss);
 	GNode *nfams = createGNode(NULL, "FAMS", family->key, spouse);
+	nfams->referent = family;
 	prev = null;
 	this = famss;
 	while (this) {
@@ -96,6 +103,7 @@ bool addSpouseToFamily (GNode* spouse, GNode* family, SexType sext, Database* da
 	else
 		prev->sibling = nfams;
 	joinPerson(spouse, names, irefns, sex, body, famcs, famss);
+	noteDatabaseEdit(database);
 	return true;
 }
 
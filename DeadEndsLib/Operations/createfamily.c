@@ -3,7 +3,7 @@
 // createfamily.c creates a new family in a Database.
 //
 // Created by Thomas Wetmore on 30 May 2024.
-// Last changed on 8 June 2024.
+// Last changed on 19 October 2026.
 
 #include "database.h"
 #include "gnode.h"
@@ -26,7 +26,7 @@ GNode* createFamily(GNode* husb, GNode* wife, GNode* chil, GNode* rest, Database
 // checkFamilyMember checks if a person can be added to a new family.
 static bool checkFamilyMember(GNode* person, SexType sex) {
 	if (!person) return true;
-	if (nestr(person->tag, "INDI")) return false;
+	if (person->tagId != tagINDI) return false;
 	if (sex == sexUnknown) return true;
 	GNode* snode = findTag(person, "SEX)");
 	if (!snode || !snode->value || nestr(snode->value, sexTypeToString(sex))) return false;
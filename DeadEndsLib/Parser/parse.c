@@ -4,11 +4,12 @@
 //  parse.c contains two functions, parseProgram and parseFile, which parse DeadEnds scripts.
 //
 //  Created by Thomas Wetmore on 4 January 2023.
-//  Last changed on 13 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include <stdarg.h>
 #include <unistd.h>
+#include "compile.h"
 #include "context.h"
 #include "functiontable.h"
 #include "gedcom.h"
@@ -16,10 +17,12 @@
 #include "integertable.h"
 #include "interp.h"
 #include "list.h"
+#include "optimize.h"
 #include "parse.h"
 #include "path.h"
 #include "pnode.h"
 #include "pvalue.h"
+#include "resolver.h"
 #include "set.h"
 #include "stringset.h"
 #include "symboltable.h"
@@ -40,10 +43,13 @@ String curFileName = null; // File being parsed
 FILE* currentFile = null; // FILE being parsed.
 int curLine = 1; // Line number in current file.
 
-// parseProgram parses a DeadEnds program and returns a Program object to be interpreted.
+// parseProgram parses a DeadEnds program and returns a Program object to be interpreted. The
+// parser's error count and state are reset on entry and on each return, so a process that parses
+// many scripts, such as QueryServer, is not affected by an earlier script's errors.
 static void delete(void* a) { stdfree(a); }
 Program* parseProgram(String fileName, String searchPath) {
-
+    Perrors = 0;
+    programParsing = true;
     parsedFiles = createList(null, null, delete, false);  // Parsed file names.
     pendingFiles = createList(null, null, delete, false); // Queue of pending files.
 	Set* included = createStringSet(); // Set of parsed file names.
@@ -53,7 +59,6 @@ Program* parseProgram(String fileName, String searchPath) {
 
     // Init pendingFiles with main program. Use strsave so parsedFiles can be deleted safely.
     enqueueList(pendingFiles, strsave(fileName));
-    programParsing = true;
 
     // Parse the files in the pendingFiles queue.
     while (!isEmptyList(pendingFiles)) {
@@ -73,13 +78,14 @@ Program* parseProgram(String fileName, String searchPath) {
         deleteList(globalIdents);
         deleteFunctionTable(procedures);
         deleteFunctionTable(functions);
+        procedures = functions = null;
+        globalIdents = null;
+        parsedFiles = null;
+        Perrors = 0;
+        programParsing = false;
         return null;
     }
 
-    // Check that all called functions and procedures are defined.
-    validateCalls(procedures, functions);
-
-
     // Parsing was successful. Create and return a Program.
     Program* program = createProgram();
     program->globalIdents = globalIdents;
@@ -91,6 +97,14 @@ Program* parseProgram(String fileName, String searchPath) {
     globalIdents = null;
     parsedFiles = null;
     programParsing = false;
+    // Link the calls to the routines they call. A Program with undefined calls is not run.
+    if (linkProgram(program)) {
+        deleteProgram(program);
+        return null;
+    }
+    optimizeProgram(program); // Fold constants and remove dead branches.
+    resolveProgram(program); // Give the variables their slots.
+    compileProgram(program); // Compile the routines to bytecode if compiling.
     return program;
 }
 
@@ -4,7 +4,7 @@
 //  errors.h is the header file for DeadEnds Errors.
 //
 //  Created by Thomas Wetmore on 4 July 2023.
-//  Last changed on 3 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #ifndef errors_h
@@ -45,6 +45,7 @@ ErrorLog *createErrorLog(void);
 void deleteErrorLog(ErrorLog*);
 Error *createError(ErrorType type, String fileName, int lineNumber, String message);
 void deleteError(Error*);
+void setSeverityError(Error*, ErrorSeverity);
 void addErrorToLog(ErrorLog*, Error*);
 void showErrorLog(ErrorLog*);
 void showError(Error*);
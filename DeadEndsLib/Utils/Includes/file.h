@@ -4,7 +4,7 @@
 // file.h holds the functions for File data types. These are the output files used for script output.
 //
 // Created by Thomas Wetmore on 1 July 2024.
-// Last changed on 26 June 2025.
+// Last changed on 19 October 2026.
 //
 
 #ifndef file_h
@@ -12,15 +12,22 @@
 
 #include "standard.h"
 
+// PageRow is a row of a Page. Its cells are allocated when it is first written. first and last
+// are the columns, from 0, written since the Page was last output; last < first if none were.
+typedef struct PageRow {
+    int32_t* cells; // ncols Unicode codepoints; null until the row is written.
+    int first;
+    int last;
+} PageRow;
+
 // Page is a page buffer if program output is in PageMode. nrows and ncols are used in page mode.
-// currow is used in page mode. curcol is used in both modes. grid is used in page mode. curcol
-// has no limit in line mode.
+// currow is used in page mode. curcol is used in both modes. rows are used in page mode. curcol
+// has no limit in line mode. Rows that are never written cost nothing.
 typedef struct Page {
     int nrows;
     int ncols;
     int currow;
-    //int curcol;
-    int32_t* grid; // size = nrows * ncols, contains Unicode codepoints.
+    PageRow* rows; // nrows rows.
 } Page;
 
 // FileType is an enum that defines the types of Files, now restricted to lineMode and pageMode.
@@ -29,7 +36,11 @@ typedef enum FileMode {
     pageMode,
 } FileMode;
 
-// File is a structure that holds a file's name and Unix FILE pointer.
+// FILEBUFSIZE is the size of the buffers that hold output before it is written to a Unix file.
+#define FILEBUFSIZE 65536
+
+// File is a structure that holds a file's name and Unix FILE pointer. Output is kept in the
+// buffer until it fills or the File is flushed or closed.
 typedef struct File {
     FILE* fp;       // Unix file pointer.
     String path;    // Path to file.
@@ -38,11 +49,18 @@ typedef struct File {
     FileMode mode;  // Mode of file -- line mode or page mode.
     int curcol;     // Column where next output occurs.
     Page* page;     // Page if in page mode.
+    char* buffer;   // Output not yet written; allocated on the first write.
+    int length;     // Number of bytes in the buffer.
 } File;
 
 // Public API to File.
 File* openFile(String path, String mode);
 File* stdOutputFile(void);
+File* streamOutputFile(FILE*, String name);
 void closeFile(File*);
+void writeFile(File*, String); // Writes a String and updates the column.
+void writeFileBytes(File*, String, int); // Writes bytes; the column is not changed.
+void flushFile(File*);
+void flushStdout(void); // Flushes the stdout File so other output to stdout follows it.
 
 #endif // file_h
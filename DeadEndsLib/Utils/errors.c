@@ -3,7 +3,7 @@
 //  errors.c has code for handling DeadEnds errors.
 //
 //  Created by Thomas Wetmore on 4 July 2023.
-//  Last changed on 5 May 2025.
+//  Last changed on 19 October 2026.
 
 #include "errors.h"
 #include "list.h"
@@ -76,7 +76,7 @@ void addErrorToLog (ErrorLog* errorLog, Error* error) {
 
 // showError shows an Error on standard output.
 void showError(Error* error) {
-	printf("error");
+	printf(error->severity == warningError ? "warning" : "error");
 	if (error->fileName) printf(" in %s", error->fileName);
 	if (error->lineNumber) printf(" line %d", error->lineNumber);
 	if (error->message) printf(": %s\n", error->message);
@@ -4,7 +4,7 @@
 // file.c
 //
 // Created by Thomas Wetmore on 1 July 2024.
-// Last changed on 1 July 2025.
+// Last changed on 19 October 2026.
 //
 
 #include <stdio.h>
@@ -12,6 +12,23 @@
 
 extern void deletePage(Page*);
 
+static File* stdoutFile = null; // The stdout File, if there is one.
+
+// createFile creates a File structure in line mode for an open UNIX file.
+static File* createFile(FILE* fp, String path, String name, bool isStdout) {
+    File* file = (File*) stdalloc(sizeof(File));
+    file->path = strsave(path);
+    file->name = strsave(name);
+    file->fp = fp;
+    file->isStdout = isStdout;
+    file->mode = lineMode;
+    file->curcol = 1;
+    file->page = null;
+    file->buffer = null;
+    file->length = 0;
+    return file;
+}
+
 // openFile creates a File structure and opens the underlying UNIX file. When a File is opened it is given
 // line mode by default.
 File* openFile(String path, String mode) {
@@ -22,19 +39,14 @@ File* openFile(String path, String mode) {
         fclose(fp);
         return null;
     }
-	File* file = (File*) stdalloc(sizeof(File));
-	file->path = strsave(path);
-	file->name = strsave(name);
-    file->fp = fp;
-    file->isStdout = false;
-    file->mode = lineMode;
-    file->curcol = 1;
-    file->page = null;
-	return file;
+    return createFile(fp, path, name, false);
 }
 
-// closeFile closes the UNIX file and deletes the File structure.
+// closeFile writes the buffered output, closes the UNIX file and deletes the File structure.
 void closeFile(File* file) {
+    flushFile(file);
+    if (file == stdoutFile) stdoutFile = null;
+    if (file->buffer) stdfree(file->buffer);
     if (!file->isStdout && file->fp) fclose(file->fp);
     if (file->path) stdfree(file->path);
     if (file->name) stdfree(file->name);
@@ -44,31 +56,90 @@ void closeFile(File* file) {
 
 // stdOutputFile returns a File structure for UNIX stdout.
 File* stdOutputFile(void) {
-    File* file = (File*) stdalloc(sizeof(File));
-    file->path = strsave(".");
-    file->name = strsave("stdout");
-    file->fp = stdout;
-    file->isStdout = true;
-    file->mode = lineMode;
-    file->page = null;
-    return file;
+    stdoutFile = createFile(stdout, ".", "stdout", true);
+    return stdoutFile;
 }
 
-// createPage creates a new page with a grid of rows * cols Unicode code points.
+// streamOutputFile returns a File structure for an open UNIX stream, such as a socket; closing
+// the File closes the stream.
+File* streamOutputFile(FILE* fp, String name) {
+    return createFile(fp, ".", name, false);
+}
+
+// writeFile writes a String to a File, updating the column as the String is copied to the
+// buffer.
+void writeFile(File* file, String string) {
+    if (!file->buffer) file->buffer = (char*) stdalloc(FILEBUFSIZE);
+    char* buffer = file->buffer;
+    int length = file->length;
+    int curcol = file->curcol;
+    for (int c; (c = *string); string++) {
+        if (length == FILEBUFSIZE) {
+            file->length = length;
+            flushFile(file);
+            length = 0;
+        }
+        buffer[length++] = c;
+        curcol = c == '\n' ? 1 : curcol + 1;
+    }
+    file->length = length;
+    file->curcol = curcol;
+}
+
+// writeFileBytes writes bytes to a File without changing the column.
+void writeFileBytes(File* file, String bytes, int count) {
+    if (!file->buffer) file->buffer = (char*) stdalloc(FILEBUFSIZE);
+    if (file->length + count > FILEBUFSIZE) flushFile(file);
+    if (count > FILEBUFSIZE) {
+        fwrite(bytes, 1, count, file->fp);
+        return;
+    }
+    memcpy(file->buffer + file->length, bytes, count);
+    file->length += count;
+}
+
+// flushFile writes the buffered output of a File to its UNIX file.
+void flushFile(File* file) {
+    if (!file->length) return;
+    fwrite(file->buffer, 1, file->length, file->fp);
+    file->length = 0;
+}
+
+// flushStdout flushes the stdout File. It is called before output is written to stdout in other
+// ways, such as error messages, so the output stays in order.
+void flushStdout(void) {
+    if (stdoutFile) flushFile(stdoutFile);
+}
+
+// createPage creates a new page of rows * cols Unicode code points. The rows are blank and have
+// no cells.
 Page* createPage(int rows, int cols) {
     Page* page = (Page*) stdalloc(sizeof(Page));
     page->nrows = rows;
     page->ncols = cols;
     page->currow = 1;
-    page->grid = (int32_t*) stdalloc(rows * cols * sizeof(int32_t));
-    for (int i = 0; i < page->nrows * page->ncols; i++) {
-        page->grid[i] = 0x20; // U+0020 = space
-    }
+    page->rows = (PageRow*) stdalloc(rows * sizeof(PageRow));
+    for (int i = 0; i < rows; i++) page->rows[i] = (PageRow) { null, cols, -1 };
     return page;
 }
 
+// pageRow returns a row of a Page, from 1, giving it cells of spaces if it has none. Not in the
+// public API.
+PageRow* pageRow(Page* page, int row) {
+    PageRow* prow = &(page->rows[row - 1]);
+    if (!prow->cells) {
+        prow->cells = (int32_t*) stdalloc(page->ncols * sizeof(int32_t));
+        for (int i = 0; i < page->ncols; i++) prow->cells[i] = 0x20; // U+0020 = space
+    }
+    return prow;
+}
+
 // deletePage deleges a Page. Not in the public API.
 void deletePage(Page* page) {
-    if (page && page->grid) stdfree(page->grid);
-    if (page) stdfree(page);
+    if (!page) return;
+    for (int i = 0; i < page->nrows; i++) {
+        if (page->rows[i].cells) stdfree(page->rows[i].cells);
+    }
+    stdfree(page->rows);
+    stdfree(page);
 }
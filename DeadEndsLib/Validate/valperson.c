@@ -4,7 +4,7 @@
 //  valperson.c contains functions that validate person records in a Database.
 //
 //  Created by Thomas Wetmore on 17 December 2023.
-//  Last changed on 3 August 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "database.h"
@@ -190,7 +190,7 @@ bool hasValidNameGNode(GNode* root, GNode** nnode) {
 			return false;
 		}
 		GNode* sib = name->sibling;
-		name = (sib && eqstr("NAME", sib->tag)) ? sib : null;
+		name = (sib && sib->tagId == tagNAME) ? sib : null;
 	}
 	return true;
 }
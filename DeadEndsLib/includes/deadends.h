@@ -3,7 +3,7 @@
 //  deadends.h is the 'umbrella' header file giving access to the DeadEnds library.
 //
 //  Created by Thomas Wetmore on 5 June 2025.
-//  Last changed on 5 June 2025.
+//  Last changed on 19 October 2026.
 
 #ifndef deadends_h
 #define deadends_h
@@ -26,20 +26,30 @@
 #include "gnodeindex.h"
 #include "gnodelist.h"
 #include "import.h"
+#include "kinship.h"
 #include "parse.h"
+#include "relationship.h"
 
 // Programming language engine
+#include "compile.h"
 #include "interp.h"
 #include "pnode.h"
+#include "profile.h"
 #include "pvalue.h"
 #include "sequence.h"
 
 // Context and database
 #include "context.h"
 #include "database.h"
+#include "generationindex.h"
 #include "nameindex.h"
+#include "nameorder.h"
+#include "namesearch.h"
+#include "placeindex.h"
 #include "recordindex.h"
 #include "rootlist.h"
+#include "textindex.h"
+#include "vitalindex.h"
 #include "errors.h"
 
 // Utilities
@@ -0,0 +1,70 @@
+//
+// DeadEnds Inbreeding
+//
+//  inbreeding.c is the DeadEnds Inbreeding program. It creates a Database from a Gedcom file and
+//  writes a report of the inbreeding coefficients of its persons to standard output.
+//
+//  usage: inbreeding -g gedcomfile [-t threads]
+//
+//  If DE_GEDCOM_PATH is defined, it may be used as a search path.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "deadends.h"
+
+// Local functions.
+static void usage(void);
+static void getArguments(int, char**, String*, int*);
+
+// Main program of the Inbreeding program.
+int main(int argc, char* argv[]) {
+    fprintf(stderr, "%s: Inbreeding started.\n", getMsecondsStr());
+    String gedcomFile = null;
+    int numThreads = 1;
+    getArguments(argc, argv, &gedcomFile, &numThreads);
+    String gedcomPath = getenv("DE_GEDCOM_PATH");
+    if (!gedcomPath) gedcomPath = ".";
+
+    // Build the Database from the Gedcom file.
+    gedcomFile = resolveFile(gedcomFile, gedcomPath, "ged");
+    ErrorLog* errorLog = createErrorLog();
+    Database* database = getDatabaseFromFile(gedcomFile, errorLog);
+    if (lengthList(errorLog)) showErrorLog(errorLog); // A Database may come with warnings.
+    if (!database) exit(1);
+    fprintf(stderr, "%s: Database created.\n", getMsecondsStr());
+
+    // Write the report.
+    writeInbreedingReport(database, stdout, numThreads);
+    fprintf(stderr, "%s: Inbreeding done.\n", getMsecondsStr());
+}
+
+// getArguments gets the file name and number of threads from the command line.
+static void getArguments(int argc, char* argv[], String* gedcom, int* numThreads) {
+    int ch;
+    while ((ch = getopt(argc, argv, "g:t:")) != -1) {
+        switch(ch) {
+        case 'g':
+            *gedcom = strsave(optarg);
+            break;
+        case 't':
+            *numThreads = atoi(optarg);
+            if (*numThreads < 1) *numThreads = 1;
+            break;
+        case '?':
+        default:
+            usage();
+            exit(1);
+        }
+    }
+    if (!*gedcom) {
+        usage();
+        exit(1);
+    }
+}
+
+// usage prints the Inbreeding usage message.
+static void usage(void) {
+    fprintf(stderr, "usage: inbreeding -g gedcomfile [-t threads]\n");
+}
@@ -2,7 +2,7 @@
 // CloneOne
 //
 // Created by Thomas Wetmore on 9 August 2924.
-// Last changed on 16 August 2024.
+// Last changed on 19 October 2026.
 
 #include "standard.h"
 #include "list.h"
@@ -25,6 +25,7 @@ AskReturn askForString(String, int, String*);
 AskReturn askForPattern(String, String pattern, int, String*);
 
 AskReturn askForPerson(Database*, int, GNode**);
+AskReturn getPersonFromName(Database*, String, GNode**);
 
 // NOTE: Think about moving this into the DataType sub-library.
 List* createStringList(String, ...);
@@ -3,11 +3,15 @@
 //  MenuLibrary
 //
 // Created by Thomas Wetmore on 8 August 2024.
-// Last changed on 9 September 2024
+// Last changed on 19 October 2026
 
 #include "standard.h"
 #include "ask.h"
+#include "gedcom.h"
+#include "gnode.h"
 #include "list.h"
+#include "name.h"
+#include "namesearch.h"
 #include "stdarg.h"
 #include "regex.h"
 
@@ -206,21 +210,50 @@ AskReturn askForPattern(String msg, String pattern, int returnSet, String* resul
 	return askOkay; // Cannot get here.
 }
 
+// askForPerson asks the user for a name and returns the root of the chosen person.
 AskReturn askForPerson(Database* database, int codes, GNode** proot) {
 	String name = null;
 	// Ask first time outside of loop.
 	AskReturn rcode = askForString("Enter the name of a person: ", askQuit, &name);
 	if (rcode == askQuit) return rcode; // User backed out.
-
-	return askOkay;
+	return getPersonFromName(database, name, proot);
 }
 
+// getPersonFromName finds the persons whose names match a name, best matches first, using the
+// Database's NameSearchIndex. Names may be partial or have a typing error. If one person matches
+// it is returned; if more match the user chooses one from a numbered list.
 AskReturn getPersonFromName(Database* database, String name, GNode** root) {
-	// Get the list of persons who match the name.
-	// If the list is of length one, return that one person.
-	// Get user to choose person from a List.
-	// If user doesn't choose return askQuit.
-	// If user does choose return askOkay with the GNode* of the person's root.
+	static int maxShown = 20;
+	*root = null;
+	List* keys = searchNames(getNameSearchIndex(database), name, nameSearchAll);
+	int count = lengthList(keys);
+	if (count == 0) {
+		printf("No person matches %s.\n", name);
+		deleteList(keys);
+		return askFail;
+	}
+	if (count > 1) {
+		for (int i = 0; i < count && i < maxShown; i++) {
+			GNode* person = keyToPerson((String) getListElement(keys, i), database->recordIndex);
+			GNode* nameNode = NAME(person);
+			printf("%2d. %s %s\n", i + 1, person->key,
+				   nameNode ? manipulateName(nameNode->value, false, true, 60) : "");
+		}
+		if (count > maxShown) printf("... and %d more.\n", count - maxShown);
+		int choice;
+		while (true) {
+			if (askForInteger("Enter the number of the person", askQuit, &choice) == askQuit) {
+				deleteList(keys);
+				return askQuit;
+			}
+			if (choice >= 1 && choice <= min(count, maxShown)) break;
+			printf("%d is not in the list.\n", choice);
+		}
+		*root = keyToPerson((String) getListElement(keys, choice - 1), database->recordIndex);
+	} else {
+		*root = keyToPerson((String) getListElement(keys, 0), database->recordIndex);
+	}
+	deleteList(keys);
 	return askOkay;
 }
 
@@ -3,7 +3,7 @@
 //  connect.c
 //
 //  Created by Thomas Wetmore on 5 October 2024.
-//  Last changed on 5 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "deadends.h"
@@ -34,11 +34,11 @@ static int getNumAncestors(GNode* root, GNodeIndex* index) {
 	// Find number of ancestors.
 	int ancestors = 0;
 	for (GNode* pnode = root->child; pnode; pnode = pnode->sibling) {
-		if (eqstr("FAMC", pnode->tag)) { // Families this person is a child in.
+		if (pnode->tagId == tagFAMC) { // Families this person is a child in.
 			GNodeIndexEl* felement = searchHashTable(index, pnode->value);
 			GNode* family = felement->root;
 			for (GNode* fnode = family->child; fnode; fnode = fnode->sibling) {
-				if (eqstr("HUSB", fnode->tag) || eqstr("WIFE", fnode->tag)) {
+				if (fnode->tagId == tagHUSB || fnode->tagId == tagWIFE) {
 					GNodeIndexEl* pelement = searchHashTable(index, fnode->value);
 					ancestors += 1 + getNumAncestors(pelement->root, index);
 				}
@@ -59,11 +59,11 @@ static int getNumDescendents(GNode* root, GNodeIndex* index) {
 	// Find number of descendents.
 	int descendents = 0;
 	for (GNode* pnode = root->child; pnode; pnode = pnode->sibling) {
-		if (eqstr("FAMS", pnode->tag)) { // Families this person is a spouse/parent in.
+		if (pnode->tagId == tagFAMS) { // Families this person is a spouse/parent in.
 			GNodeIndexEl* felement = searchHashTable(index, pnode->value);
 			GNode* family = felement->root;
 			for (GNode* fnode = family->child; fnode; fnode = fnode->sibling) {
-				if (eqstr("CHIL", fnode->tag)) { // Children in this family are descendents.
+				if (fnode->tagId == tagCHIL) { // Children in this family are descendents.
 					GNodeIndexEl* pelement = searchHashTable(index, fnode->value);
 					descendents += 1 + getNumDescendents(pelement->root, index);
 				}
@@ -5,7 +5,7 @@
 //  RootLists of persons in closed sets based on FAMS, FAMC, HUSB, WIFE & CHIL relationships.
 //
 //  Created by Thomas Wetmore on 11 December 2024.
-//  Last changed on 5 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include <stdio.h>
@@ -52,8 +52,7 @@ static List* createPartition(GNode* person, GNodeIndex* index, StringSet* visite
 		// If curr is a person add its FAMS and FAMC families to the queue.
 		if (recordType(curr) == GRPerson) {
 			for (GNode* child = curr->child; child; child = child->sibling) {
-				String tag = child->tag;
-				if (eqstr(tag, "FAMS") || eqstr(tag, "FAMC")) {
+				if (child->tagId == tagFAMS || child->tagId == tagFAMC) {
 					String value = child->value;
 					GNode* node = searchGNodeIndex(index, value);
 					if (!node) { // Can't happen in a validated index.
@@ -66,8 +65,8 @@ static List* createPartition(GNode* person, GNodeIndex* index, StringSet* visite
 		// If curr is a family add its HUSB, WIFE, and CHIL persons to the queue.
 		} else if (recordType(curr) == GRFamily) {
 			for (GNode* child = curr->child; child; child = child->sibling) {
-				String tag = child->tag;
-				if (eqstr(tag, "HUSB") || eqstr(tag, "WIFE") || eqstr(tag, "CHIL")) {
+				TagId tagId = child->tagId;
+				if (tagId == tagHUSB || tagId == tagWIFE || tagId == tagCHIL) {
 					String value = child->value;
 					GNode* node = searchGNodeIndex(index, value);
 					if (!node) { // Can't happen in a validated index.
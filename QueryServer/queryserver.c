@@ -0,0 +1,273 @@
+//
+// DeadEnds QueryServer
+//
+//  queryserver.c is the DeadEnds QueryServer program. It builds Databases from Gedcom files once,
+//  keeps them in memory, and answers requests sent to a Unix domain socket, so reports don't pay
+//  for building a Database on every run.
+//
+//  usage: queryserver -g gedcomfile [-g gedcomfile ...] -u socketpath [-t threads]
+//
+//  A client connects, sends one request line, and reads the reply until the server closes the
+//  connection. The requests are:
+//    databases                  -- the names of the Databases.
+//    script database scriptfile -- run a script on a Database; the reply is the script's output.
+//    key database key           -- the Gedcom text of a record.
+//    name database query        -- the keys and names of the persons who match a name query.
+//  Replies to failed requests end with a line that starts with "error:"; a script's reply also
+//  holds the parser's and interpreter's error messages.
+//
+//  Requests are handled by a pool of worker threads. Lookups and name searches run at the same
+//  time; a script runs alone because the parser and interpreter have global state and scripts can
+//  change a Database.
+//
+//  If DE_GEDCOM_PATH and/or DE_SCRIPTS_PATH are defined, they may be used as search paths.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "deadends.h"
+#include "writenode.h"
+
+#define MAXDATABASES 16
+#define MAXPENDING 64
+
+// Server holds the Databases and the queue of connections waiting for a worker.
+typedef struct Server {
+    int numDatabases;
+    Database* databases[MAXDATABASES];
+    String scriptPath;
+    int pending[MAXPENDING]; // Ring of connection descriptors.
+    int first;
+    int count;
+    pthread_mutex_t mutex;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    pthread_rwlock_t lock; // Scripts hold it for writing, other requests for reading.
+} Server;
+
+// Local functions.
+static void usage(void);
+static void getArguments(int, char**, List*, String*, int*);
+static int openSocket(String);
+static void* runWorker(void*);
+static void handleRequest(Server*, int);
+
+// Main program of the QueryServer program.
+int main(int argc, char* argv[]) {
+    fprintf(stderr, "%s: QueryServer started.\n", getMsecondsStr());
+    List* gedcomFiles = createList(null, null, null, false);
+    String socketPath = null;
+    int numThreads = 4;
+    getArguments(argc, argv, gedcomFiles, &socketPath, &numThreads);
+    String gedcomPath = getenv("DE_GEDCOM_PATH");
+    if (!gedcomPath) gedcomPath = ".";
+    Server server = { 0 };
+    server.scriptPath = getenv("DE_SCRIPTS_PATH");
+    if (!server.scriptPath) server.scriptPath = ".";
+
+    // Build the Databases from the Gedcom files.
+    FORLIST(gedcomFiles, element)
+        String gedcomFile = resolveFile((String) element, gedcomPath, "ged");
+        ErrorLog* errorLog = createErrorLog();
+        Database* database = gedcomFile ? getDatabaseFromFile(gedcomFile, errorLog) : null;
+        if (lengthList(errorLog)) showErrorLog(errorLog); // A Database may come with warnings.
+        if (!database) {
+            fprintf(stderr, "Could not build a database from %s.\n", (String) element);
+            exit(1);
+        }
+        deleteErrorLog(errorLog);
+        server.databases[server.numDatabases++] = database;
+        fprintf(stderr, "%s: Database %s created.\n", getMsecondsStr(), database->name);
+    ENDLIST
+
+    // Start the workers and accept connections.
+    int listener = openSocket(socketPath);
+    if (listener < 0) exit(1);
+    signal(SIGPIPE, SIG_IGN); // A client that leaves early must not stop the server.
+    pthread_mutex_init(&server.mutex, null);
+    pthread_cond_init(&server.notEmpty, null);
+    pthread_cond_init(&server.notFull, null);
+    pthread_rwlock_init(&server.lock, null);
+    pthread_t threads[numThreads];
+    for (int t = 0; t < numThreads; t++) pthread_create(&threads[t], null, runWorker, &server);
+    fprintf(stderr, "%s: QueryServer listening on %s.\n", getMsecondsStr(), socketPath);
+    while (true) {
+        int connection = accept(listener, null, null);
+        if (connection < 0) continue;
+        pthread_mutex_lock(&server.mutex);
+        while (server.count == MAXPENDING) pthread_cond_wait(&server.notFull, &server.mutex);
+        server.pending[(server.first + server.count++) % MAXPENDING] = connection;
+        pthread_cond_signal(&server.notEmpty);
+        pthread_mutex_unlock(&server.mutex);
+    }
+}
+
+// openSocket creates a Unix domain socket at a path and listens on it; returns -1 on error.
+static int openSocket(String path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path %s is too long.\n", path);
+        return -1;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+    if (bind(listener, (struct sockaddr*) &address, sizeof(address)) < 0 ||
+        listen(listener, MAXPENDING) < 0) {
+        perror(path);
+        close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+// runWorker takes connections from the queue and handles their requests.
+static void* runWorker(void* arg) {
+    Server* server = (Server*) arg;
+    while (true) {
+        pthread_mutex_lock(&server->mutex);
+        while (server->count == 0) pthread_cond_wait(&server->notEmpty, &server->mutex);
+        int connection = server->pending[server->first];
+        server->first = (server->first + 1) % MAXPENDING;
+        server->count--;
+        pthread_cond_signal(&server->notFull);
+        pthread_mutex_unlock(&server->mutex);
+        handleRequest(server, connection);
+    }
+    return null;
+}
+
+// readRequest reads a request line from a connection; returns false if there is none.
+static bool readRequest(int connection, String line, int size) {
+    int length = 0;
+    char c;
+    while (length < size - 1 && read(connection, &c, 1) == 1 && c != '\n') line[length++] = c;
+    if (length && line[length-1] == '\r') length--;
+    line[length] = 0;
+    return length > 0;
+}
+
+// findDatabase returns the Database with a name; null if there is none.
+static Database* findDatabase(Server* server, String name) {
+    for (int i = 0; i < server->numDatabases; i++) {
+        if (eqstr(server->databases[i]->name, name)) return server->databases[i];
+    }
+    return null;
+}
+
+// runScript parses a script and runs it on a Database, writing its output to a client. The parser
+// and interpreter write their error messages to stdout, so stdout is pointed at the client while
+// the script runs; no other request runs then, so none of them sees the change.
+static void runScript(Server* server, Database* database, String scriptFile, FILE* fp) {
+    pthread_rwlock_wrlock(&server->lock);
+    fflush(fp);
+    fflush(stdout);
+    int savedStdout = dup(STDOUT_FILENO);
+    dup2(fileno(fp), STDOUT_FILENO);
+    Program* program = parseProgram(scriptFile, server->scriptPath);
+    if (program) {
+        runProgram(program, database, stdOutputFile()); // Closes the File.
+        deleteProgram(program);
+    } else {
+        printf("error: could not parse script %s\n", scriptFile);
+    }
+    fflush(stdout);
+    dup2(savedStdout, STDOUT_FILENO);
+    close(savedStdout);
+    pthread_rwlock_unlock(&server->lock);
+}
+
+// writeNameMatches writes the keys and first names of the persons who match a name query.
+static void writeNameMatches(Database* database, String query, FILE* fp) {
+    List* keys = searchNames(getNameSearchIndex(database), query, nameSearchAll);
+    FORLIST(keys, key)
+        GNode* person = keyToPerson((String) key, database->recordIndex);
+        GNode* name = person ? NAME(person) : null;
+        fprintf(fp, "%s\t%s\n", (String) key, name && name->value ? name->value : "");
+    ENDLIST
+    deleteList(keys);
+}
+
+// handleRequest reads a request from a connection, writes its reply, and closes the connection.
+static void handleRequest(Server* server, int connection) {
+    char line[MAXLINELEN+1];
+    FILE* fp = readRequest(connection, line, sizeof(line)) ? fdopen(connection, "w") : null;
+    if (!fp) {
+        close(connection);
+        return;
+    }
+    String rest;
+    String command = strtok_r(line, " \t", &rest);
+    String databaseName = strtok_r(null, " \t", &rest);
+    String argument = strtok_r(null, "", &rest);
+    while (argument && iswhite(*argument)) argument++;
+    Database* database = databaseName ? findDatabase(server, databaseName) : null;
+    if (eqstr(command, "script") && database && argument && *argument) {
+        runScript(server, database, argument, fp);
+        fclose(fp);
+        return;
+    }
+    pthread_rwlock_rdlock(&server->lock);
+    if (eqstr(command, "databases")) {
+        for (int i = 0; i < server->numDatabases; i++)
+            fprintf(fp, "%s\t%d persons\n", server->databases[i]->name,
+                    numberPersons(server->databases[i]));
+    } else if (!eqstr(command, "script") && !eqstr(command, "key") && !eqstr(command, "name")) {
+        fprintf(fp, "error: unknown request %s\n", command);
+    } else if (!database || !argument || !*argument) {
+        fprintf(fp, "error: %s\n", database ? "missing argument" : "unknown database");
+    } else if (eqstr(command, "key")) {
+        GNode* root = searchRecordIndex(database->recordIndex, argument);
+        if (root) writeGNodeRecord(fp, root, false);
+        else fprintf(fp, "error: no record with key %s\n", argument);
+    } else {
+        writeNameMatches(database, argument, fp);
+    }
+    pthread_rwlock_unlock(&server->lock);
+    fclose(fp);
+}
+
+// getArguments gets the file names, socket path and number of threads from the command line.
+static void getArguments(int argc, char* argv[], List* gedcomFiles, String* socketPath,
+                         int* numThreads) {
+    int ch;
+    while ((ch = getopt(argc, argv, "g:u:t:")) != -1) {
+        switch(ch) {
+        case 'g':
+            if (lengthList(gedcomFiles) < MAXDATABASES) appendToList(gedcomFiles, strsave(optarg));
+            break;
+        case 'u':
+            *socketPath = strsave(optarg);
+            break;
+        case 't':
+            *numThreads = atoi(optarg);
+            if (*numThreads < 1) *numThreads = 1;
+            break;
+        case '?':
+        default:
+            usage();
+            exit(1);
+        }
+    }
+    if (!lengthList(gedcomFiles) || !*socketPath) {
+        usage();
+        exit(1);
+    }
+}
+
+// usage prints the QueryServer usage message.
+static void usage(void) {
+    fprintf(stderr, "usage: queryserver -g gedcomfile [-g gedcomfile ...] -u socketpath [-t threads]\n");
+}
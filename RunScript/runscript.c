@@ -6,12 +6,16 @@
 //   2. Parse a DeadEnds script file into its internal form.
 //   3. Run the script on the Database and write its output to a file.
 //
-//  usage: runscript -g gedcomfile -s scriptfile
+//  usage: runscript -g gedcomfile -s scriptfile [-p] [-f stacksfile] [-c]
+//
+//  -p profiles the script and writes the report to stderr. -f also samples the run time stack
+//  and writes the folded stacks, for flame graphs, to stacksfile. -c compiles the script to
+//  bytecode and runs it on the virtual machine; a profiled script is still run on its PNodes.
 //
 //  If DE_GEDCOM_PATH and/or DE_SCRIPTS_PATH are defined, they may be used as search paths.
 //
 //  Created by Thomas Wetmore on 21 July 2024
-//  Last changed on 13 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "deadends.h"
@@ -36,10 +40,8 @@ int main(int argc, char* argv[]) {
     gedcomFile = resolveFile(gedcomFile, gedcomPath, "ged");
     ErrorLog* errorLog = createErrorLog();
     Database* database = getDatabaseFromFile(gedcomFile, errorLog);
-    if (lengthList(errorLog)) {
-        showErrorLog(errorLog);
-        exit(1);
-    }
+    if (lengthList(errorLog)) showErrorLog(errorLog); // A Database may come with warnings.
+    if (!database) exit(1);
     fprintf(stderr, "%s: Database created.\n", getMsecondsStr());
 
     // Parse the program script.
@@ -58,7 +60,7 @@ int main(int argc, char* argv[]) {
 // getArguments gets the file names from the command line.
 void getArguments(int argc, char* argv[], String* gedcom, String* script) {
     int ch;
-    while ((ch = getopt(argc, argv, "g:s:")) != -1) {
+    while ((ch = getopt(argc, argv, "g:s:pf:c")) != -1) {
         switch(ch) {
         case 'g':
             *gedcom = strsave(optarg);
@@ -66,6 +68,16 @@ void getArguments(int argc, char* argv[], String* gedcom, String* script) {
         case 's':
             *script = strsave(optarg);
             break;
+        case 'p':
+            profileScripts = true;
+            break;
+        case 'f':
+            profileScripts = true;
+            profileStacksFile = strsave(optarg);
+            break;
+        case 'c':
+            compiling = true;
+            break;
         case '?':
         default:
             usage();
@@ -88,5 +100,5 @@ static void getEnvironment(String* gedcom, String* script) {
 
 // usage prints the RunScript usage message.
 static void usage(void) {
-    fprintf(stderr, "usage: runscript -g gedcomfile -s scriptfile\n");
+    fprintf(stderr, "usage: runscript -g gedcomfile -s scriptfile [-p] [-f stacksfile] [-c]\n");
 }
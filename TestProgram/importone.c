@@ -3,7 +3,7 @@
 //  importone.c has the test function that tries to create a Database for the rest of the tests.
 //
 //  Created by Thomas Wetmore on 21 June 2024.
-//  Last changed on 5 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "deadends.h"
@@ -15,9 +15,10 @@
 	String lastSegment = lastPathSegment(gedcomFile);
 	printf("lastPathSegment: %s\n", lastSegment);
 	Database* database = getDatabaseFromFile(gedcomFile, log);
-	if (lengthList(log)) {
+	if (!database) {
 		printf("Import cancelled because of errors:\n");
 		showErrorLog(log);
+		return null;
 	}
 	summarizeDatabase(database);
 	printf("%d: END OF CREATE DATABASE TEST: %s\n", testNumber, getMsecondsStr());
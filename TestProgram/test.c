@@ -4,7 +4,7 @@
 //  test.c holds test functions used during development.
 //
 //  Created by Thomas Wetmore on 5 October 2023.
-//  Last changed on 5 June 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "deadends.h"
@@ -31,6 +31,8 @@ extern bool validateDatabase(Database*, ErrorLog*);
 extern void testGedcomStrings(int);
 extern void testWriteDatabase(String file, Database*);
 extern void testGedPaths(Database*, int);
+extern void testRelationship(int);
+extern void testTextIndex(int);
 
 extern Database* importDatabaseTest(ErrorLog*, int);
 
@@ -43,6 +45,8 @@ int main(void) {
 	//RecordIndex* index = getRecordIndexFromFile(file, null, null, null, errorLog);
 	Database* database = importDatabaseTest(errorLog, ++testNumber);
 	//testGedcomStrings(++testNumber);
+	testRelationship(++testNumber);
+	testTextIndex(++testNumber);
 	bool validated = database ? true : false;
 	showErrorLog(errorLog);
 
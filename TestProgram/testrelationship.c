@@ -0,0 +1,55 @@
+//
+//  DeadEnds TestProgram
+//
+//  testrelationship.c has code to test the relationship calculator.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "deadends.h"
+
+static void checkRelation(String, String, String, RecordIndex*);
+
+// testRelationship tests relatePersons and relationshipToString on a small Gedcom file of
+// full, half and step relatives.
+void testRelationship(int testNumber) {
+	printf("%d: TEST RELATIONSHIP: %2.3f\n", testNumber, getMseconds());
+	ErrorLog* log = createErrorLog();
+	Database* database = getDatabaseFromFile("../Gedfiles/relations.ged", log);
+	if (!database) {
+		printf("Could not read relations.ged:\n");
+		showErrorLog(log);
+		return;
+	}
+	RecordIndex* index = database->recordIndex;
+
+	// Siblings with both parents recorded.
+	checkRelation("@I3@", "@I4@", "brother", index);
+	checkRelation("@I4@", "@I3@", "sister", index);
+	// Siblings with only their father recorded are not half siblings.
+	checkRelation("@I5@", "@I6@", "brother", index);
+	checkRelation("@I5@", "@I3@", "brother", index);
+	// Siblings with different recorded mothers are half siblings.
+	checkRelation("@I8@", "@I3@", "half brother", index);
+	checkRelation("@I4@", "@I8@", "half sister", index);
+	// Lineal and collateral relatives.
+	checkRelation("@I1@", "@I3@", "father", index);
+	checkRelation("@I9@", "@I10@", "first cousin", index);
+	checkRelation("@I11@", "@I10@", "first cousin once removed", index);
+	// A spouse of a parent who is not a parent.
+	checkRelation("@I12@", "@I3@", "stepfather", index);
+	checkRelation("@I1@", "@I1@", "self", index);
+	deleteDatabase(database);
+	printf("%d: END OF TEST RELATIONSHIP: %2.3f\n", testNumber, getMseconds());
+}
+
+// checkRelation relates two persons and checks the words that describe the relationship.
+static void checkRelation(String one, String two, String should, RecordIndex* index) {
+	Relationship* relation = relatePersons(keyToPerson(one, index), keyToPerson(two, index), index);
+	String was = relationshipToString(relation, keyToPerson(one, index));
+	if (eqstr(should, was)) printf("PASSED: %s is %s of %s\n", one, was, two);
+	else printf("FAILED: %s should be %s of %s but was %s\n", one, should, two, was);
+	stdfree(was);
+	deleteRelationship(relation);
+}
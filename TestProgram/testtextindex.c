@@ -0,0 +1,72 @@
+//
+//  DeadEnds TestProgram
+//
+//  testtextindex.c has code to test the query grammar of the TextIndex.
+//
+//  Created by Thomas Wetmore on 19 October 2026.
+//  Last changed on 19 October 2026.
+//
+
+#include "deadends.h"
+
+static void checkQuery(TextIndex*, String query, String should);
+
+// testTextIndex tests searchText with words, phrases, OR groups and clauses without words on a
+// small Gedcom file of notes.
+void testTextIndex(int testNumber) {
+	printf("%d: TEST TEXT INDEX: %2.3f\n", testNumber, getMseconds());
+	ErrorLog* log = createErrorLog();
+	Database* database = getDatabaseFromFile("../Gedfiles/notes.ged", log);
+	if (!database) {
+		printf("Could not read notes.ged:\n");
+		showErrorLog(log);
+		return;
+	}
+	TextIndex* index = getTextIndex(database);
+
+	// Words; all words of a group must match.
+	checkQuery(index, "county", "@I1@ @I2@ @I3@");
+	checkQuery(index, "COUNTY clerk", "@I1@ @I3@");
+	checkQuery(index, "salem", "@F1@");
+	checkQuery(index, "clerk", "@I1@ @I3@");
+	checkQuery(index, "coroner", "");
+	// Quoted phrases; CONT lines are joined.
+	checkQuery(index, "\"county clerk\"", "@I1@");
+	checkQuery(index, "\"the county court\"", "@I3@");
+	checkQuery(index, "o'brien", "@S1@");
+	// OR separates groups.
+	checkQuery(index, "sheriff OR deed", "@I1@ @I2@");
+	checkQuery(index, "\"county clerk\" OR court OR salem", "@I1@ @I3@ @F1@");
+	// Clauses without words are skipped.
+	checkQuery(index, "county --", "@I1@ @I2@ @I3@");
+	checkQuery(index, "-- OR sheriff", "@I2@");
+	checkQuery(index, "\"...\"", "");
+	// Phrases may have at most MAXPHRASEWORDS words.
+	char phrase[4*MAXPHRASEWORDS + 8];
+	strcpy(phrase, "\"");
+	for (int i = 0; i < MAXPHRASEWORDS; i++) strcat(phrase, "the ");
+	strcat(phrase, "\"");
+	checkQuery(index, phrase, "");
+	strcpy(phrase + strlen(phrase) - 1, "the\"");
+	checkQuery(index, phrase, "null");
+	deleteDatabase(database);
+	printf("%d: END OF TEST TEXT INDEX: %2.3f\n", testNumber, getMseconds());
+}
+
+// checkQuery searches a TextIndex and checks the keys of the records found; should is "null" if
+// the query is in error.
+static void checkQuery(TextIndex* index, String query, String should) {
+	char was[MAXSTRINGSIZE];
+	List* keys = searchText(index, query);
+	if (!keys) strcpy(was, "null");
+	else {
+		was[0] = 0;
+		FORLIST(keys, key)
+			if (was[0]) strcat(was, " ");
+			strcat(was, (String) key);
+		ENDLIST
+		deleteList(keys);
+	}
+	if (eqstr(should, was)) printf("PASSED: %s\n", query);
+	else printf("FAILED: %s should find [%s] but found [%s]\n", query, should, was);
+}
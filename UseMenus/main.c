@@ -4,7 +4,7 @@
 //  main.c is the main program of the UseMenus test program.
 //
 //  Created by Thomas Wetmore on 31 July 2024.
-//  Last changed on 2 September 2025.
+//  Last changed on 19 October 2026.
 //
 
 #include "ask.h"
@@ -52,10 +52,8 @@ int main(int argc, char** argv) {
 	ErrorLog* errorLog = createErrorLog();
 	int vcodes = VCclosedKeys | VClineageLinking | VCnamesAndSex;
 	Database* database = getDatabaseFromFile(gedcomFile, errorLog);
-	if (lengthList(errorLog)) {
-		showErrorLog(errorLog);
-		exit(1);
-	}
+	if (lengthList(errorLog)) showErrorLog(errorLog); // A Database may come with warnings.
+	if (!database) exit(1);
 	if (debugging) summarizeDatabase(database);
 	if (timing) fprintf(stderr, "%s: Database created.\n", gms);
 	//Menu* loadMenu = createLoadDatabaseMenu();